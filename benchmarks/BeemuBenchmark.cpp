@@ -0,0 +1,37 @@
+#include "BeemuBenchmark.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+std::vector<BeemuBenchmarks::Benchmark> &BeemuBenchmarks::registry()
+{
+	static std::vector<Benchmark> benchmarks;
+	return benchmarks;
+}
+
+/**
+ * Run every registered benchmark whose name contains the (optional) first argument,
+ * the optional second argument overrides the iteration count.
+ */
+int main(int argc, char **argv)
+{
+	const char *filter = argc > 1 ? argv[1] : "";
+	const uint64_t iterations = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+	for (const auto &benchmark : BeemuBenchmarks::registry()) {
+		if (std::strstr(benchmark.name.c_str(), filter) == nullptr) {
+			continue;
+		}
+		// Warm up caches and the branch predictor first.
+		benchmark.body(iterations / 10 + 1);
+		const auto start = std::chrono::steady_clock::now();
+		const uint64_t units = benchmark.body(iterations);
+		const auto stop = std::chrono::steady_clock::now();
+		const double seconds = std::chrono::duration<double>(stop - start).count();
+		std::printf("%-48s %14.0f %s/sec (%.3f s)\n",
+			benchmark.name.c_str(),
+			units / seconds,
+			benchmark.unit.c_str(),
+			seconds);
+	}
+	return 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file BeemuBenchmark.hpp
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Minimal micro-benchmark harness, benchmarks register themselves
+ * and are run by the benchmarks executable.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_BEEMU_BENCHMARK_HPP
+#define BEEMU_BEEMU_BENCHMARK_HPP
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace BeemuBenchmarks {
+	/**
+	 * A single registered benchmark, body is called with an iteration count and
+	 * must return the number of units (commands, instructions, pixels...) processed.
+	 */
+	struct Benchmark {
+		std::string name;
+		std::string unit;
+		std::function<uint64_t(uint64_t)> body;
+	};
+
+	std::vector<Benchmark> &registry();
+
+	struct BenchmarkRegistrar {
+		BenchmarkRegistrar(const std::string &name, const std::string &unit, std::function<uint64_t(uint64_t)> body)
+		{
+			registry().push_back({name, unit, std::move(body)});
+		}
+	};
+
+	/**
+	 * Prevent the compiler from optimising away a value computed by a benchmark.
+	 */
+	inline void do_not_optimise(const uint64_t value)
+	{
+		// Writing to a volatile is portable across gcc, clang and msvc.
+		[[maybe_unused]] static volatile uint64_t sink;
+		sink = value;
+	}
+}
+
+#define BEEMU_BENCHMARK_CONCAT_(a, b) a##b
+#define BEEMU_BENCHMARK_CONCAT(a, b) BEEMU_BENCHMARK_CONCAT_(a, b)
+
+/**
+ * Register a benchmark, the body receives `iterations` and must return the processed unit count.
+ */
+#define BEEMU_BENCHMARK(NAME, UNIT)                                                                              \
+	static uint64_t BEEMU_BENCHMARK_CONCAT(beemu_benchmark_, NAME)(uint64_t iterations);                         \
+	static BeemuBenchmarks::BenchmarkRegistrar BEEMU_BENCHMARK_CONCAT(beemu_benchmark_registrar_, NAME){         \
+		#NAME, UNIT, BEEMU_BENCHMARK_CONCAT(beemu_benchmark_, NAME)};                                            \
+	static uint64_t BEEMU_BENCHMARK_CONCAT(beemu_benchmark_, NAME)(uint64_t iterations)
+
+#endif // BEEMU_BEEMU_BENCHMARK_HPP
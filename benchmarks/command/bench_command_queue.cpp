@@ -0,0 +1,101 @@
+#include "../../src/beemu/device/processor/interpreter/command.h"
+#include <BeemuBenchmark.hpp>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+	/**
+	 * The linked list queue the ring buffer replaced, kept here so the two
+	 * can be compared on the same machine.
+	 */
+	struct LinkedQueueNode {
+		BeemuMachineCommand *current;
+		LinkedQueueNode *next;
+	};
+
+	struct LinkedQueue {
+		LinkedQueueNode *first = nullptr;
+		LinkedQueueNode *last = nullptr;
+	};
+
+	void linked_enqueue(LinkedQueue *queue, const BeemuMachineCommand *command)
+	{
+		auto *command_cpy = static_cast<BeemuMachineCommand *>(std::malloc(sizeof(BeemuMachineCommand)));
+		auto *node = static_cast<LinkedQueueNode *>(std::malloc(sizeof(LinkedQueueNode)));
+		node->next = nullptr;
+		node->current = command_cpy;
+		std::memcpy(command_cpy, command, sizeof(BeemuMachineCommand));
+		if (queue->first == nullptr) {
+			queue->first = node;
+			queue->last = node;
+		} else {
+			queue->last->next = node;
+			queue->last = node;
+		}
+	}
+
+	BeemuMachineCommand *linked_dequeue(LinkedQueue *queue)
+	{
+		if (queue->first == nullptr) {
+			return nullptr;
+		}
+		LinkedQueueNode *first_node = queue->first;
+		BeemuMachineCommand *first_command = first_node->current;
+		queue->first = first_node->next;
+		std::free(first_node);
+		if (queue->first == nullptr) {
+			queue->last = nullptr;
+		}
+		return first_command;
+	}
+
+	// Roughly the shape of a LD r8, d8: M1 fetch, operand fetch.
+	constexpr int COMMANDS_PER_INSTRUCTION = 7;
+
+	BeemuMachineCommand sample_command(const int i)
+	{
+		BeemuMachineCommand command;
+		command.type = BEEMU_COMMAND_WRITE;
+		command.write.target.type = BEEMU_WRITE_TARGET_REGISTER_8;
+		command.write.target.target.register_8 = BEEMU_REGISTER_A;
+		command.write.value.is_16 = false;
+		command.write.value.value.byte_value = static_cast<uint8_t>(i);
+		return command;
+	}
+}
+
+BEEMU_BENCHMARK(command_queue_ring_buffer, "commands")
+{
+	BeemuCommandQueue *queue = beemu_command_queue_new();
+	uint64_t checksum = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		for (int j = 0; j < COMMANDS_PER_INSTRUCTION; j++) {
+			const BeemuMachineCommand command = sample_command(j);
+			beemu_command_queue_enqueue(queue, &command);
+		}
+		while (!beemu_command_queue_is_empty(queue)) {
+			checksum += beemu_command_queue_dequeue(queue)->write.value.value.byte_value;
+		}
+	}
+	BeemuBenchmarks::do_not_optimise(checksum);
+	beemu_command_queue_free(queue);
+	return iterations * COMMANDS_PER_INSTRUCTION;
+}
+
+BEEMU_BENCHMARK(command_queue_linked_list_reference, "commands")
+{
+	LinkedQueue queue;
+	uint64_t checksum = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		for (int j = 0; j < COMMANDS_PER_INSTRUCTION; j++) {
+			const BeemuMachineCommand command = sample_command(j);
+			linked_enqueue(&queue, &command);
+		}
+		while (BeemuMachineCommand *command = linked_dequeue(&queue)) {
+			checksum += command->write.value.value.byte_value;
+			std::free(command);
+		}
+	}
+	BeemuBenchmarks::do_not_optimise(checksum);
+	return iterations * COMMANDS_PER_INSTRUCTION;
+}
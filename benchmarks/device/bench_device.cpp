@@ -0,0 +1,130 @@
+#include <BeemuBenchmark.hpp>
+#include <beemu/device/device.h>
+#include <vector>
+
+namespace {
+	/**
+	 * Create a device looping over a short ALU program in the instruction mode.
+	 */
+	BeemuDevice *new_looping_device()
+	{
+		BeemuDevice *device = beemu_device_new();
+		// ADD A, B; INC C; XOR A, C; JP 0x0100
+		const uint8_t program[] = {0x80, 0x0C, 0xA9, 0xC3, 0x00, 0x01};
+		for (uint16_t i = 0; i < sizeof(program); i++) {
+			beemu_memory_write(device->processor->memory, 0x100 + i, program[i]);
+		}
+		device->processor->registers->program_counter = 0x100;
+		beemu_processor_set_execution_mode(device->processor, BEEMU_EXECUTION_MODE_INSTRUCTION);
+		return device;
+	}
+}
+
+BEEMU_BENCHMARK(device_run_per_instruction, "cycles")
+{
+	BeemuDevice *device = new_looping_device();
+	uint64_t cycles = 0;
+	while (cycles < iterations) {
+		cycles += beemu_device_run(device);
+	}
+	beemu_device_free(device);
+	return cycles;
+}
+
+BEEMU_BENCHMARK(device_run_cycles, "cycles")
+{
+	BeemuDevice *device = new_looping_device();
+	const uint64_t cycles = beemu_device_run_cycles(device, iterations);
+	beemu_device_free(device);
+	return cycles;
+}
+
+namespace {
+	/**
+	 * Create a device that does a little work every frame and then halts
+	 * until VBlank, like most games do.
+	 */
+	BeemuDevice *new_vblank_waiting_device()
+	{
+		BeemuDevice *device = beemu_device_new();
+		std::vector<uint8_t> program;
+		for (int i = 0; i < 100; i++) {
+			// ADD A, B; INC C; XOR A, C
+			program.insert(program.end(), {0x80, 0x0C, 0xA9});
+		}
+		// XOR A, A; LDH (0x0F), A; HALT; JP 0x0100
+		program.insert(program.end(), {0xAF, 0xE0, 0x0F, 0x76, 0xC3, 0x00, 0x01});
+		for (uint16_t i = 0; i < program.size(); i++) {
+			beemu_memory_write(device->processor->memory, 0x100 + i, program[i]);
+		}
+		beemu_memory_write(device->processor->memory, BEEMU_PROCESSOR_INTERRUPT_ENABLE_ADDRESS, 1 << BEEMU_INTERRUPT_VBLANK);
+		device->processor->registers->program_counter = 0x100;
+		beemu_processor_set_execution_mode(device->processor, BEEMU_EXECUTION_MODE_INSTRUCTION);
+		// LCD and background on, the display requests VBlank.
+		beemu_memory_write(device->processor->memory, BEEMU_DISPLAY_LCDC_ADDRESS, 0x91);
+		return device;
+	}
+}
+
+BEEMU_BENCHMARK(device_halted_per_instruction, "cycles")
+{
+	BeemuDevice *device = new_vblank_waiting_device();
+	uint64_t cycles = 0;
+	while (cycles < iterations) {
+		cycles += beemu_device_run(device);
+	}
+	beemu_device_free(device);
+	return cycles;
+}
+
+BEEMU_BENCHMARK(device_halted_run_cycles, "cycles")
+{
+	BeemuDevice *device = new_vblank_waiting_device();
+	const uint64_t cycles = beemu_device_run_cycles(device, iterations);
+	beemu_device_free(device);
+	return cycles;
+}
+
+namespace {
+	/**
+	 * Create a device that does a little work every frame and then polls LY
+	 * until VBlank starts and ends, like games that do not use HALT.
+	 */
+	BeemuDevice *new_ly_polling_device(const bool skip_idle_loops)
+	{
+		BeemuDevice *device = beemu_device_new();
+		std::vector<uint8_t> program;
+		for (int i = 0; i < 100; i++) {
+			// ADD A, B; INC C; XOR A, C
+			program.insert(program.end(), {0x80, 0x0C, 0xA9});
+		}
+		// LDH A, (0x44); CP 0x90; JR NZ, -6
+		program.insert(program.end(), {0xF0, 0x44, 0xFE, 0x90, 0x20, 0xFA});
+		// LDH A, (0x44); CP 0x90; JR Z, -6; JP 0x0100
+		program.insert(program.end(), {0xF0, 0x44, 0xFE, 0x90, 0x28, 0xFA, 0xC3, 0x00, 0x01});
+		for (uint16_t i = 0; i < program.size(); i++) {
+			beemu_memory_write(device->processor->memory, 0x100 + i, program[i]);
+		}
+		device->processor->registers->program_counter = 0x100;
+		beemu_processor_set_execution_mode(device->processor, BEEMU_EXECUTION_MODE_INSTRUCTION);
+		beemu_memory_write(device->processor->memory, BEEMU_DISPLAY_LCDC_ADDRESS, 0x91);
+		beemu_device_set_idle_loop_skipping(device, skip_idle_loops);
+		return device;
+	}
+}
+
+BEEMU_BENCHMARK(device_polling_run_cycles, "cycles")
+{
+	BeemuDevice *device = new_ly_polling_device(false);
+	const uint64_t cycles = beemu_device_run_cycles(device, iterations);
+	beemu_device_free(device);
+	return cycles;
+}
+
+BEEMU_BENCHMARK(device_polling_skipping_idle_loops, "cycles")
+{
+	BeemuDevice *device = new_ly_polling_device(true);
+	const uint64_t cycles = beemu_device_run_cycles(device, iterations);
+	beemu_device_free(device);
+	return cycles;
+}
@@ -0,0 +1,79 @@
+#include <BeemuBenchmark.hpp>
+#include <beemu/device/device.h>
+#include <beemu/device/display.h>
+#include <random>
+
+namespace {
+	/**
+	 * Fill VRAM and OAM with random tiles, and turn everything on, the
+	 * window covering the bottom right quarter of the screen.
+	 */
+	void fill_busy_scene(BeemuMemory *memory)
+	{
+		std::mt19937 random_engine{0xD15};
+		std::uniform_int_distribution<int> byte(0, 0xFF);
+		for (int address = 0x8000; address < 0xA000; address++) {
+			beemu_memory_write(memory, address, byte(random_engine));
+		}
+		for (int sprite = 0; sprite < BEEMU_DISPLAY_SPRITE_COUNT; sprite++) {
+			const uint16_t address = BEEMU_DISPLAY_OAM_ADDRESS + sprite * 4;
+			beemu_memory_write(memory, address, 16 + byte(random_engine) % BEEMU_DISPLAY_HEIGHT);
+			beemu_memory_write(memory, address + 1, 8 + byte(random_engine) % BEEMU_DISPLAY_WIDTH);
+			beemu_memory_write(memory, address + 2, byte(random_engine));
+			beemu_memory_write(memory, address + 3, byte(random_engine) & 0xF0);
+		}
+		beemu_memory_write(memory, BEEMU_DISPLAY_LCDC_ADDRESS, 0xE3);
+		beemu_memory_write(memory, BEEMU_DISPLAY_SCX_ADDRESS, 3);
+		beemu_memory_write(memory, BEEMU_DISPLAY_SCY_ADDRESS, 5);
+		beemu_memory_write(memory, BEEMU_DISPLAY_WX_ADDRESS, 7 + BEEMU_DISPLAY_WIDTH / 2);
+		beemu_memory_write(memory, BEEMU_DISPLAY_WY_ADDRESS, BEEMU_DISPLAY_HEIGHT / 2);
+		beemu_memory_write(memory, BEEMU_DISPLAY_BGP_ADDRESS, 0xE4);
+		beemu_memory_write(memory, BEEMU_DISPLAY_OBP0_ADDRESS, 0xE4);
+		beemu_memory_write(memory, BEEMU_DISPLAY_OBP1_ADDRESS, 0x1B);
+	}
+
+	/**
+	 * Run halted frames of the busy scene, so that only the display runs.
+	 */
+	uint64_t run_halted_frames(const BeemuDisplayRenderer renderer, const uint64_t iterations)
+	{
+		BeemuDevice *device = beemu_device_new_with_renderer(renderer);
+		fill_busy_scene(device->processor->memory);
+		// HALT with every interrupt disabled.
+		beemu_memory_write(device->processor->memory, 0x100, 0x76);
+		beemu_memory_write(device->processor->memory, BEEMU_PROCESSOR_INTERRUPT_ENABLE_ADDRESS, 0);
+		device->processor->registers->program_counter = 0x100;
+		for (uint64_t frame = 0; frame < iterations; frame++) {
+			beemu_device_run_until_frame(device);
+		}
+		beemu_device_free(device);
+		return iterations;
+	}
+}
+
+BEEMU_BENCHMARK(display_render_frame, "frames")
+{
+	BeemuMemory *memory = beemu_memory_new(BEEMU_DEVICE_MEMORY_SIZE);
+	BeemuDisplay *display = beemu_display_new(memory);
+	fill_busy_scene(memory);
+	for (uint64_t frame = 0; frame < iterations; frame++) {
+		display->window_line = 0;
+		for (uint8_t line = 0; line < BEEMU_DISPLAY_HEIGHT; line++) {
+			beemu_display_render_line(display, line);
+		}
+	}
+	BeemuBenchmarks::do_not_optimise(display->framebuffer[BEEMU_DISPLAY_HEIGHT - 1][BEEMU_DISPLAY_WIDTH - 1]);
+	beemu_display_free(display);
+	beemu_memory_free(memory);
+	return iterations;
+}
+
+BEEMU_BENCHMARK(device_halted_frame_with_display, "frames")
+{
+	return run_halted_frames(BEEMU_DISPLAY_RENDERER_SCANLINE, iterations);
+}
+
+BEEMU_BENCHMARK(device_halted_frame_with_pixel_fifo, "frames")
+{
+	return run_halted_frames(BEEMU_DISPLAY_RENDERER_PIXEL_FIFO, iterations);
+}
@@ -0,0 +1,83 @@
+#include <BeemuBenchmark.hpp>
+#include <beemu/device/display.h>
+#include <beemu/device/pixel_kernels.h>
+#include <random>
+
+namespace {
+	constexpr size_t FRAME_PIXELS = BEEMU_DISPLAY_WIDTH * BEEMU_DISPLAY_HEIGHT;
+
+	std::vector<uint8_t> random_bytes(const size_t count, const int mask)
+	{
+		std::mt19937 random_engine{0x2B99};
+		std::uniform_int_distribution<int> byte(0, 0xFF);
+		std::vector<uint8_t> bytes(count);
+		for (uint8_t &value : bytes) {
+			value = byte(random_engine) & mask;
+		}
+		return bytes;
+	}
+
+	/**
+	 * Decode a frame worth of tile rows at a time.
+	 */
+	uint64_t decode_rows(const BeemuPixelKernels *kernels, const uint64_t pixels)
+	{
+		const std::vector<uint8_t> rows = random_bytes(FRAME_PIXELS / 4, 0xFF);
+		std::vector<uint8_t> indices(FRAME_PIXELS);
+		uint64_t decoded = 0;
+		for (; decoded < pixels; decoded += FRAME_PIXELS) {
+			kernels->decode_rows(rows.data(), FRAME_PIXELS / 8, indices.data());
+		}
+		BeemuBenchmarks::do_not_optimise(indices.back());
+		return decoded;
+	}
+
+	/**
+	 * Export a frame worth of shades at a time, as RGBA8888.
+	 */
+	uint64_t expand_32(const BeemuPixelKernels *kernels, const uint64_t pixels)
+	{
+		const std::vector<uint8_t> indices = random_bytes(FRAME_PIXELS, 3);
+		const uint32_t colours[4] = {0xFFFFFFFF, 0xAAAAAAFF, 0x555555FF, 0x000000FF};
+		std::vector<uint32_t> output(FRAME_PIXELS);
+		uint64_t expanded = 0;
+		for (; expanded < pixels; expanded += FRAME_PIXELS) {
+			kernels->expand_32(indices.data(), FRAME_PIXELS, 0xE4, colours, output.data());
+		}
+		BeemuBenchmarks::do_not_optimise(output.back());
+		return expanded;
+	}
+
+	/**
+	 * Export a frame worth of shades at a time, as RGB565.
+	 */
+	uint64_t expand_16(const BeemuPixelKernels *kernels, const uint64_t pixels)
+	{
+		const std::vector<uint8_t> indices = random_bytes(FRAME_PIXELS, 3);
+		const uint16_t colours[4] = {0xFFFF, 0xAD55, 0x52AA, 0x0000};
+		std::vector<uint16_t> output(FRAME_PIXELS);
+		uint64_t expanded = 0;
+		for (; expanded < pixels; expanded += FRAME_PIXELS) {
+			kernels->expand_16(indices.data(), FRAME_PIXELS, 0xE4, colours, output.data());
+		}
+		BeemuBenchmarks::do_not_optimise(output.back());
+		return expanded;
+	}
+
+	/**
+	 * Register each kernel for every instruction set the processor supports.
+	 */
+	const bool registered = [] {
+		for (int level = 0; level < BEEMU_PIXEL_KERNEL_LEVEL_COUNT; level++) {
+			const BeemuPixelKernels *kernels = beemu_pixel_kernels_for(static_cast<BeemuPixelKernelLevel>(level));
+			if (kernels == nullptr) {
+				continue;
+			}
+			const std::string name = kernels->name;
+			BeemuBenchmarks::BenchmarkRegistrar("pixel_decode_rows_" + name, "pixels", [kernels](uint64_t pixels) { return decode_rows(kernels, pixels); });
+			BeemuBenchmarks::BenchmarkRegistrar("pixel_expand_rgba8888_" + name, "pixels", [kernels](uint64_t pixels) { return expand_32(kernels, pixels); });
+			BeemuBenchmarks::BenchmarkRegistrar("pixel_expand_rgb565_" + name, "pixels", [kernels](uint64_t pixels) { return expand_16(kernels, pixels); });
+		}
+		return true;
+	}();
+}
@@ -0,0 +1,43 @@
+#include <BeemuBenchmark.hpp>
+#include <beemu/device/device.h>
+#include <beemu/device/runner.h>
+#include <vector>
+
+namespace {
+	const size_t device_count = 256;
+
+	/**
+	 * Run a fleet of devices looping over a short ALU program on the given
+	 * number of threads, for a total of `iterations` T-cycles.
+	 */
+	uint64_t run_fleet(const uint32_t thread_count, const uint64_t iterations)
+	{
+		std::vector<BeemuRunnerJob> jobs;
+		for (size_t i = 0; i < device_count; i++) {
+			BeemuDevice *device = beemu_device_new();
+			// LD B, i; ADD A, B; INC C; XOR A, C; LD (HL), A; INC HL; JR -7
+			const uint8_t program[] = {0x06, (uint8_t)i, 0x80, 0x0C, 0xA9, 0x77, 0x23, 0x18, 0xF9};
+			for (size_t j = 0; j < sizeof(program); j++) {
+				beemu_memory_write(device->processor->memory, 0x100 + j, program[j]);
+			}
+			beemu_processor_set_execution_mode(device->processor, BEEMU_EXECUTION_MODE_INSTRUCTION);
+			jobs.push_back({device, iterations / device_count, 0, 0});
+		}
+		BeemuRunnerReport report;
+		beemu_runner_run(jobs.data(), jobs.size(), thread_count, &report);
+		for (BeemuRunnerJob &job : jobs) {
+			beemu_device_free(job.device);
+		}
+		return report.total_cycles;
+	}
+}
+
+BEEMU_BENCHMARK(runner_single_thread, "cycles")
+{
+	return run_fleet(1, iterations);
+}
+
+BEEMU_BENCHMARK(runner_all_threads, "cycles")
+{
+	return run_fleet(0, iterations);
+}
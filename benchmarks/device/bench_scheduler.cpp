@@ -0,0 +1,35 @@
+#include <BeemuBenchmark.hpp>
+#include <beemu/device/scheduler.h>
+
+BEEMU_BENCHMARK(scheduler_reschedule, "reschedules")
+{
+	BeemuScheduler scheduler;
+	beemu_scheduler_init(&scheduler);
+	for (int type = 0; type < BEEMU_EVENT_TYPE_COUNT; type++) {
+		beemu_scheduler_schedule(&scheduler, static_cast<BeemuEventType>(type), 1000 * type);
+	}
+	// Keep moving events around, as writes to the timer and LCD registers do.
+	uint64_t deadline = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		deadline += (i * 7919) % 4096;
+		beemu_scheduler_schedule(&scheduler, static_cast<BeemuEventType>(i % BEEMU_EVENT_TYPE_COUNT), deadline);
+	}
+	BeemuBenchmarks::do_not_optimise(beemu_scheduler_next_deadline(&scheduler));
+	return iterations;
+}
+
+BEEMU_BENCHMARK(scheduler_pop_due, "events")
+{
+	BeemuScheduler scheduler;
+	beemu_scheduler_init(&scheduler);
+	uint64_t now = 0;
+	BeemuScheduledEvent event;
+	for (uint64_t i = 0; i < iterations; i++) {
+		beemu_scheduler_schedule(&scheduler, static_cast<BeemuEventType>(i % BEEMU_EVENT_TYPE_COUNT), now + 456);
+		now += 100;
+		while (beemu_scheduler_pop_due(&scheduler, now, &event)) {
+		}
+	}
+	BeemuBenchmarks::do_not_optimise(now);
+	return iterations;
+}
@@ -0,0 +1,27 @@
+#include <BeemuBenchmark.hpp>
+#include <beemu/internals/trace.h>
+
+namespace {
+	void discard_event(void *context, const BeemuTraceEvent *event)
+	{
+		*static_cast<uint64_t *>(context) += event->args[0];
+	}
+}
+
+BEEMU_BENCHMARK(trace_record, "events")
+{
+	const BeemuLogLevel previous = beemu_log_level;
+	beemu_log_set_level(BEEMU_LOG_INFO);
+	uint64_t sum = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		BEEMU_TRACE(BEEMU_LOG_WARN, "Wrote 0x%02X to 0x%04X", i & 0xFF, i & 0xFFFF);
+		// Drain as a consumer thread would, before the ring fills up.
+		if ((i & (BEEMU_TRACE_RING_CAPACITY / 2 - 1)) == 0) {
+			beemu_trace_drain(discard_event, &sum);
+		}
+	}
+	beemu_trace_drain(discard_event, &sum);
+	BeemuBenchmarks::do_not_optimise(sum);
+	beemu_log_set_level(previous);
+	return iterations;
+}
@@ -0,0 +1,100 @@
+#include "../../src/beemu/device/processor/interpreter/invoker.h"
+#include <BeemuBenchmark.hpp>
+#include <beemu/device/processor/processor.h>
+
+namespace {
+	/**
+	 * Fill the queue with a representative mix of writes and cycle terminators.
+	 */
+	uint32_t fill_queue(BeemuCommandQueue *queue)
+	{
+		beemu_command_queue_init(queue);
+		BeemuMachineCommand write;
+		write.type = BEEMU_COMMAND_WRITE;
+		BeemuMachineCommand halt;
+		halt.type = BEEMU_COMMAND_HALT;
+		halt.halt.is_cycle_terminator = true;
+		for (int i = 0; i < BEEMU_COMMAND_QUEUE_CAPACITY / 4; i++) {
+			write.write.target.type = BEEMU_WRITE_TARGET_INTERNAL;
+			write.write.target.target.internal_target = BEEMU_INTERNAL_WRITE_TARGET_PROGRAM_COUNTER;
+			write.write.value.is_16 = true;
+			write.write.value.value.double_value = 0x100 + i;
+			beemu_command_queue_enqueue(queue, &write);
+			write.write.target.type = BEEMU_WRITE_TARGET_REGISTER_8;
+			write.write.target.target.register_8 = BEEMU_REGISTER_A;
+			write.write.value.is_16 = false;
+			write.write.value.value.byte_value = i;
+			beemu_command_queue_enqueue(queue, &write);
+			write.write.target.type = BEEMU_WRITE_TARGET_FLAG;
+			write.write.target.target.flag = BEEMU_FLAG_Z;
+			write.write.value.value.byte_value = i & 1;
+			beemu_command_queue_enqueue(queue, &write);
+			beemu_command_queue_enqueue(queue, &halt);
+		}
+		return beemu_command_queue_size(queue);
+	}
+}
+
+BEEMU_BENCHMARK(invoker_dispatch, "commands")
+{
+	BeemuProcessor *processor = beemu_processor_new();
+	BeemuCommandQueue queue;
+	const uint32_t command_count = fill_queue(&queue);
+	uint64_t cycles = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		// Rewind the ring rather than re-enqueueing, so only dispatch is measured.
+		queue.head = 0;
+		queue.tail = command_count;
+		cycles += beemu_invoker_invoke(processor, &queue, nullptr, nullptr);
+	}
+	BeemuBenchmarks::do_not_optimise(cycles);
+	beemu_processor_free(processor);
+	return iterations * command_count;
+}
+
+namespace {
+	/**
+	 * Run a loop of register loads and ALU ops in the given execution mode.
+	 */
+	uint64_t run_program(BeemuExecutionMode mode, uint64_t iterations, bool lazy_flags = false)
+	{
+		BeemuProcessor *processor = beemu_processor_new();
+		beemu_processor_set_execution_mode(processor, mode);
+		beemu_processor_set_lazy_flags(processor, lazy_flags);
+		// The PC is wrapped back manually.
+		const uint8_t program[] = {0x06, 0x12, 0x48, 0x80, 0xA9, 0x3C, 0x57, 0x0E, 0x34};
+		for (uint16_t i = 0; i < sizeof(program); i++) {
+			beemu_memory_write(processor->memory, 0x100 + i, program[i]);
+		}
+		uint64_t cycles = 0;
+		for (uint64_t i = 0; i < iterations; i++) {
+			if (processor->registers->program_counter >= 0x100 + sizeof(program)) {
+				processor->registers->program_counter = 0x100;
+			}
+			cycles += beemu_processor_run(processor);
+		}
+		BeemuBenchmarks::do_not_optimise(cycles);
+		beemu_processor_free(processor);
+		return iterations;
+	}
+}
+
+BEEMU_BENCHMARK(processor_run_fetch_decode_execute, "instructions")
+{
+	return run_program(BEEMU_EXECUTION_MODE_CYCLE_ACCURATE, iterations);
+}
+
+BEEMU_BENCHMARK(processor_run_instruction_mode, "instructions")
+{
+	return run_program(BEEMU_EXECUTION_MODE_INSTRUCTION, iterations);
+}
+
+BEEMU_BENCHMARK(processor_run_fetch_decode_execute_lazy_flags, "instructions")
+{
+	return run_program(BEEMU_EXECUTION_MODE_CYCLE_ACCURATE, iterations, true);
+}
+
+BEEMU_BENCHMARK(processor_run_instruction_mode_lazy_flags, "instructions")
+{
+	return run_program(BEEMU_EXECUTION_MODE_INSTRUCTION, iterations, true);
+}
@@ -0,0 +1,38 @@
+#include "../../src/beemu/device/processor/interpreter/parser/parser.h"
+#include <BeemuBenchmark.hpp>
+#include <beemu/device/processor/processor.h>
+#include <beemu/device/processor/tokenizer.h>
+
+namespace {
+	// Loads, stores and stack operations, which the skeleton cache covers.
+	const uint32_t MACHINE_CODES[] = {0x060000, 0x480000, 0x7E0000, 0x220000, 0xC50000, 0xE10000, 0x3E0000, 0xEA3412};
+
+	uint64_t parse_with(void (*parse)(const BeemuProcessor *, const BeemuInstruction *, BeemuCommandQueue *), uint64_t iterations)
+	{
+		BeemuProcessor *processor = beemu_processor_new();
+		constexpr size_t code_count = sizeof(MACHINE_CODES) / sizeof(MACHINE_CODES[0]);
+		BeemuInstruction instructions[code_count];
+		for (size_t i = 0; i < code_count; i++) {
+			beemu_tokenizer_tokenize_into(&instructions[i], MACHINE_CODES[i]);
+		}
+		BeemuCommandQueue queue;
+		uint64_t commands = 0;
+		for (uint64_t i = 0; i < iterations; i++) {
+			parse(processor, &instructions[i % code_count], &queue);
+			commands += beemu_command_queue_size(&queue);
+		}
+		BeemuBenchmarks::do_not_optimise(commands);
+		beemu_processor_free(processor);
+		return iterations;
+	}
+}
+
+BEEMU_BENCHMARK(parser_skeleton_cache, "instructions")
+{
+	return parse_with(beemu_parser_parse_into, iterations);
+}
+
+BEEMU_BENCHMARK(parser_uncached, "instructions")
+{
+	return parse_with(beemu_parser_parse_uncached_into, iterations);
+}
@@ -0,0 +1,59 @@
+#include <BeemuBenchmark.hpp>
+#include <beemu/device/memory.h>
+
+namespace {
+	uint8_t io_read(void *, uint16_t address)
+	{
+		return static_cast<uint8_t>(address);
+	}
+}
+
+BEEMU_BENCHMARK(memory_read_mapped_pages, "reads")
+{
+	BeemuMemory *memory = beemu_memory_new(65536);
+	uint64_t sum = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		// Stride through the address space so every page is touched.
+		sum += beemu_memory_read(memory, (i * 257) & 0xFFFF);
+	}
+	BeemuBenchmarks::do_not_optimise(sum);
+	beemu_memory_free(memory);
+	return iterations;
+}
+
+BEEMU_BENCHMARK(memory_read_handler_pages, "reads")
+{
+	BeemuMemory *memory = beemu_memory_new(65536);
+	beemu_memory_map_pages(memory, 0x00, BEEMU_MEMORY_PAGE_COUNT, nullptr, nullptr);
+	beemu_memory_set_page_handlers(memory, 0x00, BEEMU_MEMORY_PAGE_COUNT, {io_read, nullptr, nullptr});
+	uint64_t sum = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		sum += beemu_memory_read(memory, (i * 257) & 0xFFFF);
+	}
+	BeemuBenchmarks::do_not_optimise(sum);
+	beemu_memory_free(memory);
+	return iterations;
+}
+
+BEEMU_BENCHMARK(memory_write_mapped_pages, "writes")
+{
+	BeemuMemory *memory = beemu_memory_new(65536);
+	for (uint64_t i = 0; i < iterations; i++) {
+		beemu_memory_write(memory, (i * 257) & 0xFFFF, i);
+	}
+	BeemuBenchmarks::do_not_optimise(beemu_memory_read(memory, 0x1234));
+	beemu_memory_free(memory);
+	return iterations;
+}
+
+BEEMU_BENCHMARK(memory_read_16, "reads")
+{
+	BeemuMemory *memory = beemu_memory_new(65536);
+	uint64_t sum = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		sum += beemu_memory_read_16(memory, (i * 257) & 0xFFFF);
+	}
+	BeemuBenchmarks::do_not_optimise(sum);
+	beemu_memory_free(memory);
+	return iterations;
+}
@@ -0,0 +1,104 @@
+#include "../../src/beemu/device/processor/alu.h"
+#include <BeemuBenchmark.hpp>
+#include <beemu/device/processor/processor.h>
+#include <beemu/device/processor/registers.h>
+
+namespace {
+	/** Operations both ALU benchmarks run, DAA had no computed path. */
+	const BeemuOperation operations[] = {BEEMU_OP_ADD, BEEMU_OP_ADC, BEEMU_OP_SUB, BEEMU_OP_SBC, BEEMU_OP_CP};
+	constexpr uint64_t operation_count = sizeof(operations) / sizeof(operations[0]);
+
+	/**
+	 * Compute the result and flags the way the parser did before the tables.
+	 */
+	BeemuAluOutput compute_output(const BeemuOperation operation, const uint8_t first, const uint8_t second, const uint8_t flags)
+	{
+		const uint8_t carry = (flags >> BEEMU_FLAG_C) & 1;
+		const int32_t would_be_result = resolve_result_wo_overflow(first, second, operation, carry);
+		const uint8_t result = would_be_result;
+		const bool is_subtraction = operation == BEEMU_OP_SUB || operation == BEEMU_OP_SBC || operation == BEEMU_OP_CP;
+		return result << 8
+			| (result == 0) << BEEMU_FLAG_Z
+			| is_subtraction << BEEMU_FLAG_N
+			| resolve_half_carry_for_arithmatic(first, second, carry, operation) << BEEMU_FLAG_H
+			| (would_be_result != result) << BEEMU_FLAG_C;
+	}
+}
+
+BEEMU_BENCHMARK(alu_computed, "operations")
+{
+	uint64_t sum = 0;
+	uint8_t flags = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		const BeemuAluOutput output = compute_output(operations[i % operation_count], i, i >> 8, flags);
+		flags = output & 0xF0;
+		sum += output;
+	}
+	BeemuBenchmarks::do_not_optimise(sum);
+	return iterations;
+}
+
+BEEMU_BENCHMARK(alu_lookup, "operations")
+{
+	beemu_alu_tables_build();
+	uint64_t sum = 0;
+	uint8_t flags = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		const BeemuAluOutput output = beemu_alu_lookup(operations[i % operation_count], i, i >> 8, flags);
+		flags = output & 0xF0;
+		sum += output;
+	}
+	BeemuBenchmarks::do_not_optimise(sum);
+	return iterations;
+}
+
+BEEMU_BENCHMARK(alu_lookup_daa, "operations")
+{
+	beemu_alu_tables_build();
+	uint64_t sum = 0;
+	uint8_t flags = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		// DAA adjusts A according to N, H and C, cycle through all of them.
+		const BeemuAluOutput output = beemu_alu_lookup(BEEMU_OP_DAA, i, 0, (flags & 0x80) | ((i >> 8) & 0x70));
+		flags = output & 0xF0;
+		sum += output;
+	}
+	BeemuBenchmarks::do_not_optimise(sum);
+	return iterations;
+}
+
+namespace {
+	/**
+	 * Run a loop made of ALU instructions only in the given execution mode.
+	 */
+	uint64_t run_alu_program(const BeemuExecutionMode mode, const uint64_t iterations)
+	{
+		BeemuProcessor *processor = beemu_processor_new();
+		beemu_processor_set_execution_mode(processor, mode);
+		// ADD A, B; ADC A, C; SUB A, D; SBC A, E; DAA; CP A, H; INC L; DEC B; XOR A, C; OR A, D
+		const uint8_t program[] = {0x80, 0x89, 0x92, 0x9B, 0x27, 0xBC, 0x2C, 0x05, 0xA9, 0xB2};
+		for (uint16_t i = 0; i < sizeof(program); i++) {
+			beemu_memory_write(processor->memory, 0x100 + i, program[i]);
+		}
+		uint64_t cycles = 0;
+		for (uint64_t i = 0; i < iterations; i++) {
+			if (processor->registers->program_counter >= 0x100 + sizeof(program)) {
+				processor->registers->program_counter = 0x100;
+			}
+			cycles += beemu_processor_run(processor);
+		}
+		BeemuBenchmarks::do_not_optimise(cycles);
+		beemu_processor_free(processor);
+		return iterations;
+	}
+}
+
+BEEMU_BENCHMARK(processor_run_alu_fetch_decode_execute, "instructions")
+{
+	return run_alu_program(BEEMU_EXECUTION_MODE_CYCLE_ACCURATE, iterations);
+}
+
+BEEMU_BENCHMARK(processor_run_alu_instruction_mode, "instructions")
+{
+	return run_alu_program(BEEMU_EXECUTION_MODE_INSTRUCTION, iterations);
+}
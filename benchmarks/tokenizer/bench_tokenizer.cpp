@@ -0,0 +1,51 @@
+#include "../../src/beemu/device/processor/tokenizer/tokenize_table.h"
+#include <BeemuBenchmark.hpp>
+#include <beemu/device/processor/tokenizer.h>
+
+namespace {
+	/**
+	 * Cycle through every opcode with a changing operand so the
+	 * benchmark does not just hit a single hot path.
+	 */
+	uint32_t machine_code_for(const uint64_t i)
+	{
+		return ((i & 0xFF) << 16) | ((i * 0x9E37) & 0xFFFF);
+	}
+}
+
+BEEMU_BENCHMARK(tokenizer_decode_table, "instructions")
+{
+	beemu_tokenizer_init();
+	uint64_t checksum = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		BeemuInstruction token;
+		beemu_tokenizer_table_decode(&token, machine_code_for(i));
+		checksum += token.duration_in_clock_cycles;
+	}
+	BeemuBenchmarks::do_not_optimise(checksum);
+	return iterations;
+}
+
+BEEMU_BENCHMARK(tokenizer_decode_classifiers, "instructions")
+{
+	uint64_t checksum = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		BeemuInstruction token{};
+		beemu_tokenizer_decode_without_table(&token, machine_code_for(i));
+		checksum += token.duration_in_clock_cycles;
+	}
+	BeemuBenchmarks::do_not_optimise(checksum);
+	return iterations;
+}
+
+BEEMU_BENCHMARK(tokenizer_tokenize_allocating, "instructions")
+{
+	uint64_t checksum = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		BeemuInstruction *token = beemu_tokenizer_tokenize(machine_code_for(i));
+		checksum += token->duration_in_clock_cycles;
+		beemu_tokenizer_free_token(token);
+	}
+	BeemuBenchmarks::do_not_optimise(checksum);
+	return iterations;
+}
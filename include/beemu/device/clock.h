@@ -0,0 +1,96 @@
+/**
+ * @file clock.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Master T-cycle counter, and when each component last caught up to it.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_DEVICE_CLOCK_H
+#define BEEMU_DEVICE_CLOCK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+	/**
+	 * @brief Components that are not ticked along with the processor, but
+	 * catch up with the clock lazily when they are touched.
+	 */
+	typedef enum BeemuClockComponent
+	{
+		BEEMU_CLOCK_COMPONENT_TIMER,
+		BEEMU_CLOCK_COMPONENT_PPU,
+		BEEMU_CLOCK_COMPONENT_DMA,
+		BEEMU_CLOCK_COMPONENT_COUNT
+	} BeemuClockComponent;
+
+	/**
+	 * @brief Absolute time of a device.
+	 *
+	 * A 64 bit T-cycle count does not wrap for over a hundred thousand
+	 * years of emulated time.
+	 */
+	typedef struct BeemuClock
+	{
+		/** T-cycles run since the device was created. */
+		uint64_t now;
+		/** Value of now when each component was last brought up to date. */
+		uint64_t synced_at[BEEMU_CLOCK_COMPONENT_COUNT];
+	} BeemuClock;
+
+	/**
+	 * @brief Reset the clock and every component to cycle 0.
+	 */
+	static inline void beemu_clock_init(BeemuClock *clock)
+	{
+		clock->now = 0;
+		for (int component = 0; component < BEEMU_CLOCK_COMPONENT_COUNT; component++)
+		{
+			clock->synced_at[component] = 0;
+		}
+	}
+
+	/**
+	 * @brief Move the clock forward, components are left behind until synced.
+	 */
+	static inline void beemu_clock_advance(BeemuClock *clock, uint32_t cycles)
+	{
+		clock->now += cycles;
+	}
+
+	/**
+	 * @brief Get how far behind the clock a component is.
+	 *
+	 * @return uint64_t T-cycles the component has to catch up.
+	 */
+	static inline uint64_t beemu_clock_pending(const BeemuClock *clock, BeemuClockComponent component)
+	{
+		return clock->now - clock->synced_at[component];
+	}
+
+	/**
+	 * @brief Mark a component as caught up with the clock.
+	 *
+	 * Call it when the component is touched, and run the component for the
+	 * returned number of cycles.
+	 * @return uint64_t T-cycles the component was behind.
+	 */
+	static inline uint64_t beemu_clock_sync(BeemuClock *clock, BeemuClockComponent component)
+	{
+		const uint64_t pending = beemu_clock_pending(clock, component);
+		clock->synced_at[component] = clock->now;
+		return pending;
+	}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BEEMU_DEVICE_CLOCK_H
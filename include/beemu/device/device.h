@@ -6,16 +6,72 @@ extern "C"
 {
 #endif
 
+#include "clock.h"
+#include "display.h"
+#include "idle_loop.h"
 #include "processor/processor.h"
+#include "scheduler.h"
+
+	/**
+	 * @brief T-cycles, ticks of the 4 MiHz clock, in a machine cycle.
+	 */
+#define BEEMU_DEVICE_T_CYCLES_PER_M_CYCLE 4
+
+	/**
+	 * @brief T-cycles in a single frame, 154 lines of 456 cycles each.
+	 */
+#define BEEMU_DEVICE_CYCLES_PER_FRAME 70224
+
+	/**
+	 * @brief T-cycles an OAM DMA takes, a machine cycle per byte.
+	 */
+#define BEEMU_DEVICE_DMA_CYCLES (BEEMU_DISPLAY_SPRITE_COUNT * 4 * BEEMU_DEVICE_T_CYCLES_PER_M_CYCLE)
+
+	typedef struct BeemuDevice BeemuDevice;
+
+	/**
+	 * @brief Called when a scheduled event is due.
+	 *
+	 * Events fire after the instruction that reaches their deadline, so the
+	 * clock may be past it. Handlers that repeat should reschedule relative
+	 * to the deadline rather than to the clock, so that they do not drift.
+	 * @param device Device the event was scheduled on.
+	 * @param deadline Cycle the event was due at.
+	 */
+	typedef void (*BeemuEventHandler)(BeemuDevice *device, uint64_t deadline);
 
 	/**
 	 * @brief Device object that keeps everything contained.
 	 *
 	 */
-	typedef struct BeemuDevice
+	struct BeemuDevice
 	{
 		BeemuProcessor *processor;
-	} BeemuDevice;
+		/** Renders to its framebuffer on the BEEMU_EVENT_PPU_MODE events. */
+		BeemuDisplay *display;
+		BeemuClock clock;
+		/** Deadlines of the components, the processor runs uninterrupted between them. */
+		BeemuScheduler scheduler;
+		BeemuEventHandler event_handlers[BEEMU_EVENT_TYPE_COUNT];
+		/** Frames completed since the device was created. */
+		uint64_t frame_count;
+		/** Skips loops that poll memory until the next event, when enabled. */
+		BeemuIdleLoopDetector idle_loop;
+		/** Storage and handler of the IO page, the device watches its writes. */
+		uint8_t *io_page;
+		BeemuMemoryHandler io_handler;
+		/** Address the OAM DMA in progress copies from. */
+		uint16_t dma_source;
+	};
+
+	/**
+	 * @brief Decides when beemu_device_run_until stops.
+	 *
+	 * @param device Device being run.
+	 * @param context Context passed to beemu_device_run_until.
+	 * @return true to stop running.
+	 */
+	typedef bool (*BeemuDeviceStopPredicate)(const BeemuDevice *device, void *context);
 
 	/**
 	 * @brief Initialize a new BeemuDevice.
@@ -24,6 +80,16 @@ extern "C"
 	 */
 	BeemuDevice *beemu_device_new();
 
+	/**
+	 * @brief Initialize a new BeemuDevice, drawing with the given renderer.
+	 *
+	 * beemu_device_new uses the scanline renderer, the pixel FIFO is only
+	 * needed for programs that write to the display registers mid-line.
+	 * @param renderer Renderer of the display.
+	 * @return BeemuDevice* Pointer to the new object.
+	 */
+	BeemuDevice *beemu_device_new_with_renderer(BeemuDisplayRenderer renderer);
+
 	/**
 	 * @brief Free the pointer.
 	 *
@@ -31,15 +97,89 @@ extern "C"
 	 */
 	void beemu_device_free(BeemuDevice *device);
 
+	/**
+	 * @brief Get the T-cycles run since the current frame started.
+	 */
+	static inline uint32_t beemu_device_frame_cycle(const BeemuDevice *device)
+	{
+		const uint64_t frame_ends_at = beemu_scheduler_deadline(&device->scheduler, BEEMU_EVENT_FRAME_END);
+		return (uint32_t)(device->clock.now + BEEMU_DEVICE_CYCLES_PER_FRAME - frame_ends_at);
+	}
+
+	/**
+	 * @brief Set the function called when an event of a type is due.
+	 *
+	 * Events without a handler are dropped when they are due. The device
+	 * handles BEEMU_EVENT_FRAME_END, BEEMU_EVENT_PPU_MODE and
+	 * BEEMU_EVENT_DMA_COMPLETE itself, their handlers cannot be replaced.
+	 * @param device Device to act on.
+	 * @param type Event type to handle.
+	 * @param handler Function to call, NULL to drop the events.
+	 */
+	void beemu_device_set_event_handler(BeemuDevice *device, BeemuEventType type, BeemuEventHandler handler);
+
+	/**
+	 * @brief Set whether idle loops are skipped.
+	 *
+	 * An idle loop branches backwards to a body that cannot write memory,
+	 * and reaches its head with the same registers every time. Only events
+	 * can change what it polls, so the batch runners skip its iterations
+	 * up to the next deadline. Disabled by default, the cycles skipped are
+	 * counted in idle_loop.skipped_cycles.
+	 * @param device Device to act on.
+	 * @param enabled Whether to skip idle loops.
+	 */
+	void beemu_device_set_idle_loop_skipping(BeemuDevice *device, bool enabled);
+
+	/**
+	 * @brief Get the T-cycles skipped in idle loops so far.
+	 */
+	static inline uint64_t beemu_device_idle_loop_skipped_cycles(const BeemuDevice *device)
+	{
+		return device->idle_loop.skipped_cycles;
+	}
+
 	/**
 	 * @brief Run for one instruction.
 	 *
-	 * @param device
+	 * @param device Device to run.
+	 * @return uint32_t T-cycles the instruction took.
+	 */
+	uint32_t beemu_device_run(BeemuDevice *device);
+
+	/**
+	 * @brief Run whole instructions until at least the given number of T-cycles passed.
+	 *
+	 * @param device Device to run.
+	 * @param cycles T-cycles to run for.
+	 * @return uint64_t T-cycles actually run, overshooting by at most one instruction.
+	 */
+	uint64_t beemu_device_run_cycles(BeemuDevice *device, uint64_t cycles);
+
+	/**
+	 * @brief Run until the current frame ends.
+	 *
+	 * Cycles of the last instruction that spill over the frame count towards
+	 * the next one.
+	 * @param device Device to run.
+	 * @return uint64_t T-cycles run, including the spill over.
+	 */
+	uint64_t beemu_device_run_until_frame(BeemuDevice *device);
+
+	/**
+	 * @brief Run until a predicate holds.
+	 *
+	 * The predicate is checked before every instruction, so nothing runs if
+	 * it already holds.
+	 * @param device Device to run.
+	 * @param predicate Called with the device and the context.
+	 * @param context Passed to the predicate as is, may be NULL.
+	 * @return uint64_t T-cycles run.
 	 */
-	void beemu_device_run(BeemuDevice *device);
+	uint64_t beemu_device_run_until(BeemuDevice *device, BeemuDeviceStopPredicate predicate, void *context);
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif // BEEMU_DEVICE_DEVICE_H
\ No newline at end of file
+#endif // BEEMU_DEVICE_DEVICE_H
@@ -3,23 +3,86 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "memory.h"
+#include "sprite_bins.h"
+#include "tile_cache.h"
 
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
+	/**
+	 * @brief Width of the screen, in pixels.
+	 */
+#define BEEMU_DISPLAY_WIDTH 160
+	/**
+	 * @brief Height of the screen, in pixels.
+	 */
+#define BEEMU_DISPLAY_HEIGHT 144
+	/**
+	 * @brief Lines in a frame, including the 10 lines of VBlank.
+	 */
+#define BEEMU_DISPLAY_LINE_COUNT 154
+	/**
+	 * @brief T-cycles a single line takes.
+	 */
+#define BEEMU_DISPLAY_CYCLES_PER_LINE 456
+	/**
+	 * @brief T-cycles of mode 2, searching OAM for the sprites on the line.
+	 */
+#define BEEMU_DISPLAY_OAM_SCAN_CYCLES 80
+	/**
+	 * @brief T-cycles of mode 3, drawing the line, without any penalties.
+	 */
+#define BEEMU_DISPLAY_DRAWING_CYCLES 172
+	/**
+	 * @brief Sprites in OAM.
+	 */
+#define BEEMU_DISPLAY_SPRITE_COUNT 40
+	/**
+	 * @brief Sprites the hardware draws on a single line at most.
+	 */
+#define BEEMU_DISPLAY_SPRITES_PER_LINE 10
+
+	/**
+	 * @brief Memory pages the tile data spans.
+	 */
+#define BEEMU_DISPLAY_TILE_DATA_PAGE_COUNT (BEEMU_TILE_CACHE_TILE_COUNT * 16 / BEEMU_MEMORY_PAGE_SIZE)
+
+	/**
+	 * @brief Addresses of the display registers and memory.
+	 */
+#define BEEMU_DISPLAY_VRAM_ADDRESS 0x8000
+#define BEEMU_DISPLAY_OAM_ADDRESS 0xFE00
+#define BEEMU_DISPLAY_LCDC_ADDRESS 0xFF40
+#define BEEMU_DISPLAY_STAT_ADDRESS 0xFF41
+#define BEEMU_DISPLAY_SCY_ADDRESS 0xFF42
+#define BEEMU_DISPLAY_SCX_ADDRESS 0xFF43
+#define BEEMU_DISPLAY_LY_ADDRESS 0xFF44
+#define BEEMU_DISPLAY_LYC_ADDRESS 0xFF45
+#define BEEMU_DISPLAY_DMA_ADDRESS 0xFF46
+#define BEEMU_DISPLAY_BGP_ADDRESS 0xFF47
+#define BEEMU_DISPLAY_OBP0_ADDRESS 0xFF48
+#define BEEMU_DISPLAY_OBP1_ADDRESS 0xFF49
+#define BEEMU_DISPLAY_WY_ADDRESS 0xFF4A
+#define BEEMU_DISPLAY_WX_ADDRESS 0xFF4B
+
 	typedef enum BeemuLCDControlOperation
 	{
 		BEEMU_LCDC_OPERATION_STOP,
 		BEEMU_LCDC_OPERATION_CONTROL
 	} BeemuLCDControlOperation;
 
-	typedef enum BeemuSpriteSize
+	/**
+	 * @brief Modes of the display, as reported in the lower bits of STAT.
+	 */
+	typedef enum BeemuDisplayMode
 	{
-		BEEMU_SPRITE_SIZE_8_TO_8,
-		BEEMU_SPRITE_SIZE_8_TO_16
-	} BeemuSpriteSize;
+		BEEMU_DISPLAY_MODE_HBLANK,
+		BEEMU_DISPLAY_MODE_VBLANK,
+		BEEMU_DISPLAY_MODE_OAM_SCAN,
+		BEEMU_DISPLAY_MODE_DRAWING
+	} BeemuDisplayMode;
 
 	typedef struct BeemuDisplayLCDC
 	{
@@ -41,15 +104,140 @@ extern "C"
 		uint8_t lcdc_y_compare;
 		uint8_t dma_address;
 		BeemuDisplayLCDC lcdc_register;
+		uint8_t bg_palette;
+		uint8_t sprite_palettes[2];
+		uint8_t window_y;
+		uint8_t window_x;
 	} BeemuDisplayState;
 
+	/**
+	 * @brief Selects how the display draws its lines.
+	 */
+	typedef enum BeemuDisplayRenderer
+	{
+		/** Draw each line at once when mode 3 ends, from the registers at that point. */
+		BEEMU_DISPLAY_RENDERER_SCANLINE,
+		/**
+		 * Run the pixel FIFO dot by dot through mode 3, so that writes to the
+		 * registers mid-line take effect mid-line. Mode 3 then lasts as long
+		 * as the line takes to draw, instead of a fixed 172 T-cycles.
+		 */
+		BEEMU_DISPLAY_RENDERER_PIXEL_FIFO
+	} BeemuDisplayRenderer;
+
+	struct BeemuPixelFifo;
+
+	/**
+	 * @brief Display, drawing each line with the renderer it was created with.
+	 *
+	 * The display steps from mode to mode when the device tells it to, see
+	 * beemu_display_advance, and reads its registers and VRAM through the
+	 * memory bus. Writes to the tile data and OAM go through the display
+	 * instead, so that it can invalidate the tiles it decoded and the
+	 * sprites it sorted into lines.
+	 */
 	typedef struct BeemuDisplay
 	{
 		BeemuMemory *memory;
+		BeemuDisplayRenderer renderer;
+		/** State of the line being drawn, NULL for the scanline renderer. */
+		struct BeemuPixelFifo *fifo;
+		/** Storage the tile data pages wrote to before the display took them over. */
+		uint8_t *tile_data_pages[BEEMU_DISPLAY_TILE_DATA_PAGE_COUNT];
+		/** Handlers of the tile data pages before the display took them over. */
+		BeemuMemoryHandler tile_data_handlers[BEEMU_DISPLAY_TILE_DATA_PAGE_COUNT];
+		BeemuTileCache tile_cache;
+		/** Storage the OAM page wrote to before the display took it over. */
+		uint8_t *oam_page;
+		/** Handler of the OAM page before the display took it over. */
+		BeemuMemoryHandler oam_handler;
+		BeemuSpriteBins sprite_bins;
+		BeemuDisplayMode mode;
+		/** Line being drawn, LY reads 0 while the LCD is off. */
+		uint8_t line;
+		/** Lines of the window drawn so far this frame. */
+		uint8_t window_line;
+		bool lcd_on;
+		/** Shades, 0 for the lightest, of the last frame. */
+		uint8_t framebuffer[BEEMU_DISPLAY_HEIGHT][BEEMU_DISPLAY_WIDTH];
 	} BeemuDisplay;
 
+	/**
+	 * @brief Create a display reading from the given memory.
+	 *
+	 * The display starts as if the last line of a frame just ended. It
+	 * routes the writes to the tile data and OAM pages through itself,
+	 * resetting the pages of the memory undoes this.
+	 * @param memory Memory bus the registers, VRAM and OAM are on.
+	 * @return BeemuDisplay* Pointer to the new display.
+	 */
+	BeemuDisplay *beemu_display_new(BeemuMemory *memory);
+
+	/**
+	 * @brief Create a display drawing with the given renderer.
+	 *
+	 * See beemu_display_new, which uses the scanline renderer.
+	 * @param memory Memory bus the registers, VRAM and OAM are on.
+	 * @param renderer Renderer to draw the lines with.
+	 * @return BeemuDisplay* Pointer to the new display.
+	 */
+	BeemuDisplay *beemu_display_new_with_renderer(BeemuMemory *memory, BeemuDisplayRenderer renderer);
+
+	/**
+	 * @brief Free the display.
+	 */
+	void beemu_display_free(BeemuDisplay *display);
+
+	/**
+	 * @brief Decode the display registers.
+	 *
+	 * @param memory Memory bus the registers are on.
+	 * @param state State to decode into.
+	 */
+	void beemu_display_read_state(BeemuMemory *memory, BeemuDisplayState *state);
+
+	/**
+	 * @brief Draw a line of background, window and sprites to the framebuffer.
+	 *
+	 * Draws with the scanline renderer whichever renderer the display uses.
+	 *
+	 * @param display Display to draw.
+	 * @param line Line to draw, below BEEMU_DISPLAY_HEIGHT.
+	 */
+	void beemu_display_render_line(BeemuDisplay *display, uint8_t line);
+
+	/**
+	 * @brief Convert the framebuffer to 32 bit pixels, RGBA8888 for instance.
+	 *
+	 * @param display Display to export.
+	 * @param colours Pixel value of each shade, lightest first.
+	 * @param pixels BEEMU_DISPLAY_WIDTH * BEEMU_DISPLAY_HEIGHT pixels to write to, row by row.
+	 */
+	void beemu_display_export_32(const BeemuDisplay *display, const uint32_t colours[4], uint32_t *pixels);
+
+	/**
+	 * @brief Convert the framebuffer to 16 bit pixels, RGB565 for instance.
+	 *
+	 * See beemu_display_export_32.
+	 */
+	void beemu_display_export_16(const BeemuDisplay *display, const uint16_t colours[4], uint16_t *pixels);
+
+	/**
+	 * @brief End the current mode and enter the next one.
+	 *
+	 * Updates LY and STAT, draws the line when mode 3 ends and requests the
+	 * VBlank and STAT interrupts. While the LCD is off nothing happens, and
+	 * the display waits for the frame to end, so that turning it on takes
+	 * effect from the next frame. The pixel FIFO instead advances every
+	 * M-cycle of mode 3, drawing the pixels of the dots since the last time.
+	 * @param display Display to advance.
+	 * @return uint32_t T-cycles until the mode it entered ends, or until the
+	 * FIFO runs again.
+	 */
+	uint32_t beemu_display_advance(BeemuDisplay *display);
+
 #ifdef __cplusplus
 }
 #endif
 
-#endif // BEEMU_DEVICE_Display_H
\ No newline at end of file
+#endif // BEEMU_DEVICE_Display_H
@@ -0,0 +1,92 @@
+/**
+ * @file idle_loop.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Detect loops that only poll memory, so that they can be skipped.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_DEVICE_IDLE_LOOP_H
+#define BEEMU_DEVICE_IDLE_LOOP_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "processor/processor.h"
+
+	/**
+	 * @brief Longest loop body, in instructions, considered for skipping.
+	 */
+#define BEEMU_IDLE_LOOP_MAX_INSTRUCTIONS 8
+
+	/**
+	 * @brief Tracks the innermost backwards branch the processor takes.
+	 *
+	 * A loop is idle if its body cannot write memory, and the registers are
+	 * the same every time it reaches its head. Such a loop spins until an
+	 * event changes the memory it polls, because in between nothing else
+	 * can.
+	 */
+	typedef struct BeemuIdleLoopDetector
+	{
+		/** Skip idle loops, off by default. */
+		bool enabled;
+		/** T-cycles skipped so far, for diagnostics. */
+		uint64_t skipped_cycles;
+		/** First instruction of the loop being tracked. */
+		uint16_t head;
+		/** Address of the branch that closes the loop. */
+		uint16_t branch;
+		/** Whether the body between head and branch is free of side effects. */
+		bool is_side_effect_free;
+		/** Whether registers holds the state of the previous iteration. */
+		bool has_snapshot;
+		/** Registers at the head of the previous iteration. */
+		uint16_t registers[BEEMU_REGISTER_PAIR_COUNT];
+		/** Value of the device clock at the head of the previous iteration. */
+		uint64_t snapshot_at;
+	} BeemuIdleLoopDetector;
+
+	/**
+	 * @brief Initialise a disabled detector.
+	 */
+	void beemu_idle_loop_init(BeemuIdleLoopDetector *detector);
+
+	/**
+	 * @brief Check if a loop body can neither write memory nor leave the loop
+	 * by anything but a branch.
+	 *
+	 * Loads into registers, arithmatic, rotations and BIT are allowed as long
+	 * as they do not write memory, so are conditional jumps, calls, returns,
+	 * stack operations and CPU control instructions other than NOP are not.
+	 * @param memory Memory the loop lives in.
+	 * @param head Address of the first instruction of the loop.
+	 * @param branch Address of the branch that closes the loop.
+	 * @return true if the body is side effect free.
+	 */
+	bool beemu_idle_loop_is_side_effect_free(BeemuMemory *memory, uint16_t head, uint16_t branch);
+
+	/**
+	 * @brief Observe a backwards branch the processor just took.
+	 *
+	 * @param detector Detector to update.
+	 * @param processor Processor that took the branch, now at the loop head.
+	 * @param branch Address of the branch.
+	 * @param now Current value of the device clock.
+	 * @return uint64_t T-cycles a single iteration takes if the loop is idle,
+	 * 0 otherwise.
+	 */
+	uint64_t beemu_idle_loop_observe(BeemuIdleLoopDetector *detector, BeemuProcessor *processor, uint16_t branch, uint64_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BEEMU_DEVICE_IDLE_LOOP_H
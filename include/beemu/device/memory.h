@@ -27,10 +27,61 @@ extern "C"
 	 */
 	const uint16_t beemu_memory_block_get_size(BeemuMemoryBlock block);
 
+	/**
+	 * @brief Number of pages the 16 bit address space is split into.
+	 */
+#define BEEMU_MEMORY_PAGE_COUNT 256
+	/**
+	 * @brief Size of a single page, in bytes.
+	 */
+#define BEEMU_MEMORY_PAGE_SIZE 256
+
+	/**
+	 * @brief Called to read from a page that has no backing storage.
+	 *
+	 * @param context Context the handler was registered with.
+	 * @param address Full address being read.
+	 * @return uint8_t Value read.
+	 */
+	typedef uint8_t (*BeemuMemoryReadHandler)(void *context, uint16_t address);
+
+	/**
+	 * @brief Called to write to a page that has no backing storage.
+	 *
+	 * @param context Context the handler was registered with.
+	 * @param address Full address being written.
+	 * @param value Value to be written.
+	 */
+	typedef void (*BeemuMemoryWriteHandler)(void *context, uint16_t address, uint8_t value);
+
+	/**
+	 * @brief Handlers a page falls back to, used for MMIO and bank controllers.
+	 */
+	typedef struct BeemuMemoryHandler
+	{
+		/** Null reads open bus, 0xFF. */
+		BeemuMemoryReadHandler read;
+		/** Null drops the write. */
+		BeemuMemoryWriteHandler write;
+		void *context;
+	} BeemuMemoryHandler;
+
+	/**
+	 * @brief The memory bus.
+	 *
+	 * The address space is split to 256 byte pages, each page points to its
+	 * backing storage for reads and writes separately, accesses to pages
+	 * without one fall back to the page's handler. By default every page
+	 * within memory_size points to the flat memory array, bank switching
+	 * is done by repointing pages.
+	 */
 	typedef struct BeemuMemory
 	{
 		int memory_size;
 		uint8_t *memory;
+		const uint8_t *read_pages[BEEMU_MEMORY_PAGE_COUNT];
+		uint8_t *write_pages[BEEMU_MEMORY_PAGE_COUNT];
+		BeemuMemoryHandler handlers[BEEMU_MEMORY_PAGE_COUNT];
 	} BeemuMemory;
 
 	/**
@@ -50,36 +101,119 @@ extern "C"
 	 */
 	void beemu_memory_free(BeemuMemory *memory);
 
+	/**
+	 * @brief Point every page back to the flat memory array.
+	 *
+	 * Pages that are not entirely within memory_size are routed to
+	 * handlers that bounds check against it instead, and any handlers
+	 * set before are discarded.
+	 * @param memory BeemuMemory object to reset.
+	 */
+	void beemu_memory_reset_pages(BeemuMemory *memory);
+
+	/**
+	 * @brief Point consecutive pages to consecutive backing storage.
+	 *
+	 * Either storage may be null, in which case the accesses of that kind
+	 * fall back to the page handlers, ROM for instance is mapped with a
+	 * null write storage. Storage must outlive the mapping.
+	 * @param memory BeemuMemory object to map.
+	 * @param first_page Index of the first page, address >> 8.
+	 * @param page_count Number of pages to map.
+	 * @param read_storage Storage reads are served from.
+	 * @param write_storage Storage writes go to.
+	 */
+	void beemu_memory_map_pages(
+		BeemuMemory *memory,
+		uint8_t first_page,
+		uint16_t page_count,
+		const uint8_t *read_storage,
+		uint8_t *write_storage);
+
+	/**
+	 * @brief Set the handlers of consecutive pages.
+	 *
+	 * Handlers are only called for accesses the page has no storage for.
+	 * @param memory BeemuMemory object to map.
+	 * @param first_page Index of the first page, address >> 8.
+	 * @param page_count Number of pages to set the handlers of.
+	 * @param handler Handlers to set.
+	 */
+	void beemu_memory_set_page_handlers(
+		BeemuMemory *memory,
+		uint8_t first_page,
+		uint16_t page_count,
+		BeemuMemoryHandler handler);
+
+	/**
+	 * @brief Read from a page without storage through its handler.
+	 *
+	 * @param memory pointer to the BeemuMemory object to be read from.
+	 * @param address address to be read.
+	 * @return uint8_t Value at the address.
+	 */
+	uint8_t beemu_memory_read_unmapped(BeemuMemory *memory, uint16_t address);
+
+	/**
+	 * @brief Write to a page without storage through its handler.
+	 *
+	 * @param memory BeemuMemory object to write to
+	 * @param address Address to write at.
+	 * @param value value to be written
+	 */
+	void beemu_memory_write_unmapped(BeemuMemory *memory, uint16_t address, uint8_t value);
+
 	/**
 	 * @brief Read value at address.
 	 *
-	 * Get the value at the given memory address.
+	 * Get the value at the given memory address, addresses wrap around
+	 * the 16 bit address space.
 	 * @param memory pointer to the BeemuMemory object to be read from.
 	 * @param address address to be read.
 	 * @return uint8_t Value at the address.
 	 */
-	uint8_t beemu_memory_read(BeemuMemory *memory, int address);
+	static inline uint8_t beemu_memory_read(BeemuMemory *memory, int address)
+	{
+		const uint16_t bus_address = (uint16_t)address;
+		const uint8_t *page = memory->read_pages[bus_address >> 8];
+		if (page) {
+			return page[bus_address & 0xFF];
+		}
+		return beemu_memory_read_unmapped(memory, bus_address);
+	}
 
 	/**
 	 * @brief Write value to a memory address
 	 *
+	 * Addresses wrap around the 16 bit address space.
 	 * @param memory BeemuMemory object to write to
 	 * @param address Address to write at.
 	 * @param value value to be written
 	 */
-	void beemu_memory_write(BeemuMemory *memory, int address, uint8_t value);
+	static inline void beemu_memory_write(BeemuMemory *memory, int address, uint8_t value)
+	{
+		const uint16_t bus_address = (uint16_t)address;
+		uint8_t *page = memory->write_pages[bus_address >> 8];
+		if (page) {
+			page[bus_address & 0xFF] = value;
+			return;
+		}
+		beemu_memory_write_unmapped(memory, bus_address, value);
+	}
 
 	/**
 	 * @brief Write bulk data to memory.
 	 *
-	 * Write bulk data from a buffer to the memory.
+	 * Write bulk data from a buffer to the memory, nothing is written if
+	 * any page in the range has neither write storage nor a write handler.
 	 *
 	 * @param memory BeemuMemory object to write into.
 	 * @param address Start address of the memory.
 	 * @param buffer Buffer to copy from.
 	 * @param size Size of memory to write.
 	 * @return true If the write operation is successful
-	 * @return false If the write operation fails, for instance boundaries.
+	 * @return false If the write operation fails, for instance boundaries
+	 * or read only pages.
 	 */
 	bool beemu_memory_write_buffer(BeemuMemory *memory, int address, uint8_t *buffer, int size);
 
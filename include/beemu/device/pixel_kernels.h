@@ -0,0 +1,98 @@
+/**
+ * @file pixel_kernels.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Kernels decoding tile rows and expanding colour indices to pixels.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_DEVICE_PIXEL_KERNELS_H
+#define BEEMU_DEVICE_PIXEL_KERNELS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+	/**
+	 * @brief Instruction sets the kernels are written for.
+	 */
+	typedef enum BeemuPixelKernelLevel
+	{
+		/** Plain C, available everywhere. */
+		BEEMU_PIXEL_KERNEL_SCALAR,
+		/** 16 bytes at a time, available on every x86-64 processor. */
+		BEEMU_PIXEL_KERNEL_SSE2,
+		/** 32 bytes at a time, selected if the processor supports it. */
+		BEEMU_PIXEL_KERNEL_AVX2,
+		BEEMU_PIXEL_KERNEL_LEVEL_COUNT
+	} BeemuPixelKernelLevel;
+
+	/**
+	 * @brief Decode 2bpp planar rows, pairs of low and high bytes, to 8
+	 * colour indices each, leftmost first.
+	 *
+	 * @param rows Row pairs to decode, 2 bytes per row.
+	 * @param row_count Number of rows.
+	 * @param indices Indices to write to, 8 per row.
+	 */
+	typedef void (*BeemuDecodeRowsKernel)(const uint8_t *rows, size_t row_count, uint8_t *indices);
+
+	/**
+	 * @brief Expand colour indices through a palette to 32 bit pixels.
+	 *
+	 * @param indices Colour indices, below 4.
+	 * @param count Number of pixels.
+	 * @param palette Palette register, BGP, OBP0 or OBP1, mapping indices to shades.
+	 * @param colours Pixel value of each shade, in whichever layout the caller wants.
+	 * @param pixels Pixels to write to.
+	 */
+	typedef void (*BeemuExpand32Kernel)(const uint8_t *indices, size_t count, uint8_t palette, const uint32_t colours[4], uint32_t *pixels);
+
+	/**
+	 * @brief Expand colour indices through a palette to 16 bit pixels.
+	 *
+	 * See BeemuExpand32Kernel, for RGB565 and other 16 bit layouts.
+	 */
+	typedef void (*BeemuExpand16Kernel)(const uint8_t *indices, size_t count, uint8_t palette, const uint16_t colours[4], uint16_t *pixels);
+
+	/**
+	 * @brief Kernels written for an instruction set.
+	 */
+	typedef struct BeemuPixelKernels
+	{
+		BeemuPixelKernelLevel level;
+		const char *name;
+		BeemuDecodeRowsKernel decode_rows;
+		/** For RGBA8888. */
+		BeemuExpand32Kernel expand_32;
+		/** For RGB565. */
+		BeemuExpand16Kernel expand_16;
+	} BeemuPixelKernels;
+
+	/**
+	 * @brief Get the kernels of an instruction set.
+	 *
+	 * @param level Instruction set.
+	 * @return const BeemuPixelKernels* Its kernels, NULL if the processor
+	 * or the build does not support it.
+	 */
+	const BeemuPixelKernels *beemu_pixel_kernels_for(BeemuPixelKernelLevel level);
+
+	/**
+	 * @brief Get the kernels of the widest instruction set the processor
+	 * supports, selected on the first call.
+	 */
+	const BeemuPixelKernels *beemu_pixel_kernels_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BEEMU_DEVICE_PIXEL_KERNELS_H
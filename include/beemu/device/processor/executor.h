@@ -7,22 +7,27 @@ extern "C"
 #endif
 
 #include "../primitives/instruction.h"
-#include "registers.h"
-#include "../memory.h"
+#include "processor.h"
 
 	/**
-	 * @brief Execute a single instruction on the device memory and file.
+	 * @brief Execute a single instruction directly on the processor.
 	 *
-	 * @param memory device memory.
-	 * @param file register file.
+	 * Unlike the interpreter, this does not emit or invoke any commands,
+	 * the instruction's effects are applied all at once. The resulting state
+	 * matches what the interpreter leaves behind at the instruction boundary,
+	 * the program counter is moved past the instruction or to the jump target.
+	 * Jumps and rotates, which the interpreter does not emit commands for
+	 * yet, are executed as the hardware would.
+	 *
+	 * @param processor Processor to execute the instruction on.
 	 * @param instruction Instruction to execute.
 	 *
-	 * @return elapsed clock cycles
+	 * @return elapsed clock cycles, in M-cycles.
 	 */
-	uint8_t execute_instruction(BeemuMemory *memory, BeemuRegisters *file, BeemuInstruction instruction);
+	uint8_t beemu_executor_execute_instruction(BeemuProcessor *processor, const BeemuInstruction *instruction);
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif // BEEMU_INSTRUCTION_EXECUTOR_H
\ No newline at end of file
+#endif // BEEMU_INSTRUCTION_EXECUTOR_H
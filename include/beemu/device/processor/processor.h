@@ -7,8 +7,9 @@ extern "C"
 #include <stdint.h>
 #include <stdbool.h>
 #include "registers.h"
-#include "executor.h"
 #include "../memory.h"
+#include "../rom.h"
+#include "../primitives/instruction.h"
 
 	static const BeemuRegister_8 ORDERED_REGISTER_NAMES[8] = {BEEMU_REGISTER_B,
 															  BEEMU_REGISTER_C,
@@ -45,6 +46,27 @@ extern "C"
 	 */
 	static const int BEEMU_DEVICE_MEMORY_ROM_LOCATION = 200;
 
+	/**
+	 * @brief Address of IF, the interrupts requested by the hardware.
+	 */
+#define BEEMU_PROCESSOR_INTERRUPT_FLAG_ADDRESS 0xFF0F
+	/**
+	 * @brief Address of IE, the interrupts the program listens to.
+	 */
+#define BEEMU_PROCESSOR_INTERRUPT_ENABLE_ADDRESS 0xFFFF
+
+	/**
+	 * @brief Sources of interrupts, by their bit in IF and IE.
+	 */
+	typedef enum BeemuInterrupt
+	{
+		BEEMU_INTERRUPT_VBLANK,
+		BEEMU_INTERRUPT_LCD_STAT,
+		BEEMU_INTERRUPT_TIMER,
+		BEEMU_INTERRUPT_SERIAL,
+		BEEMU_INTERRUPT_JOYPAD
+	} BeemuInterrupt;
+
 	/**
 	 * @brief Describes the processor state.
 	 *
@@ -58,6 +80,19 @@ extern "C"
 		BEEMU_DEVICE_AWAITING_INTERRUPT_ENABLE
 	} BeemuProcessorState;
 
+	/**
+	 * @brief Selects how the processor executes instructions.
+	 */
+	typedef enum BeemuExecutionMode
+	{
+		/** Parse instructions to commands and invoke them M-cycle by M-cycle. */
+		BEEMU_EXECUTION_MODE_CYCLE_ACCURATE,
+		/** Execute whole instructions at once, bypassing the command queue. */
+		BEEMU_EXECUTION_MODE_INSTRUCTION
+	} BeemuExecutionMode;
+
+	struct BeemuCommandQueue;
+
 	typedef struct BeemuProcessor
 	{
 		BeemuRegisters *registers;
@@ -65,6 +100,13 @@ extern "C"
 		BeemuProcessorState processor_state;
 		bool interrupts_enabled;
 		uint8_t elapsed_clock_cycle;
+		/** Opcode of the instruction being executed, as latched during its fetch. */
+		uint8_t instruction_register;
+		/** Reused by every instruction to hold its parsed commands. */
+		struct BeemuCommandQueue *command_queue;
+		BeemuExecutionMode execution_mode;
+		/** Defer the flags of 8 bit ALU operations until they are read. */
+		bool lazy_flags;
 	} BeemuProcessor;
 
 	/**
@@ -92,11 +134,24 @@ extern "C"
 	 */
 	bool beemu_processor_load(BeemuProcessor *processor, uint8_t *rom);
 
+	/**
+	 * @brief Map a ROM into the processor memory without copying it.
+	 *
+	 * Maps bank 0 to 0x0000-0x3FFF and bank 1 to 0x4000-0x7FFF, read only.
+	 * @param processor BeemuProcessor instance to load the ROM.
+	 * @param rom Mapped ROM, which must outlive the processor.
+	 * @return bool Whether or not the load succeeded.
+	 */
+	bool beemu_processor_load_rom(BeemuProcessor *processor, const BeemuRom *rom);
+
 	/**
 	 * @brief Run the processor for a single instruction.
 	 *
-	 * Run the data loaded at the ROM section of the memory for a single
-	 * instruction and return the elapsed clock cycle count.
+	 * Fetch the instruction at the program counter and tokenize it, then
+	 * either parse it and invoke the resulting commands or execute it
+	 * directly, depending on the execution mode. An EI takes effect once
+	 * the instruction after it ran. Returns the elapsed clock cycle count,
+	 * in M-cycles.
 	 *
 	 * @param processor BeemuProcessor object pointer.
 	 * @return the elapsed clock cycle count.
@@ -120,6 +175,48 @@ extern "C"
 	 * @param state The new state of the processor.
 	 */
 	void beemu_processor_set_state(BeemuProcessor *processor, BeemuProcessorState state);
+
+	/**
+	 * @brief Set how the processor executes instructions.
+	 *
+	 * Takes effect from the next instruction onwards, so a run can skip
+	 * through parts in the faster instruction mode and switch to the cycle
+	 * accurate mode afterwards. Processors start cycle accurate.
+	 * @param processor BeemuProcessor object pointer.
+	 * @param mode The new execution mode.
+	 */
+	void beemu_processor_set_execution_mode(BeemuProcessor *processor, BeemuExecutionMode mode);
+
+	/**
+	 * @brief Set whether the flags of ALU operations are computed lazily.
+	 *
+	 * When enabled, 8 bit ALU operations only record their operands and
+	 * the flags are computed when F is next read, by a conditional jump,
+	 * PUSH AF or beemu_registers_flags_materialise. Processors start with
+	 * lazy flags disabled, disabling them materialises pending flags.
+	 * @param processor BeemuProcessor object pointer.
+	 * @param enabled Whether to defer flags.
+	 */
+	void beemu_processor_set_lazy_flags(BeemuProcessor *processor, bool enabled);
+
+	/**
+	 * @brief Check if the processor is waiting for an interrupt, after HALT or STOP.
+	 */
+	static inline bool beemu_processor_is_halted(const BeemuProcessor *processor)
+	{
+		return processor->processor_state == BEEMU_DEVICE_HALT || processor->processor_state == BEEMU_DEVICE_STOP;
+	}
+
+	/**
+	 * @brief Check if an interrupt is both requested and enabled, which
+	 * wakes a halted processor whether or not IME is set.
+	 */
+	bool beemu_processor_interrupt_pending(const BeemuProcessor *processor);
+
+	/**
+	 * @brief Request an interrupt by setting its bit in IF.
+	 */
+	void beemu_processor_request_interrupt(BeemuProcessor *processor, BeemuInterrupt interrupt);
 #ifdef __cplusplus
 }
 #endif
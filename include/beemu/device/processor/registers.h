@@ -6,6 +6,7 @@ extern "C"
 #endif
 #include <stdint.h>
 #include <stdbool.h>
+#include "../primitives/instruction.h"
 #include "../primitives/register.h"
 
 	/**
@@ -20,18 +21,96 @@ extern "C"
 		BEEMU_FLAG_C = 4  // Carry
 	} BeemuFlag;
 
+	/**
+	 * @brief Whether the host stores multi-byte values most significant byte first.
+	 */
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define BEEMU_HOST_BIG_ENDIAN 1
+#else
+#define BEEMU_HOST_BIG_ENDIAN 0
+#endif
+
+	/**
+	 * @brief Number of 16 bit slots in the register file, one per BeemuRegister_16.
+	 */
+#define BEEMU_REGISTER_PAIR_COUNT 7
+
+	/**
+	 * @brief The last ALU operation, whose flags have not been computed yet.
+	 */
+	typedef struct BeemuLazyFlags
+	{
+		/** @brief Whether the flags in F are stale until materialised. */
+		bool pending;
+		/** @brief Leave the C flag as it was, as INC and DEC do. */
+		bool preserve_carry;
+		/** @brief A BeemuOperation, see beemu_registers_flags_defer. */
+		uint8_t operation;
+		uint8_t first_value;
+		uint8_t second_value;
+		/** @brief Value of the C flag before the operation. */
+		uint8_t carry_flag;
+	} BeemuLazyFlags;
+
 	/**
 	 * @brief Struct holding registers and flags.
 	 *
+	 * Every 16 bit register is stored natively in pairs, indexed by its
+	 * BeemuRegister_16, and the 8 bit registers alias the halves of BC, DE,
+	 * HL and AF in host byte order. The slot of the pseudo-register M is
+	 * unused, (HL) is resolved by whoever dereferences it.
+	 *
+	 * F may be stale while lazy_flags is pending, anything other than the
+	 * functions below must call beemu_registers_flags_materialise before
+	 * reading flags directly.
 	 */
 	typedef struct BeemuRegisters
 	{
-		uint8_t registers[7];
-		uint8_t flags;
-		uint16_t stack_pointer;
-		uint16_t program_counter;
+		union
+		{
+			/** @brief 16 bit registers, indexed by BeemuRegister_16. */
+			uint16_t pairs[BEEMU_REGISTER_PAIR_COUNT];
+			/** @brief 8 bit halves of the pairs, see beemu_registers_ptr_8. */
+			uint8_t bytes[2 * BEEMU_REGISTER_PAIR_COUNT];
+			struct
+			{
+				uint16_t general_purpose[BEEMU_REGISTER_SP];
+				uint16_t stack_pointer;
+				uint16_t program_counter;
+#if BEEMU_HOST_BIG_ENDIAN
+				uint8_t accumulator;
+				uint8_t flags;
+#else
+				uint8_t flags;
+				uint8_t accumulator;
+#endif
+			};
+		};
+		/** @brief Operation F is pending on, see beemu_registers_flags_defer. */
+		BeemuLazyFlags lazy_flags;
 	} BeemuRegisters;
 
+	/**
+	 * @brief Get a pointer to an 8 bit register.
+	 *
+	 * @param registers Register file pointer.
+	 * @param register_ Register to point to.
+	 * @return uint8_t* Pointer to the half of the pair holding the register.
+	 */
+	static inline uint8_t *beemu_registers_ptr_8(BeemuRegisters *registers, BeemuRegister_8 register_)
+	{
+		// High and low halves of each pair, in the order of BeemuRegister_8.
+		static const uint8_t byte_indices[] = {
+			2 * BEEMU_REGISTER_AF + !BEEMU_HOST_BIG_ENDIAN,
+			2 * BEEMU_REGISTER_BC + !BEEMU_HOST_BIG_ENDIAN,
+			2 * BEEMU_REGISTER_BC + BEEMU_HOST_BIG_ENDIAN,
+			2 * BEEMU_REGISTER_DE + !BEEMU_HOST_BIG_ENDIAN,
+			2 * BEEMU_REGISTER_DE + BEEMU_HOST_BIG_ENDIAN,
+			2 * BEEMU_REGISTER_HL + !BEEMU_HOST_BIG_ENDIAN,
+			2 * BEEMU_REGISTER_HL + BEEMU_HOST_BIG_ENDIAN};
+		return &registers->bytes[byte_indices[register_]];
+	}
+
 	/**
 	 * @brief Create a new BeemuRegisters object.
 	 *
@@ -49,6 +128,56 @@ extern "C"
 	 */
 	void beemu_registers_free(BeemuRegisters *registers);
 
+	/**
+	 * @brief Compute the flags of the pending operation, if there is one.
+	 *
+	 * Called by every function here that reads F, debuggers and other
+	 * direct readers of flags must call it too.
+	 * @param registers Register file pointer.
+	 */
+	void beemu_registers_flags_materialise(BeemuRegisters *registers);
+
+	/**
+	 * @brief Compute F as the next read would see it, leaving pending flags pending.
+	 *
+	 * For readers that must not change the register file, such as the parser.
+	 * @param registers Register file pointer.
+	 * @return uint8_t Value of F.
+	 */
+	uint8_t beemu_registers_flags_peek(const BeemuRegisters *registers);
+
+	/**
+	 * @brief Record an 8 bit ALU operation instead of computing its flags.
+	 *
+	 * The flags are computed from the operands the next time F is read.
+	 * @param registers Register file pointer.
+	 * @param operation Operation, one of those with operand flags.
+	 * @param first_value First operand.
+	 * @param second_value Second operand.
+	 * @param carry_flag Value of the C flag before the operation.
+	 * @param preserve_carry Leave the C flag untouched, as INC and DEC do.
+	 */
+	static inline void beemu_registers_flags_defer(
+		BeemuRegisters *registers,
+		BeemuOperation operation,
+		uint8_t first_value,
+		uint8_t second_value,
+		uint8_t carry_flag,
+		bool preserve_carry)
+	{
+		if (preserve_carry && registers->lazy_flags.pending)
+		{
+			// The carry to preserve is still pending itself.
+			beemu_registers_flags_materialise(registers);
+		}
+		registers->lazy_flags.pending = true;
+		registers->lazy_flags.preserve_carry = preserve_carry;
+		registers->lazy_flags.operation = (uint8_t)operation;
+		registers->lazy_flags.first_value = first_value;
+		registers->lazy_flags.second_value = second_value;
+		registers->lazy_flags.carry_flag = carry_flag;
+	}
+
 	/**
 	 * @brief Read the value from a single register
 	 *
@@ -56,7 +185,18 @@ extern "C"
 	 * @param register_ Register value to read from.
 	 * @return uint16_t Value.
 	 */
-	uint16_t beemu_registers_read_register_value(BeemuRegisters *registers, BeemuRegister register_);
+	static inline uint16_t beemu_registers_read_register_value(BeemuRegisters *registers, BeemuRegister register_)
+	{
+		if (register_.type == BEEMU_EIGHT_BIT_REGISTER)
+		{
+			return *beemu_registers_ptr_8(registers, register_.name_of.eight_bit_register);
+		}
+		if (register_.name_of.sixteen_bit_register == BEEMU_REGISTER_AF && registers->lazy_flags.pending)
+		{
+			beemu_registers_flags_materialise(registers);
+		}
+		return registers->pairs[register_.name_of.sixteen_bit_register];
+	}
 
 	/**
 	 * @brief Write to a register, a value.
@@ -65,7 +205,22 @@ extern "C"
 	 * @param register_ Register to write to.
 	 * @param value Value to write.
 	 */
-	void beemu_registers_write_register_value(BeemuRegisters *registers, BeemuRegister register_, uint16_t value);
+	static inline void beemu_registers_write_register_value(BeemuRegisters *registers, BeemuRegister register_, uint16_t value)
+	{
+		if (register_.type == BEEMU_EIGHT_BIT_REGISTER)
+		{
+			*beemu_registers_ptr_8(registers, register_.name_of.eight_bit_register) = (uint8_t)value;
+		}
+		else
+		{
+			if (register_.name_of.sixteen_bit_register == BEEMU_REGISTER_AF)
+			{
+				// Writing AF overwrites whatever flags were pending.
+				registers->lazy_flags.pending = false;
+			}
+			registers->pairs[register_.name_of.sixteen_bit_register] = value;
+		}
+	}
 
 	/**
 	 * @brief Set the value of a single flag.
@@ -10,7 +10,13 @@ extern "C"
 
 #include "../primitives/instruction.h"
 
-	BeemuInstruction tokenize_instruction(uint8_t instruction);
+	/**
+	 * @brief Build the tokenizer's pre-decoded instruction tables.
+	 *
+	 * Tokenization builds the tables lazily on first use, calling this
+	 * beforehand moves that cost to startup.
+	 */
+	void beemu_tokenizer_init(void);
 
 	/**
 	 * @brief Tokenize an instruction.
@@ -22,6 +28,18 @@ extern "C"
 	 */
 	BeemuInstruction *beemu_tokenizer_tokenize(uint32_t instruction);
 
+	/**
+	 * @brief Tokenize an instruction into caller owned storage.
+	 *
+	 * Non-allocating counterpart of beemu_tokenizer_tokenize, the token
+	 * may live on the stack or in an array and is entirely overwritten.
+	 *
+	 * @param token Token to write the tokenized instruction into.
+	 * @param instruction Instruction to tokenize, in the same format
+	 * beemu_tokenizer_tokenize expects.
+	 */
+	void beemu_tokenizer_tokenize_into(BeemuInstruction *token, uint32_t instruction);
+
 	/**
 	 * @brief Free a instruction token.
 	 *
@@ -0,0 +1,96 @@
+/**
+ * @file rom.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Cartridge ROMs mapped straight from their files.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_DEVICE_ROM_H
+#define BEEMU_DEVICE_ROM_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "memory.h"
+
+	/**
+	 * @brief Size of a single switchable ROM bank.
+	 */
+#define BEEMU_ROM_BANK_SIZE 0x4000
+
+	/**
+	 * @brief Fields of the cartridge header at 0x0100-0x014F.
+	 */
+	typedef struct BeemuRomHeader
+	{
+		/** Null terminated title, up to 16 characters. */
+		char title[17];
+		uint8_t cartridge_type;
+		uint8_t rom_size_code;
+		uint8_t ram_size_code;
+		/** Number of 16 KiB banks, as declared by the ROM size code. */
+		uint16_t bank_count;
+		/** Whether the header checksum at 0x014D matched. */
+		bool header_checksum_valid;
+	} BeemuRomHeader;
+
+	/**
+	 * @brief A ROM file mapped read only into the address space.
+	 *
+	 * The ROM is never copied, processors loading it point their memory
+	 * pages into the mapping, so any number of them can share one BeemuRom
+	 * and the OS shares the pages between processes too. The ROM must
+	 * outlive every processor it is loaded into.
+	 */
+	typedef struct BeemuRom
+	{
+		const uint8_t *data;
+		size_t size;
+		BeemuRomHeader header;
+		/** Platform specific handle of the mapping, if any. */
+		void *mapping;
+	} BeemuRom;
+
+	/**
+	 * @brief Map a ROM file and parse its header.
+	 *
+	 * @param path Path to the ROM file.
+	 * @return BeemuRom* The ROM, or null if the file cannot be mapped or is
+	 * smaller than its header declares.
+	 */
+	BeemuRom *beemu_rom_open(const char *path);
+
+	/**
+	 * @brief Unmap the ROM file and free the ROM.
+	 *
+	 * @param rom ROM to close.
+	 */
+	void beemu_rom_close(BeemuRom *rom);
+
+	/**
+	 * @brief Map a ROM bank to consecutive pages of the memory.
+	 *
+	 * Pages are mapped read only, writes to them are dropped until a bank
+	 * controller sets its handlers.
+	 * @param memory Memory to map the bank into.
+	 * @param rom ROM to map the bank of.
+	 * @param first_page Page to map the bank at, 0x00 or 0x40 typically.
+	 * @param bank Index of the bank.
+	 * @return bool false if the ROM does not have the bank.
+	 */
+	bool beemu_rom_map_bank(BeemuMemory *memory, const BeemuRom *rom, uint8_t first_page, uint16_t bank);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BEEMU_DEVICE_ROM_H
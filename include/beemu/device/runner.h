@@ -0,0 +1,104 @@
+/**
+ * @file runner.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Run many independent devices at once on a work stealing thread pool.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_DEVICE_RUNNER_H
+#define BEEMU_DEVICE_RUNNER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "device.h"
+
+	/**
+	 * @brief A device and how long to run it for.
+	 *
+	 * Each job is run start to finish by a single thread, devices must not be
+	 * shared between jobs.
+	 */
+	typedef struct BeemuRunnerJob
+	{
+		BeemuDevice *device;
+		/** T-cycles to run the device for, see beemu_runner_frames_to_cycles. */
+		uint64_t cycle_budget;
+		/** T-cycles actually run, overshoots the budget by at most one instruction. */
+		uint64_t elapsed_cycles;
+		/** Wall clock time spent running the device, in seconds. */
+		double elapsed_seconds;
+	} BeemuRunnerJob;
+
+	/**
+	 * @brief Aggregate results of a beemu_runner_run call.
+	 */
+	typedef struct BeemuRunnerReport
+	{
+		/** T-cycles run by all devices together. */
+		uint64_t total_cycles;
+		/** Wall clock time it took to run every job, in seconds. */
+		double wall_seconds;
+		/** total_cycles over wall_seconds. */
+		double cycles_per_second;
+		/** Threads that ran jobs, including the calling thread. */
+		uint32_t thread_count;
+		/** Jobs a thread took from another thread's queue. */
+		uint64_t stolen_jobs;
+	} BeemuRunnerReport;
+
+	/**
+	 * @brief Convert a budget in frames to one in T-cycles.
+	 */
+	static inline uint64_t beemu_runner_frames_to_cycles(uint64_t frames)
+	{
+		return frames * BEEMU_DEVICE_CYCLES_PER_FRAME;
+	}
+
+	/**
+	 * @brief Get the number of hardware threads available to the process.
+	 *
+	 * @return uint32_t Hardware thread count, at least 1.
+	 */
+	uint32_t beemu_runner_hardware_thread_count(void);
+
+	/**
+	 * @brief Run every job to its budget, spread across a pool of threads.
+	 *
+	 * Jobs are dealt out to per-thread queues up front, a thread that runs out
+	 * of jobs steals from the back of another thread's queue, so uneven budgets
+	 * still keep every thread busy. The calling thread takes part and the call
+	 * returns once every job is finished. Threads share no mutable state other
+	 * than the queue indices, and each job's results are only written by the
+	 * thread that ran it.
+	 * @param jobs Jobs to run, their results are filled in.
+	 * @param job_count Number of jobs.
+	 * @param thread_count Threads to run the jobs on, 0 for one per hardware thread.
+	 * @param report Filled with the aggregate results, may be NULL.
+	 * @return true if every job ran, false if the pool could not be allocated.
+	 */
+	bool beemu_runner_run(BeemuRunnerJob *jobs, size_t job_count, uint32_t thread_count, BeemuRunnerReport *report);
+
+	/**
+	 * @brief Get the speed a job ran at.
+	 *
+	 * @param job A job beemu_runner_run has finished.
+	 * @return double T-cycles per second of wall clock time, 0 if the
+	 * job did not run.
+	 */
+	double beemu_runner_job_cycles_per_second(const BeemuRunnerJob *job);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BEEMU_DEVICE_RUNNER_H
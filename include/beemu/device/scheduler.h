@@ -0,0 +1,114 @@
+/**
+ * @file scheduler.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Min-heap of the absolute cycles at which components need attention.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_DEVICE_SCHEDULER_H
+#define BEEMU_DEVICE_SCHEDULER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+	/**
+	 * @brief Deadline of an event that is not scheduled.
+	 */
+#define BEEMU_SCHEDULER_NEVER UINT64_MAX
+
+	/**
+	 * @brief Things components schedule, each has at most one pending deadline.
+	 */
+	typedef enum BeemuEventType
+	{
+		BEEMU_EVENT_FRAME_END,
+		BEEMU_EVENT_PPU_MODE,
+		BEEMU_EVENT_TIMER_OVERFLOW,
+		BEEMU_EVENT_DMA_COMPLETE,
+		BEEMU_EVENT_SERIAL_TRANSFER,
+		BEEMU_EVENT_TYPE_COUNT
+	} BeemuEventType;
+
+	typedef struct BeemuScheduledEvent
+	{
+		/** Value of the device clock the event is due at. */
+		uint64_t deadline;
+		BeemuEventType type;
+	} BeemuScheduledEvent;
+
+	/**
+	 * @brief Binary min-heap of events, ordered by deadline and then by type
+	 * so that events due at the same cycle always fire in the same order.
+	 *
+	 * Each type's position in the heap is tracked, so moving or cancelling
+	 * an event, as register writes do, is O(log n).
+	 */
+	typedef struct BeemuScheduler
+	{
+		BeemuScheduledEvent heap[BEEMU_EVENT_TYPE_COUNT];
+		uint8_t size;
+		/** Index of each type in the heap, or -1 if it is not scheduled. */
+		int8_t positions[BEEMU_EVENT_TYPE_COUNT];
+	} BeemuScheduler;
+
+	/**
+	 * @brief Initialise an empty scheduler.
+	 */
+	void beemu_scheduler_init(BeemuScheduler *scheduler);
+
+	/**
+	 * @brief Schedule an event, moving it if it is already scheduled.
+	 *
+	 * @param scheduler Scheduler to act on.
+	 * @param type Event to schedule.
+	 * @param deadline Absolute cycle the event is due at.
+	 */
+	void beemu_scheduler_schedule(BeemuScheduler *scheduler, BeemuEventType type, uint64_t deadline);
+
+	/**
+	 * @brief Remove an event, does nothing if it is not scheduled.
+	 */
+	void beemu_scheduler_cancel(BeemuScheduler *scheduler, BeemuEventType type);
+
+	/**
+	 * @brief Remove the earliest event if it is due.
+	 *
+	 * @param scheduler Scheduler to act on.
+	 * @param now Current value of the device clock.
+	 * @param event Set to the removed event.
+	 * @return true if an event was due, false otherwise.
+	 */
+	bool beemu_scheduler_pop_due(BeemuScheduler *scheduler, uint64_t now, BeemuScheduledEvent *event);
+
+	/**
+	 * @brief Get the deadline of a single event.
+	 *
+	 * @return uint64_t Its deadline, or BEEMU_SCHEDULER_NEVER if it is not scheduled.
+	 */
+	uint64_t beemu_scheduler_deadline(const BeemuScheduler *scheduler, BeemuEventType type);
+
+	/**
+	 * @brief Get the deadline of the earliest event.
+	 *
+	 * The processor can run uninterrupted until this cycle.
+	 * @return uint64_t Earliest deadline, or BEEMU_SCHEDULER_NEVER if nothing is scheduled.
+	 */
+	static inline uint64_t beemu_scheduler_next_deadline(const BeemuScheduler *scheduler)
+	{
+		return scheduler->size > 0 ? scheduler->heap[0].deadline : BEEMU_SCHEDULER_NEVER;
+	}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BEEMU_DEVICE_SCHEDULER_H
@@ -0,0 +1,103 @@
+/**
+ * @file sprite_bins.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Sprites of OAM sorted into the lines they are drawn on, rebuilt as OAM is written.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_DEVICE_SPRITE_BINS_H
+#define BEEMU_DEVICE_SPRITE_BINS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "memory.h"
+
+	/**
+	 * @brief Lines sprites are drawn on.
+	 */
+#define BEEMU_SPRITE_BINS_LINE_COUNT 144
+	/**
+	 * @brief Sprites the hardware draws on a single line at most.
+	 */
+#define BEEMU_SPRITE_BINS_SPRITES_PER_LINE 10
+
+	typedef enum BeemuSpriteSize
+	{
+		BEEMU_SPRITE_SIZE_8_TO_8,
+		BEEMU_SPRITE_SIZE_8_TO_16
+	} BeemuSpriteSize;
+
+	/**
+	 * @brief Sprites selected for each line, as the OAM scan would select them.
+	 */
+	typedef struct BeemuSpriteBins
+	{
+		/** Addresses in OAM of the sprites on each line, in the order they are drawn. */
+		uint16_t sprites[BEEMU_SPRITE_BINS_LINE_COUNT][BEEMU_SPRITE_BINS_SPRITES_PER_LINE];
+		uint8_t counts[BEEMU_SPRITE_BINS_LINE_COUNT];
+		/** Size of the sprites the bins were sorted for. */
+		BeemuSpriteSize size;
+		/** OAM was written since the bins were sorted. */
+		bool dirty;
+		/** Times the bins were sorted, for diagnostics. */
+		uint64_t builds;
+	} BeemuSpriteBins;
+
+	/**
+	 * @brief Initialise the bins as dirty.
+	 */
+	void beemu_sprite_bins_init(BeemuSpriteBins *bins);
+
+	/**
+	 * @brief Sort the sprites of OAM into the bins and mark them clean.
+	 *
+	 * Each line takes the first 10 sprites in OAM that overlap it, ordered
+	 * by their X coordinate, ties going to the earlier one in OAM.
+	 * @param bins Bins to sort into.
+	 * @param memory Memory bus OAM is on.
+	 * @param size Size of the sprites, which decides the lines they overlap.
+	 */
+	void beemu_sprite_bins_build(BeemuSpriteBins *bins, BeemuMemory *memory, BeemuSpriteSize size);
+
+	/**
+	 * @brief Mark the bins as dirty, after OAM was written.
+	 */
+	static inline void beemu_sprite_bins_invalidate(BeemuSpriteBins *bins)
+	{
+		bins->dirty = true;
+	}
+
+	/**
+	 * @brief Get the sprites on a line, sorting the bins first if they are out of date.
+	 *
+	 * @param bins Bins to read from.
+	 * @param memory Memory bus OAM is on.
+	 * @param size Size of the sprites, changing it sorts the bins again.
+	 * @param line Line to get the sprites of, below BEEMU_SPRITE_BINS_LINE_COUNT.
+	 * @param count Set to the number of sprites on the line.
+	 * @return const uint16_t* Addresses in OAM of the sprites, in the order they are drawn.
+	 */
+	static inline const uint16_t *beemu_sprite_bins_line(BeemuSpriteBins *bins, BeemuMemory *memory, const BeemuSpriteSize size, const uint8_t line, int *count)
+	{
+		if (bins->dirty || bins->size != size)
+		{
+			beemu_sprite_bins_build(bins, memory, size);
+		}
+		*count = bins->counts[line];
+		return bins->sprites[line];
+	}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BEEMU_DEVICE_SPRITE_BINS_H
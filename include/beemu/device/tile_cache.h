@@ -0,0 +1,105 @@
+/**
+ * @file tile_cache.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Decoded tiles of VRAM, invalidated per tile as VRAM is written.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_DEVICE_TILE_CACHE_H
+#define BEEMU_DEVICE_TILE_CACHE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "memory.h"
+
+	/**
+	 * @brief Tiles in the tile data, 0x8000 to 0x9800, 16 bytes each.
+	 */
+#define BEEMU_TILE_CACHE_TILE_COUNT 384
+	/**
+	 * @brief Address of the first tile.
+	 */
+#define BEEMU_TILE_CACHE_TILE_DATA_ADDRESS 0x8000
+
+	/**
+	 * @brief Tiles decoded from their 2bpp planar rows to a colour index per pixel.
+	 */
+	typedef struct BeemuTileCache
+	{
+		/** Colour indices of each tile, by row and then by pixel, leftmost first. */
+		uint8_t tiles[BEEMU_TILE_CACHE_TILE_COUNT][8][8];
+		/** Tiles written since they were last decoded. */
+		bool dirty[BEEMU_TILE_CACHE_TILE_COUNT];
+		/** Rows served without decoding, for diagnostics. */
+		uint64_t hits;
+		/** Rows served after decoding their tile, for diagnostics. */
+		uint64_t misses;
+	} BeemuTileCache;
+
+	/**
+	 * @brief Initialise a cache with every tile dirty.
+	 */
+	void beemu_tile_cache_init(BeemuTileCache *cache);
+
+	/**
+	 * @brief Decode every row of a tile from memory and mark it clean.
+	 *
+	 * @param cache Cache to decode into.
+	 * @param memory Memory bus VRAM is on.
+	 * @param tile Index of the tile, from 0x8000.
+	 */
+	void beemu_tile_cache_decode(BeemuTileCache *cache, BeemuMemory *memory, uint16_t tile);
+
+	/**
+	 * @brief Mark the tile an address belongs to as dirty.
+	 *
+	 * @param cache Cache to invalidate.
+	 * @param address Address written, addresses outside the tile data are ignored.
+	 */
+	static inline void beemu_tile_cache_invalidate(BeemuTileCache *cache, const uint16_t address)
+	{
+		const uint16_t offset = address - BEEMU_TILE_CACHE_TILE_DATA_ADDRESS;
+		if (offset < BEEMU_TILE_CACHE_TILE_COUNT * 16)
+		{
+			cache->dirty[offset / 16] = true;
+		}
+	}
+
+	/**
+	 * @brief Get the colour indices of a row of a tile, decoding it if it is dirty.
+	 *
+	 * @param cache Cache to read from.
+	 * @param memory Memory bus VRAM is on.
+	 * @param tile_address Address of the tile.
+	 * @param row Row of the tile, below 8.
+	 * @return const uint8_t* 8 colour indices, leftmost first.
+	 */
+	static inline const uint8_t *beemu_tile_cache_row(BeemuTileCache *cache, BeemuMemory *memory, const uint16_t tile_address, const uint8_t row)
+	{
+		const uint16_t tile = (uint16_t)(tile_address - BEEMU_TILE_CACHE_TILE_DATA_ADDRESS) / 16;
+		if (cache->dirty[tile])
+		{
+			beemu_tile_cache_decode(cache, memory, tile);
+			cache->misses++;
+		}
+		else
+		{
+			cache->hits++;
+		}
+		return cache->tiles[tile][row];
+	}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BEEMU_DEVICE_TILE_CACHE_H
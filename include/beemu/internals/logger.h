@@ -8,6 +8,9 @@
 extern "C"
 {
 #endif
+	/**
+	 * @brief Severity of a log message, lower is more severe.
+	 */
 	typedef enum BeemuLogLevel
 	{
 		BEEMU_LOG_ERR,
@@ -15,9 +18,67 @@ extern "C"
 		BEEMU_LOG_INFO
 	} BeemuLogLevel;
 
+	/**
+	 * @brief Least severe level compiled in, BEEMU_LOG calls below it are
+	 * removed by the preprocessor and optimiser altogether.
+	 *
+	 * Set with -DBEEMU_LOG_COMPILED_LEVEL=<0-2>, defaults to warnings in
+	 * release builds and to everything otherwise.
+	 */
+#ifndef BEEMU_LOG_COMPILED_LEVEL
+#ifdef NDEBUG
+#define BEEMU_LOG_COMPILED_LEVEL BEEMU_LOG_WARN
+#else
+#define BEEMU_LOG_COMPILED_LEVEL BEEMU_LOG_INFO
+#endif
+#endif
+
+	/**
+	 * @brief Longest line beemu_log prints, longer messages are truncated.
+	 */
+#define BEEMU_LOG_LINE_LENGTH 512
+
+	/**
+	 * @brief Least severe level logged at runtime, defaults to warnings.
+	 *
+	 * Set it before any device starts running on another thread.
+	 */
+	extern BeemuLogLevel beemu_log_level;
+
+	/**
+	 * @brief Set the least severe level logged at runtime.
+	 *
+	 * Levels that are not compiled in stay disabled.
+	 * @param level New runtime level.
+	 */
+	void beemu_log_set_level(BeemuLogLevel level);
+
+	/**
+	 * @brief Check whether messages of a level are logged.
+	 *
+	 * Folds to false for levels that are not compiled in, otherwise costs
+	 * a single comparison against the runtime level.
+	 */
+#define BEEMU_LOG_IS_ENABLED(level) ((level) <= BEEMU_LOG_COMPILED_LEVEL && (level) <= beemu_log_level)
+
+	/**
+	 * @brief Log a message if its level is enabled.
+	 *
+	 * Arguments are only evaluated if the level is enabled, prefer this
+	 * over calling beemu_log directly.
+	 */
+#define BEEMU_LOG(level, ...)                    \
+	do {                                         \
+		if (BEEMU_LOG_IS_ENABLED(level)) {       \
+			beemu_log((level), __VA_ARGS__);     \
+		}                                        \
+	} while (0)
+
 	/**
 	 * @brief Log a message
 	 *
+	 * Formats unconditionally, use BEEMU_LOG to skip disabled levels. Safe
+	 * to call from several threads, each message is printed as one line.
 	 * @param level Level of the message being logged.
 	 * @param fmt Format of the message
 	 * @param ... Message args
@@ -0,0 +1,169 @@
+/**
+ * @file trace.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Binary trace logger that defers formatting to a consumer.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_INTERNALS_TRACE_H
+#define BEEMU_INTERNALS_TRACE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "logger.h"
+
+	/**
+	 * @brief Maximum number of arguments a single trace event carries.
+	 */
+#define BEEMU_TRACE_MAX_ARGS 4
+
+	/**
+	 * @brief Number of events each thread's ring buffer holds, events traced
+	 * while the ring is full are dropped.
+	 */
+#define BEEMU_TRACE_RING_CAPACITY 4096
+
+	/**
+	 * @brief A single unformatted trace event.
+	 *
+	 * The format string doubles as the event's ID, it is never copied so it
+	 * must be a string literal or otherwise outlive the trace.
+	 */
+	typedef struct BeemuTraceEvent
+	{
+		/** @brief Wall clock time of the event in nanoseconds. */
+		uint64_t timestamp;
+		/** @brief printf style format, only integer conversions are supported. */
+		const char *format;
+		/** @brief Raw arguments, converted to the format's types when formatted. */
+		uint64_t args[BEEMU_TRACE_MAX_ARGS];
+		/** @brief ID of the thread that traced the event, starting from 0. */
+		uint32_t thread_id;
+		uint8_t arg_count;
+		BeemuLogLevel level;
+	} BeemuTraceEvent;
+
+	/**
+	 * @brief Called once for every event consumed by beemu_trace_drain.
+	 */
+	typedef void (*BeemuTraceEventHandler)(void *context, const BeemuTraceEvent *event);
+
+	/**
+	 * @brief Binary trace file writer, see beemu_trace_writer_new.
+	 */
+	typedef struct BeemuTraceWriter BeemuTraceWriter;
+
+	/**
+	 * @brief Record an event into the calling thread's ring buffer.
+	 *
+	 * Does not format or lock, prefer BEEMU_TRACE which also checks the
+	 * log level before evaluating the arguments.
+	 *
+	 * @param level Level of the event.
+	 * @param format Format of the event, see BeemuTraceEvent.
+	 * @param args Raw arguments, only the first BEEMU_TRACE_MAX_ARGS are kept.
+	 * @param arg_count Number of arguments.
+	 */
+	void beemu_trace_record(BeemuLogLevel level, const char *format, const uint64_t *args, size_t arg_count);
+
+	/**
+	 * @brief Trace an event if its level is enabled.
+	 *
+	 * Takes the same levels as BEEMU_LOG, but the arguments must be integers,
+	 * they are stored raw and formatted later by the consumer.
+	 */
+#define BEEMU_TRACE(level, format, ...)                                                       \
+	do {                                                                                      \
+		if (BEEMU_LOG_IS_ENABLED(level)) {                                                    \
+			const uint64_t beemu_trace_args_[] = {0 __VA_OPT__(, ) __VA_ARGS__};              \
+			beemu_trace_record(                                                               \
+				(level),                                                                      \
+				(format),                                                                     \
+				beemu_trace_args_ + 1,                                                        \
+				sizeof(beemu_trace_args_) / sizeof(beemu_trace_args_[0]) - 1);                \
+		}                                                                                     \
+	} while (0)
+
+	/**
+	 * @brief Consume every pending event from every thread's ring buffer.
+	 *
+	 * Can run on a background thread while other threads trace, but only
+	 * one drain runs at a time, concurrent calls return 0 immediately.
+	 *
+	 * @param handler Called for each event in per-thread order.
+	 * @param context Passed to the handler.
+	 * @return size_t number of events consumed.
+	 */
+	size_t beemu_trace_drain(BeemuTraceEventHandler handler, void *context);
+
+	/**
+	 * @brief Number of events dropped because a ring buffer was full.
+	 */
+	uint64_t beemu_trace_dropped_count(void);
+
+	/**
+	 * @brief Format an event as beemu_log would have printed it.
+	 *
+	 * @param event Event to format.
+	 * @param buffer Buffer to write the null terminated message to.
+	 * @param size Size of the buffer.
+	 * @return size_t length of the message, which may exceed size if truncated.
+	 */
+	size_t beemu_trace_format_event(const BeemuTraceEvent *event, char *buffer, size_t size);
+
+	/**
+	 * @brief Create a writer that saves drained events to a binary file.
+	 *
+	 * Each format is written once, later events only refer to its ID.
+	 *
+	 * @param file File opened for binary writing, not owned by the writer.
+	 * @return BeemuTraceWriter* the writer, or NULL on failure.
+	 */
+	BeemuTraceWriter *beemu_trace_writer_new(FILE *file);
+
+	/**
+	 * @brief Drain pending events into the writer's file.
+	 *
+	 * Events whose format cannot be recorded are dropped.
+	 *
+	 * @return size_t number of events written.
+	 */
+	size_t beemu_trace_writer_flush(BeemuTraceWriter *writer);
+
+	/**
+	 * @brief Free the writer, does not close its file.
+	 *
+	 * @return true if every drained event was written.
+	 * @return false if events were dropped, see beemu_trace_writer_flush.
+	 */
+	bool beemu_trace_writer_free(BeemuTraceWriter *writer);
+
+	/**
+	 * @brief Decode a binary trace file written by a BeemuTraceWriter.
+	 *
+	 * Trace files are in host byte order, decode them on a machine with the
+	 * same endianness.
+	 *
+	 * @param input Binary trace file.
+	 * @param output Stream to print formatted events to.
+	 * @return true if the whole file was decoded.
+	 * @return false if the file is not a valid trace.
+	 */
+	bool beemu_trace_decode(FILE *input, FILE *output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BEEMU_INTERNALS_TRACE_H
@@ -1,9 +1,39 @@
 #include <stdio.h>
+#include <string.h>
 #include <beemu/device/processor/processor.h>
+#include <beemu/internals/trace.h>
 #include <version.h>
 
-int main()
+/**
+ * @brief Decode a binary trace file to stdout.
+ *
+ * @param path Path of the trace file.
+ * @return int exit code.
+ */
+int decode_trace(const char *path)
 {
+	FILE *trace = fopen(path, "rb");
+	if (trace == NULL)
+	{
+		fprintf(stderr, "Could not open trace file %s\n", path);
+		return 1;
+	}
+	const bool decoded = beemu_trace_decode(trace, stdout);
+	fclose(trace);
+	if (!decoded)
+	{
+		fprintf(stderr, "%s is not a valid trace file\n", path);
+		return 1;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc == 3 && strcmp(argv[1], "--decode-trace") == 0)
+	{
+		return decode_trace(argv[2]);
+	}
 	BeemuProcessor *processor = beemu_processor_new();
 	printf("%s, V%d.%d\n", "Welcome to Beemu 🐝", Beemu_VERSION_MAJOR, Beemu_VERSION_MINOR);
 }
@@ -1,23 +1,278 @@
 #include <beemu/device/device.h>
 #include <beemu/device/processor/processor.h>
+#include <beemu/internals/trace.h>
 #include <stdlib.h>
 
+/**
+ * @brief Count the frame and schedule the end of the next one.
+ */
+static void beemu_device_handle_frame_end(BeemuDevice *device, const uint64_t deadline)
+{
+	device->frame_count++;
+	beemu_scheduler_schedule(&device->scheduler, BEEMU_EVENT_FRAME_END, deadline + BEEMU_DEVICE_CYCLES_PER_FRAME);
+}
+
+/**
+ * @brief Catch the display up with the clock and schedule its next mode.
+ */
+static void beemu_device_handle_ppu_mode(BeemuDevice *device, const uint64_t deadline)
+{
+	beemu_clock_sync(&device->clock, BEEMU_CLOCK_COMPONENT_PPU);
+	beemu_scheduler_schedule(&device->scheduler, BEEMU_EVENT_PPU_MODE, deadline + beemu_display_advance(device->display));
+}
+
+/**
+ * @brief Copy the sprites once an OAM DMA completes.
+ *
+ * The whole transfer lands at once, through the bus so that the display
+ * invalidates its sprite bins.
+ */
+static void beemu_device_handle_dma_complete(BeemuDevice *device, uint64_t)
+{
+	BeemuMemory *memory = device->processor->memory;
+	for (uint16_t i = 0; i < BEEMU_DISPLAY_SPRITE_COUNT * 4; i++)
+	{
+		beemu_memory_write(memory, BEEMU_DISPLAY_OAM_ADDRESS + i, beemu_memory_read(memory, device->dma_source + i));
+	}
+}
+
+/**
+ * @brief Read the IO page through the handler it had before the device.
+ */
+static uint8_t beemu_device_read_io(void *context, const uint16_t address)
+{
+	BeemuDevice *device = (BeemuDevice *)context;
+	return device->io_handler.read ? device->io_handler.read(device->io_handler.context, address) : 0xFF;
+}
+
+/**
+ * @brief Write to the IO page, and start an OAM DMA if it was its register.
+ */
+static void beemu_device_write_io(void *context, const uint16_t address, const uint8_t value)
+{
+	BeemuDevice *device = (BeemuDevice *)context;
+	if (device->io_page)
+	{
+		device->io_page[address % BEEMU_MEMORY_PAGE_SIZE] = value;
+	}
+	else if (device->io_handler.write)
+	{
+		device->io_handler.write(device->io_handler.context, address, value);
+	}
+	if (address == BEEMU_DISPLAY_DMA_ADDRESS)
+	{
+		// Writing again restarts the transfer.
+		device->dma_source = value << 8;
+		beemu_scheduler_schedule(&device->scheduler, BEEMU_EVENT_DMA_COMPLETE, device->clock.now + BEEMU_DEVICE_DMA_CYCLES);
+	}
+}
+
 BeemuDevice *beemu_device_new()
+{
+	return beemu_device_new_with_renderer(BEEMU_DISPLAY_RENDERER_SCANLINE);
+}
+
+BeemuDevice *beemu_device_new_with_renderer(const BeemuDisplayRenderer renderer)
 {
 	BeemuProcessor *processor = beemu_processor_new();
 	BeemuDevice *device = (BeemuDevice *)malloc(sizeof(BeemuDevice));
 	device->processor = processor;
+	device->display = beemu_display_new_with_renderer(processor->memory, renderer);
+	beemu_clock_init(&device->clock);
+	beemu_scheduler_init(&device->scheduler);
+	for (int type = 0; type < BEEMU_EVENT_TYPE_COUNT; type++)
+	{
+		device->event_handlers[type] = NULL;
+	}
+	device->event_handlers[BEEMU_EVENT_FRAME_END] = beemu_device_handle_frame_end;
+	beemu_scheduler_schedule(&device->scheduler, BEEMU_EVENT_FRAME_END, BEEMU_DEVICE_CYCLES_PER_FRAME);
+	device->event_handlers[BEEMU_EVENT_PPU_MODE] = beemu_device_handle_ppu_mode;
+	// The display starts at the end of the last frame.
+	beemu_scheduler_schedule(&device->scheduler, BEEMU_EVENT_PPU_MODE, 0);
+	device->event_handlers[BEEMU_EVENT_DMA_COMPLETE] = beemu_device_handle_dma_complete;
+	device->frame_count = 0;
+	beemu_idle_loop_init(&device->idle_loop);
+	// Reads stay on the page, writes fall back to the device.
+	BeemuMemory *memory = processor->memory;
+	const uint8_t io_page = BEEMU_DISPLAY_DMA_ADDRESS / BEEMU_MEMORY_PAGE_SIZE;
+	device->io_page = memory->write_pages[io_page];
+	device->io_handler = memory->handlers[io_page];
+	memory->write_pages[io_page] = 0;
+	const BeemuMemoryHandler io_handler = {.read = beemu_device_read_io, .write = beemu_device_write_io, .context = device};
+	memory->handlers[io_page] = io_handler;
+	device->dma_source = 0;
 	return device;
 }
 
 void beemu_device_free(BeemuDevice *device)
 {
+	// The device and the display hand the memory back, so they go first.
+	const uint8_t io_page = BEEMU_DISPLAY_DMA_ADDRESS / BEEMU_MEMORY_PAGE_SIZE;
+	device->processor->memory->write_pages[io_page] = device->io_page;
+	device->processor->memory->handlers[io_page] = device->io_handler;
+	beemu_display_free(device->display);
+	device->display = 0;
 	beemu_processor_free(device->processor);
 	device->processor = 0;
 	free(device);
 }
 
-void beemu_device_run(BeemuDevice *device)
+/**
+ * @brief Run a single instruction and advance the clock by its cycles.
+ *
+ * @return uint32_t T-cycles the instruction took.
+ */
+static inline uint32_t beemu_device_step(BeemuDevice *device)
+{
+	const uint32_t cycles = beemu_processor_run(device->processor) * BEEMU_DEVICE_T_CYCLES_PER_M_CYCLE;
+	beemu_clock_advance(&device->clock, cycles);
+	return cycles;
+}
+
+void beemu_device_set_event_handler(BeemuDevice *device, const BeemuEventType type, const BeemuEventHandler handler)
+{
+	if (type == BEEMU_EVENT_FRAME_END || type == BEEMU_EVENT_PPU_MODE || type == BEEMU_EVENT_DMA_COMPLETE)
+	{
+		return;
+	}
+	device->event_handlers[type] = handler;
+}
+
+void beemu_device_set_idle_loop_skipping(BeemuDevice *device, const bool enabled)
+{
+	device->idle_loop.enabled = enabled;
+	device->idle_loop.has_snapshot = false;
+}
+
+/**
+ * @brief Fire every event that is due, in deadline order.
+ */
+static void beemu_device_dispatch_events(BeemuDevice *device)
+{
+	BeemuScheduledEvent event;
+	while (beemu_scheduler_pop_due(&device->scheduler, device->clock.now, &event))
+	{
+		// Traced rather than logged, formatting here would skew the timing.
+		BEEMU_TRACE(BEEMU_LOG_INFO, "Event %u due at %llu fired at %llu", event.type, event.deadline, device->clock.now);
+		const BeemuEventHandler handler = device->event_handlers[event.type];
+		if (handler != NULL)
+		{
+			handler(device, event.deadline);
+		}
+	}
+	// Handlers may change what an idle loop polls, even in the middle of
+	// an iteration that matches the previous one.
+	device->idle_loop.has_snapshot = false;
+}
+
+/**
+ * @brief Skip the clock ahead to a cycle, in whole machine cycles.
+ *
+ * Used while the processor is halted, nothing but an event firing can
+ * wake it up before then.
+ */
+static inline void beemu_device_fast_forward(BeemuDevice *device, const uint64_t cycle)
+{
+	const uint64_t m_cycles = (cycle - device->clock.now + BEEMU_DEVICE_T_CYCLES_PER_M_CYCLE - 1) / BEEMU_DEVICE_T_CYCLES_PER_M_CYCLE;
+	device->clock.now += m_cycles * BEEMU_DEVICE_T_CYCLES_PER_M_CYCLE;
+}
+
+/**
+ * @brief Skip whole iterations of an idle loop that end before a cycle.
+ *
+ * The processor is at the head of the loop, and stays there with the same
+ * registers, so only the clock moves.
+ * @param iteration_cycles T-cycles a single iteration takes.
+ */
+static inline void beemu_device_skip_idle_loop(BeemuDevice *device, const uint64_t iteration_cycles, const uint64_t cycle)
+{
+	if (device->clock.now >= cycle || beemu_processor_interrupt_pending(device->processor))
+	{
+		return;
+	}
+	const uint64_t skipped = (cycle - device->clock.now) / iteration_cycles * iteration_cycles;
+	if (skipped == 0)
+	{
+		return;
+	}
+	device->clock.now += skipped;
+	device->idle_loop.snapshot_at += skipped;
+	device->idle_loop.skipped_cycles += skipped;
+}
+
+/**
+ * @brief Run whole instructions up to a cycle, then fire the events due.
+ *
+ * The processor is only interrupted by the scheduler when the earliest
+ * deadline comes before the cycle. A halted processor skips straight to it,
+ * as does an idle loop when skipping them is enabled.
+ */
+static inline void beemu_device_run_to(BeemuDevice *device, const uint64_t cycle)
+{
+	const uint64_t next_deadline = beemu_scheduler_next_deadline(&device->scheduler);
+	const uint64_t stop_at = next_deadline < cycle ? next_deadline : cycle;
+	while (device->clock.now < stop_at)
+	{
+		if (beemu_processor_is_halted(device->processor) && !beemu_processor_interrupt_pending(device->processor))
+		{
+			beemu_device_fast_forward(device, stop_at);
+			break;
+		}
+		const uint16_t pc = device->processor->registers->program_counter;
+		beemu_device_step(device);
+		if (device->idle_loop.enabled && device->processor->registers->program_counter <= pc)
+		{
+			const uint64_t iteration_cycles = beemu_idle_loop_observe(&device->idle_loop, device->processor, pc, device->clock.now);
+			if (iteration_cycles != 0)
+			{
+				beemu_device_skip_idle_loop(device, iteration_cycles, stop_at);
+			}
+		}
+	}
+	if (device->clock.now >= next_deadline)
+	{
+		beemu_device_dispatch_events(device);
+	}
+}
+
+uint32_t beemu_device_run(BeemuDevice *device)
+{
+	const uint32_t cycles = beemu_device_step(device);
+	if (device->clock.now >= beemu_scheduler_next_deadline(&device->scheduler))
+	{
+		beemu_device_dispatch_events(device);
+	}
+	return cycles;
+}
+
+uint64_t beemu_device_run_cycles(BeemuDevice *device, const uint64_t cycles)
+{
+	const uint64_t started_at = device->clock.now;
+	const uint64_t target = started_at + cycles;
+	while (device->clock.now < target)
+	{
+		beemu_device_run_to(device, target);
+	}
+	return device->clock.now - started_at;
+}
+
+uint64_t beemu_device_run_until_frame(BeemuDevice *device)
+{
+	const uint64_t started_at = device->clock.now;
+	const uint64_t frame = device->frame_count;
+	while (device->frame_count == frame)
+	{
+		beemu_device_run_to(device, BEEMU_SCHEDULER_NEVER);
+	}
+	return device->clock.now - started_at;
+}
+
+uint64_t beemu_device_run_until(BeemuDevice *device, const BeemuDeviceStopPredicate predicate, void *context)
 {
-	const uint8_t elapsed_cycle = beemu_processor_run(device->processor);
+	const uint64_t started_at = device->clock.now;
+	while (!predicate(device, context))
+	{
+		beemu_device_run(device);
+	}
+	return device->clock.now - started_at;
 }
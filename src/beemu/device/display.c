@@ -0,0 +1,433 @@
+/**
+ * @file display.c
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Display timing, and the scanline renderer for the background, window and sprites.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <beemu/device/display.h>
+#include <beemu/device/pixel_kernels.h>
+#include <beemu/device/processor/processor.h>
+#include <stdlib.h>
+#include <string.h>
+#include "display_common.h"
+#include "pixel_fifo.h"
+
+/**
+ * @brief Sources of the STAT interrupt, by their bit in STAT.
+ */
+#define BEEMU_DISPLAY_STAT_COINCIDENCE 0x04
+#define BEEMU_DISPLAY_STAT_HBLANK_SOURCE 0x08
+#define BEEMU_DISPLAY_STAT_VBLANK_SOURCE 0x10
+#define BEEMU_DISPLAY_STAT_OAM_SOURCE 0x20
+#define BEEMU_DISPLAY_STAT_COINCIDENCE_SOURCE 0x40
+
+/**
+ * @brief Read from a tile data page without storage, as the page did before.
+ */
+static uint8_t beemu_display_read_tile_data(void *context, const uint16_t address)
+{
+	BeemuDisplay *display = (BeemuDisplay *)context;
+	const BeemuMemoryHandler *handler = &display->tile_data_handlers[(address - BEEMU_TILE_CACHE_TILE_DATA_ADDRESS) / BEEMU_MEMORY_PAGE_SIZE];
+	return handler->read ? handler->read(handler->context, address) : 0xFF;
+}
+
+/**
+ * @brief Write to the tile data, and invalidate the tile written.
+ */
+static void beemu_display_write_tile_data(void *context, const uint16_t address, const uint8_t value)
+{
+	BeemuDisplay *display = (BeemuDisplay *)context;
+	const uint16_t page = (address - BEEMU_TILE_CACHE_TILE_DATA_ADDRESS) / BEEMU_MEMORY_PAGE_SIZE;
+	if (display->tile_data_pages[page])
+	{
+		display->tile_data_pages[page][address % BEEMU_MEMORY_PAGE_SIZE] = value;
+	}
+	else if (display->tile_data_handlers[page].write)
+	{
+		display->tile_data_handlers[page].write(display->tile_data_handlers[page].context, address, value);
+	}
+	beemu_tile_cache_invalidate(&display->tile_cache, address);
+}
+
+/**
+ * @brief Read from the OAM page without storage, as the page did before.
+ */
+static uint8_t beemu_display_read_oam(void *context, const uint16_t address)
+{
+	BeemuDisplay *display = (BeemuDisplay *)context;
+	return display->oam_handler.read ? display->oam_handler.read(display->oam_handler.context, address) : 0xFF;
+}
+
+/**
+ * @brief Write to the OAM page, and invalidate the sprite bins if it was a sprite.
+ */
+static void beemu_display_write_oam(void *context, const uint16_t address, const uint8_t value)
+{
+	BeemuDisplay *display = (BeemuDisplay *)context;
+	if (display->oam_page)
+	{
+		display->oam_page[address % BEEMU_MEMORY_PAGE_SIZE] = value;
+	}
+	else if (display->oam_handler.write)
+	{
+		display->oam_handler.write(display->oam_handler.context, address, value);
+	}
+	// The rest of the page is unusable, and not part of any sprite.
+	if ((uint16_t)(address - BEEMU_DISPLAY_OAM_ADDRESS) < BEEMU_DISPLAY_SPRITE_COUNT * 4)
+	{
+		beemu_sprite_bins_invalidate(&display->sprite_bins);
+	}
+}
+
+BeemuDisplay *beemu_display_new(BeemuMemory *memory)
+{
+	return beemu_display_new_with_renderer(memory, BEEMU_DISPLAY_RENDERER_SCANLINE);
+}
+
+BeemuDisplay *beemu_display_new_with_renderer(BeemuMemory *memory, const BeemuDisplayRenderer renderer)
+{
+	BeemuDisplay *display = (BeemuDisplay *)malloc(sizeof(BeemuDisplay));
+	display->memory = memory;
+	display->renderer = renderer;
+	display->fifo = renderer == BEEMU_DISPLAY_RENDERER_PIXEL_FIFO ? beemu_pixel_fifo_new() : NULL;
+	beemu_tile_cache_init(&display->tile_cache);
+	beemu_sprite_bins_init(&display->sprite_bins);
+	// Reads stay on the pages, writes fall back to the display.
+	const uint8_t first_page = BEEMU_TILE_CACHE_TILE_DATA_ADDRESS / BEEMU_MEMORY_PAGE_SIZE;
+	const BeemuMemoryHandler handler = {.read = beemu_display_read_tile_data, .write = beemu_display_write_tile_data, .context = display};
+	for (int i = 0; i < BEEMU_DISPLAY_TILE_DATA_PAGE_COUNT; i++)
+	{
+		display->tile_data_pages[i] = memory->write_pages[first_page + i];
+		display->tile_data_handlers[i] = memory->handlers[first_page + i];
+		memory->write_pages[first_page + i] = 0;
+		memory->handlers[first_page + i] = handler;
+	}
+	const uint8_t oam_page = BEEMU_DISPLAY_OAM_ADDRESS / BEEMU_MEMORY_PAGE_SIZE;
+	display->oam_page = memory->write_pages[oam_page];
+	display->oam_handler = memory->handlers[oam_page];
+	memory->write_pages[oam_page] = 0;
+	const BeemuMemoryHandler oam_handler = {.read = beemu_display_read_oam, .write = beemu_display_write_oam, .context = display};
+	memory->handlers[oam_page] = oam_handler;
+	display->mode = BEEMU_DISPLAY_MODE_VBLANK;
+	display->line = BEEMU_DISPLAY_LINE_COUNT - 1;
+	display->window_line = 0;
+	display->lcd_on = false;
+	memset(display->framebuffer, 0, sizeof(display->framebuffer));
+	return display;
+}
+
+void beemu_display_free(BeemuDisplay *display)
+{
+	// Hand the tile data and OAM pages back, the memory may outlive the display.
+	const uint8_t first_page = BEEMU_TILE_CACHE_TILE_DATA_ADDRESS / BEEMU_MEMORY_PAGE_SIZE;
+	for (int i = 0; i < BEEMU_DISPLAY_TILE_DATA_PAGE_COUNT; i++)
+	{
+		display->memory->write_pages[first_page + i] = display->tile_data_pages[i];
+		display->memory->handlers[first_page + i] = display->tile_data_handlers[i];
+	}
+	const uint8_t oam_page = BEEMU_DISPLAY_OAM_ADDRESS / BEEMU_MEMORY_PAGE_SIZE;
+	display->memory->write_pages[oam_page] = display->oam_page;
+	display->memory->handlers[oam_page] = display->oam_handler;
+	if (display->fifo)
+	{
+		beemu_pixel_fifo_free(display->fifo);
+	}
+	free(display);
+}
+
+/**
+ * @brief Get the memory block selected by a bit of LCDC.
+ */
+static inline BeemuMemoryBlock beemu_display_select_block(const uint8_t lcdc, const uint8_t bit, const uint16_t unset_start, const uint16_t set_start, const uint16_t size)
+{
+	const uint16_t start = (lcdc & bit) ? set_start : unset_start;
+	const BeemuMemoryBlock block = {.start = start, .stop = start + size};
+	return block;
+}
+
+void beemu_display_read_state(BeemuMemory *memory, BeemuDisplayState *state)
+{
+	const uint8_t lcdc = beemu_memory_read(memory, BEEMU_DISPLAY_LCDC_ADDRESS);
+	state->lcdc_register.operation = (lcdc & 0x80) ? BEEMU_LCDC_OPERATION_CONTROL : BEEMU_LCDC_OPERATION_STOP;
+	state->lcdc_register.window_tile_map_display_select = beemu_display_select_block(lcdc, 0x40, 0x9800, 0x9C00, 0x400);
+	state->lcdc_register.window_display_on = lcdc & 0x20;
+	state->lcdc_register.bg_window_tile_data_select = beemu_display_select_block(lcdc, 0x10, 0x8800, 0x8000, 0x1000);
+	state->lcdc_register.bg_tile_map_display_select = beemu_display_select_block(lcdc, 0x08, 0x9800, 0x9C00, 0x400);
+	state->lcdc_register.sprite_size = (lcdc & 0x04) ? BEEMU_SPRITE_SIZE_8_TO_16 : BEEMU_SPRITE_SIZE_8_TO_8;
+	state->lcdc_register.sprite_display_on = lcdc & 0x02;
+	state->lcdc_register.bg_and_window_display_on = lcdc & 0x01;
+	state->scroll_y = beemu_memory_read(memory, BEEMU_DISPLAY_SCY_ADDRESS);
+	state->scroll_x = beemu_memory_read(memory, BEEMU_DISPLAY_SCX_ADDRESS);
+	state->lcdc_y = beemu_memory_read(memory, BEEMU_DISPLAY_LY_ADDRESS);
+	state->lcdc_y_compare = beemu_memory_read(memory, BEEMU_DISPLAY_LYC_ADDRESS);
+	state->dma_address = beemu_memory_read(memory, BEEMU_DISPLAY_DMA_ADDRESS);
+	state->bg_palette = beemu_memory_read(memory, BEEMU_DISPLAY_BGP_ADDRESS);
+	state->sprite_palettes[0] = beemu_memory_read(memory, BEEMU_DISPLAY_OBP0_ADDRESS);
+	state->sprite_palettes[1] = beemu_memory_read(memory, BEEMU_DISPLAY_OBP1_ADDRESS);
+	state->window_y = beemu_memory_read(memory, BEEMU_DISPLAY_WY_ADDRESS);
+	state->window_x = beemu_memory_read(memory, BEEMU_DISPLAY_WX_ADDRESS);
+}
+
+/**
+ * @brief Decode consecutive tiles of a row of a tile map.
+ *
+ * @param map_row Address of the first tile of the row in the tile map.
+ * @param first_tile Column of the first tile to decode, wraps around 32.
+ * @param tile_count Number of tiles to decode.
+ * @param row Row of the tiles to decode.
+ * @param indices Indices to write to, 8 per tile.
+ */
+static void beemu_display_decode_map_row(BeemuDisplay *display, const BeemuDisplayState *state, const uint16_t map_row, const uint8_t first_tile, const int tile_count, const uint8_t row, uint8_t *indices)
+{
+	for (int i = 0; i < tile_count; i++)
+	{
+		const uint8_t tile = beemu_memory_read(display->memory, map_row + ((first_tile + i) & 31));
+		memcpy(indices + i * 8, beemu_tile_cache_row(&display->tile_cache, display->memory, beemu_display_bg_tile_address(state->lcdc_register.bg_window_tile_data_select.start, tile), row), 8);
+	}
+}
+
+/**
+ * @brief Draw the background and the window of a line.
+ *
+ * @param indices Colour indices of the line, written for the sprites to
+ * check their priority against.
+ */
+static void beemu_display_render_bg_line(BeemuDisplay *display, const BeemuDisplayState *state, const uint8_t line, uint8_t *indices)
+{
+	const BeemuDisplayLCDC *lcdc = &state->lcdc_register;
+	if (!lcdc->bg_and_window_display_on)
+	{
+		memset(indices, 0, BEEMU_DISPLAY_WIDTH);
+		return;
+	}
+	// 21 tiles cover the line for any fine scroll.
+	uint8_t tiles[(BEEMU_DISPLAY_WIDTH / 8 + 1) * 8];
+	const uint8_t y = state->scroll_y + line;
+	const uint16_t map_row = lcdc->bg_tile_map_display_select.start + (y / 8) * 32;
+	beemu_display_decode_map_row(display, state, map_row, state->scroll_x / 8, BEEMU_DISPLAY_WIDTH / 8 + 1, y % 8, tiles);
+	memcpy(indices, tiles + state->scroll_x % 8, BEEMU_DISPLAY_WIDTH);
+	// WX is offset by 7, and values past the right edge hide the window.
+	if (!lcdc->window_display_on || line < state->window_y || state->window_x >= BEEMU_DISPLAY_WIDTH + 7)
+	{
+		return;
+	}
+	const int window_start = state->window_x - 7;
+	const int skipped = window_start < 0 ? -window_start : 0;
+	const int first_pixel = window_start < 0 ? 0 : window_start;
+	const uint16_t window_row = lcdc->window_tile_map_display_select.start + (display->window_line / 8) * 32;
+	beemu_display_decode_map_row(display, state, window_row, 0, BEEMU_DISPLAY_WIDTH / 8 + 1, display->window_line % 8, tiles);
+	memcpy(indices + first_pixel, tiles + skipped, BEEMU_DISPLAY_WIDTH - first_pixel);
+	display->window_line++;
+}
+
+/**
+ * @brief Draw the sprites of a line over the background.
+ *
+ * Sprites are drawn from the highest priority down, the first opaque pixel
+ * at a position wins it even if it is then hidden behind the background.
+ */
+static void beemu_display_render_sprite_line(BeemuDisplay *display, const BeemuDisplayState *state, const uint8_t line, const uint8_t *bg_indices)
+{
+	const uint8_t height = state->lcdc_register.sprite_size == BEEMU_SPRITE_SIZE_8_TO_16 ? 16 : 8;
+	int count;
+	const uint16_t *sprites = beemu_sprite_bins_line(&display->sprite_bins, display->memory, state->lcdc_register.sprite_size, line, &count);
+	bool taken[BEEMU_DISPLAY_WIDTH] = {false};
+	uint8_t *shades = display->framebuffer[line];
+	for (int i = 0; i < count; i++)
+	{
+		const uint16_t sprite = sprites[i];
+		const uint8_t flags = beemu_memory_read(display->memory, sprite + 3);
+		uint8_t tile = beemu_memory_read(display->memory, sprite + 2);
+		uint8_t row = line + 16 - beemu_memory_read(display->memory, sprite);
+		if (height == 16)
+		{
+			tile &= 0xFE;
+		}
+		if (flags & BEEMU_SPRITE_FLAG_Y_FLIP)
+		{
+			row = height - 1 - row;
+		}
+		// Tall sprites continue into the next tile.
+		const uint8_t *indices = beemu_tile_cache_row(&display->tile_cache, display->memory, BEEMU_DISPLAY_VRAM_ADDRESS + (tile + row / 8) * 16, row % 8);
+		const uint8_t palette = state->sprite_palettes[(flags & BEEMU_SPRITE_FLAG_PALETTE) ? 1 : 0];
+		const int left = beemu_memory_read(display->memory, sprite + 1) - 8;
+		for (int pixel = 0; pixel < 8; pixel++)
+		{
+			const int x = left + pixel;
+			const uint8_t index = indices[(flags & BEEMU_SPRITE_FLAG_X_FLIP) ? 7 - pixel : pixel];
+			if (x < 0 || x >= BEEMU_DISPLAY_WIDTH || index == 0 || taken[x])
+			{
+				continue;
+			}
+			taken[x] = true;
+			if (!(flags & BEEMU_SPRITE_FLAG_BEHIND_BG) || bg_indices[x] == 0)
+			{
+				shades[x] = (palette >> (index * 2)) & 3;
+			}
+		}
+	}
+}
+
+void beemu_display_render_line(BeemuDisplay *display, const uint8_t line)
+{
+	BeemuDisplayState state;
+	beemu_display_read_state(display->memory, &state);
+	uint8_t indices[BEEMU_DISPLAY_WIDTH];
+	beemu_display_render_bg_line(display, &state, line, indices);
+	uint8_t *shades = display->framebuffer[line];
+	for (int x = 0; x < BEEMU_DISPLAY_WIDTH; x++)
+	{
+		shades[x] = (state.bg_palette >> (indices[x] * 2)) & 3;
+	}
+	if (state.lcdc_register.sprite_display_on)
+	{
+		beemu_display_render_sprite_line(display, &state, line, indices);
+	}
+}
+
+/**
+ * @brief Palette mapping every shade to itself, the framebuffer holds shades.
+ */
+#define BEEMU_DISPLAY_IDENTITY_PALETTE 0xE4
+
+void beemu_display_export_32(const BeemuDisplay *display, const uint32_t colours[4], uint32_t *pixels)
+{
+	beemu_pixel_kernels_get()->expand_32(display->framebuffer[0], BEEMU_DISPLAY_WIDTH * BEEMU_DISPLAY_HEIGHT, BEEMU_DISPLAY_IDENTITY_PALETTE, colours, pixels);
+}
+
+void beemu_display_export_16(const BeemuDisplay *display, const uint16_t colours[4], uint16_t *pixels)
+{
+	beemu_pixel_kernels_get()->expand_16(display->framebuffer[0], BEEMU_DISPLAY_WIDTH * BEEMU_DISPLAY_HEIGHT, BEEMU_DISPLAY_IDENTITY_PALETTE, colours, pixels);
+}
+
+/**
+ * @brief Request an interrupt by setting its bit in IF.
+ */
+static inline void beemu_display_request_interrupt(BeemuDisplay *display, const BeemuInterrupt interrupt)
+{
+	const uint8_t requested = beemu_memory_read(display->memory, BEEMU_PROCESSOR_INTERRUPT_FLAG_ADDRESS);
+	beemu_memory_write(display->memory, BEEMU_PROCESSOR_INTERRUPT_FLAG_ADDRESS, requested | (1 << interrupt));
+}
+
+/**
+ * @brief Enter a mode, and request the STAT interrupt if it is a source.
+ *
+ * @param source Bit of STAT that enables the interrupt for the mode.
+ */
+static inline void beemu_display_set_mode(BeemuDisplay *display, const BeemuDisplayMode mode, const uint8_t source)
+{
+	display->mode = mode;
+	const uint8_t stat = beemu_memory_read(display->memory, BEEMU_DISPLAY_STAT_ADDRESS);
+	beemu_memory_write(display->memory, BEEMU_DISPLAY_STAT_ADDRESS, (stat & ~0x03) | mode);
+	if (stat & source)
+	{
+		beemu_display_request_interrupt(display, BEEMU_INTERRUPT_LCD_STAT);
+	}
+}
+
+/**
+ * @brief Move to a line, and compare it against LYC.
+ */
+static inline void beemu_display_set_line(BeemuDisplay *display, const uint8_t line)
+{
+	display->line = line;
+	beemu_memory_write(display->memory, BEEMU_DISPLAY_LY_ADDRESS, line);
+	const bool coincidence = line == beemu_memory_read(display->memory, BEEMU_DISPLAY_LYC_ADDRESS);
+	const uint8_t stat = beemu_memory_read(display->memory, BEEMU_DISPLAY_STAT_ADDRESS);
+	beemu_memory_write(display->memory, BEEMU_DISPLAY_STAT_ADDRESS, (stat & ~BEEMU_DISPLAY_STAT_COINCIDENCE) | (coincidence ? BEEMU_DISPLAY_STAT_COINCIDENCE : 0));
+	if (coincidence && (stat & BEEMU_DISPLAY_STAT_COINCIDENCE_SOURCE))
+	{
+		beemu_display_request_interrupt(display, BEEMU_INTERRUPT_LCD_STAT);
+	}
+}
+
+/**
+ * @brief Get the T-cycles from the start of the frame to the end of the current mode.
+ */
+static inline uint32_t beemu_display_mode_ends_at(const BeemuDisplay *display)
+{
+	const uint32_t line_starts_at = display->line * BEEMU_DISPLAY_CYCLES_PER_LINE;
+	switch (display->mode)
+	{
+	case BEEMU_DISPLAY_MODE_OAM_SCAN:
+		return line_starts_at + BEEMU_DISPLAY_OAM_SCAN_CYCLES;
+	case BEEMU_DISPLAY_MODE_DRAWING:
+		if (display->fifo)
+		{
+			return line_starts_at + BEEMU_DISPLAY_OAM_SCAN_CYCLES + display->fifo->dots + BEEMU_PIXEL_FIFO_STEP_DOTS;
+		}
+		return line_starts_at + BEEMU_DISPLAY_OAM_SCAN_CYCLES + BEEMU_DISPLAY_DRAWING_CYCLES;
+	default:
+		return line_starts_at + BEEMU_DISPLAY_CYCLES_PER_LINE;
+	}
+}
+
+uint32_t beemu_display_advance(BeemuDisplay *display)
+{
+	const uint32_t frame_cycles = BEEMU_DISPLAY_LINE_COUNT * BEEMU_DISPLAY_CYCLES_PER_LINE;
+	if (!(beemu_memory_read(display->memory, BEEMU_DISPLAY_LCDC_ADDRESS) & 0x80))
+	{
+		const uint32_t remaining = frame_cycles - beemu_display_mode_ends_at(display);
+		if (display->lcd_on)
+		{
+			display->lcd_on = false;
+			beemu_memory_write(display->memory, BEEMU_DISPLAY_LY_ADDRESS, 0);
+			const uint8_t stat = beemu_memory_read(display->memory, BEEMU_DISPLAY_STAT_ADDRESS);
+			beemu_memory_write(display->memory, BEEMU_DISPLAY_STAT_ADDRESS, stat & ~0x03);
+		}
+		// Wait at the end of the frame, the next one starts with line 0.
+		display->line = BEEMU_DISPLAY_LINE_COUNT - 1;
+		display->mode = BEEMU_DISPLAY_MODE_VBLANK;
+		return remaining == 0 ? frame_cycles : remaining;
+	}
+	display->lcd_on = true;
+	switch (display->mode)
+	{
+	case BEEMU_DISPLAY_MODE_OAM_SCAN:
+		beemu_display_set_mode(display, BEEMU_DISPLAY_MODE_DRAWING, 0);
+		if (display->fifo)
+		{
+			beemu_pixel_fifo_start_line(display->fifo, display);
+			return BEEMU_PIXEL_FIFO_STEP_DOTS;
+		}
+		return BEEMU_DISPLAY_DRAWING_CYCLES;
+	case BEEMU_DISPLAY_MODE_DRAWING:
+		if (display->fifo)
+		{
+			// Mode 3 runs as long as the FIFO takes to draw the line.
+			if (!beemu_pixel_fifo_run(display->fifo, display, BEEMU_PIXEL_FIFO_STEP_DOTS))
+			{
+				return BEEMU_PIXEL_FIFO_STEP_DOTS;
+			}
+			beemu_display_set_mode(display, BEEMU_DISPLAY_MODE_HBLANK, BEEMU_DISPLAY_STAT_HBLANK_SOURCE);
+			return BEEMU_DISPLAY_CYCLES_PER_LINE - BEEMU_DISPLAY_OAM_SCAN_CYCLES - display->fifo->dots;
+		}
+		beemu_display_render_line(display, display->line);
+		beemu_display_set_mode(display, BEEMU_DISPLAY_MODE_HBLANK, BEEMU_DISPLAY_STAT_HBLANK_SOURCE);
+		return BEEMU_DISPLAY_CYCLES_PER_LINE - BEEMU_DISPLAY_OAM_SCAN_CYCLES - BEEMU_DISPLAY_DRAWING_CYCLES;
+	default:
+		break;
+	}
+	const uint8_t line = (display->line + 1) % BEEMU_DISPLAY_LINE_COUNT;
+	beemu_display_set_line(display, line);
+	if (line < BEEMU_DISPLAY_HEIGHT)
+	{
+		if (line == 0)
+		{
+			display->window_line = 0;
+		}
+		beemu_display_set_mode(display, BEEMU_DISPLAY_MODE_OAM_SCAN, BEEMU_DISPLAY_STAT_OAM_SOURCE);
+		return BEEMU_DISPLAY_OAM_SCAN_CYCLES;
+	}
+	if (line == BEEMU_DISPLAY_HEIGHT)
+	{
+		beemu_display_request_interrupt(display, BEEMU_INTERRUPT_VBLANK);
+		beemu_display_set_mode(display, BEEMU_DISPLAY_MODE_VBLANK, BEEMU_DISPLAY_STAT_VBLANK_SOURCE);
+	}
+	return BEEMU_DISPLAY_CYCLES_PER_LINE;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file display_common.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Private header for the parts both renderers of the display share.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_DEVICE_DISPLAY_COMMON_H
+#define BEEMU_DEVICE_DISPLAY_COMMON_H
+#include <stdint.h>
+#include <beemu/device/display.h>
+
+/**
+ * @brief Sprite attribute flags, the rest are CGB only.
+ */
+#define BEEMU_SPRITE_FLAG_BEHIND_BG 0x80
+#define BEEMU_SPRITE_FLAG_Y_FLIP 0x40
+#define BEEMU_SPRITE_FLAG_X_FLIP 0x20
+#define BEEMU_SPRITE_FLAG_PALETTE 0x10
+
+/**
+ * @brief Get the address of a background or window tile.
+ *
+ * Tiles are indexed from 0x8000 unsigned, or from 0x9000 signed.
+ * @param tile_data_start Start of the tile data LCDC selects.
+ */
+static inline uint16_t beemu_display_bg_tile_address(const uint16_t tile_data_start, const uint8_t tile)
+{
+	if (tile_data_start == BEEMU_DISPLAY_VRAM_ADDRESS)
+	{
+		return BEEMU_DISPLAY_VRAM_ADDRESS + tile * 16;
+	}
+	return (uint16_t)(0x9000 + (int8_t)tile * 16);
+}
+
+#endif // BEEMU_DEVICE_DISPLAY_COMMON_H
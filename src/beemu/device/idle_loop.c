@@ -0,0 +1,97 @@
+/**
+ * @file idle_loop.c
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Detect loops that only poll memory, so that they can be skipped.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <beemu/device/idle_loop.h>
+#include <beemu/device/processor/tokenizer.h>
+#include <string.h>
+
+void beemu_idle_loop_init(BeemuIdleLoopDetector *detector)
+{
+	memset(detector, 0, sizeof(BeemuIdleLoopDetector));
+}
+
+/**
+ * @brief Check if a single instruction may write memory or leave the loop
+ * other than by branching.
+ */
+static bool has_side_effects(const BeemuInstruction *instruction)
+{
+	switch (instruction->type)
+	{
+	case BEEMU_INSTRUCTION_TYPE_LOAD:
+		// Also catches PUSH, which writes through SP.
+		return instruction->params.load_params.dest.pointer;
+	case BEEMU_INSTRUCTION_TYPE_ARITHMATIC:
+		return instruction->params.arithmatic_params.dest_or_first.pointer;
+	case BEEMU_INSTRUCTION_TYPE_ROT_SHIFT:
+		return instruction->params.rot_shift_params.target.pointer;
+	case BEEMU_INSTRUCTION_TYPE_BITWISE:
+		return instruction->params.bitwise_params.operation != BEEMU_BIT_OP_BIT
+			&& instruction->params.bitwise_params.target.pointer;
+	case BEEMU_INSTRUCTION_TYPE_CPU_CONTROL:
+		return instruction->params.system_op != BEEMU_CPU_OP_NOP;
+	case BEEMU_INSTRUCTION_TYPE_JUMP:
+		return instruction->params.jump_params.type != BEEMU_JUMP_TYPE_JUMP;
+	}
+	return true;
+}
+
+bool beemu_idle_loop_is_side_effect_free(BeemuMemory *memory, const uint16_t head, const uint16_t branch)
+{
+	uint16_t address = head;
+	for (int i = 0; i < BEEMU_IDLE_LOOP_MAX_INSTRUCTIONS; i++)
+	{
+		const uint32_t machine_code = (uint32_t)beemu_memory_read(memory, address) << 16
+			| (uint32_t)beemu_memory_read(memory, (uint16_t)(address + 1)) << 8
+			| beemu_memory_read(memory, (uint16_t)(address + 2));
+		BeemuInstruction instruction;
+		beemu_tokenizer_tokenize_into(&instruction, machine_code);
+		if (has_side_effects(&instruction))
+		{
+			return false;
+		}
+		if (address == branch)
+		{
+			return true;
+		}
+		address += instruction.byte_length;
+		// The body has to run straight into the branch.
+		if (address > branch || address < head)
+		{
+			return false;
+		}
+	}
+	return false;
+}
+
+uint64_t beemu_idle_loop_observe(BeemuIdleLoopDetector *detector, BeemuProcessor *processor, const uint16_t branch, const uint64_t now)
+{
+	BeemuRegisters *registers = processor->registers;
+	const uint16_t head = registers->program_counter;
+	if (head != detector->head || branch != detector->branch)
+	{
+		detector->head = head;
+		detector->branch = branch;
+		detector->is_side_effect_free = beemu_idle_loop_is_side_effect_free(processor->memory, head, branch);
+		detector->has_snapshot = false;
+	}
+	if (!detector->is_side_effect_free)
+	{
+		return 0;
+	}
+	beemu_registers_flags_materialise(registers);
+	const bool is_idle = detector->has_snapshot && memcmp(detector->registers, registers->pairs, sizeof(detector->registers)) == 0;
+	const uint64_t iteration_cycles = now - detector->snapshot_at;
+	memcpy(detector->registers, registers->pairs, sizeof(detector->registers));
+	detector->snapshot_at = now;
+	detector->has_snapshot = true;
+	return is_idle ? iteration_cycles : 0;
+}
@@ -2,13 +2,13 @@
 #include <beemu/internals/logger.h>
 #include <stdlib.h>
 #include <assert.h>
-#include <string.h>
 
 BeemuMemory *beemu_memory_new(int size)
 {
 	BeemuMemory *memory = (BeemuMemory *)malloc(sizeof(BeemuMemory));
 	memory->memory_size = size;
 	memory->memory = (uint8_t *)calloc(memory->memory_size, sizeof(uint8_t));
+	beemu_memory_reset_pages(memory);
 	return memory;
 }
 
@@ -18,31 +18,104 @@ void beemu_memory_free(BeemuMemory *memory)
 	free(memory);
 }
 
-uint8_t beemu_memory_read(BeemuMemory *memory, int address)
+/**
+ * Read handler for pages only partially covered by the flat memory array.
+ */
+static uint8_t flat_memory_read(void *context, uint16_t address)
 {
-	assert(memory->memory_size > address);
-	return memory->memory[address];
+	const BeemuMemory *memory = context;
+	return address < memory->memory_size ? memory->memory[address] : 0xFF;
 }
 
-void beemu_memory_write(BeemuMemory *memory, int address, uint8_t value)
+/**
+ * Write handler for pages only partially covered by the flat memory array.
+ */
+static void flat_memory_write(void *context, uint16_t address, uint8_t value)
 {
-	assert(memory->memory_size > address);
-	memory->memory[address] = value;
+	BeemuMemory *memory = context;
+	if (address < memory->memory_size) {
+		memory->memory[address] = value;
+	}
+}
+
+void beemu_memory_reset_pages(BeemuMemory *memory)
+{
+	const BeemuMemoryHandler flat_handler = {flat_memory_read, flat_memory_write, memory};
+	for (int page = 0; page < BEEMU_MEMORY_PAGE_COUNT; page++) {
+		const bool is_within_memory = (page + 1) * BEEMU_MEMORY_PAGE_SIZE <= memory->memory_size;
+		uint8_t *storage = is_within_memory ? memory->memory + page * BEEMU_MEMORY_PAGE_SIZE : 0;
+		memory->read_pages[page] = storage;
+		memory->write_pages[page] = storage;
+		memory->handlers[page] = flat_handler;
+	}
+}
+
+void beemu_memory_map_pages(
+	BeemuMemory *memory,
+	uint8_t first_page,
+	uint16_t page_count,
+	const uint8_t *read_storage,
+	uint8_t *write_storage)
+{
+	assert(first_page + page_count <= BEEMU_MEMORY_PAGE_COUNT);
+	for (uint16_t i = 0; i < page_count; i++) {
+		const size_t offset = (size_t)i * BEEMU_MEMORY_PAGE_SIZE;
+		memory->read_pages[first_page + i] = read_storage ? read_storage + offset : 0;
+		memory->write_pages[first_page + i] = write_storage ? write_storage + offset : 0;
+	}
+}
+
+void beemu_memory_set_page_handlers(
+	BeemuMemory *memory,
+	uint8_t first_page,
+	uint16_t page_count,
+	BeemuMemoryHandler handler)
+{
+	assert(first_page + page_count <= BEEMU_MEMORY_PAGE_COUNT);
+	for (uint16_t i = 0; i < page_count; i++) {
+		memory->handlers[first_page + i] = handler;
+	}
+}
+
+uint8_t beemu_memory_read_unmapped(BeemuMemory *memory, uint16_t address)
+{
+	const BeemuMemoryHandler *handler = &memory->handlers[address >> 8];
+	return handler->read ? handler->read(handler->context, address) : 0xFF;
+}
+
+void beemu_memory_write_unmapped(BeemuMemory *memory, uint16_t address, uint8_t value)
+{
+	const BeemuMemoryHandler *handler = &memory->handlers[address >> 8];
+	if (handler->write) {
+		handler->write(handler->context, address, value);
+	}
 }
 
 bool beemu_memory_write_buffer(BeemuMemory *memory, int address, uint8_t *buffer, int size)
 {
 	if (memory->memory_size <= address + size - 1)
 	{
-		beemu_log(
+		BEEMU_LOG(
 			BEEMU_LOG_WARN,
 			"Attempted memory address 0x%X for buffer write above maximum addressable memory address 0x%X",
 			address,
 			memory->memory_size - 1);
 		return false;
 	}
-	beemu_log(BEEMU_LOG_INFO, "Writing buffered value of size %i to memory address 0x%X", size, address);
-	memcpy(memory->memory + address, buffer, size);
+	// Refuse the whole write rather than drop the bytes of read only pages.
+	for (int page = address >> 8; page <= (address + size - 1) >> 8; page++) {
+		if (!memory->write_pages[page] && !memory->handlers[page].write) {
+			BEEMU_LOG(
+				BEEMU_LOG_WARN,
+				"Attempted buffer write to read only memory page at 0x%X",
+				page << 8);
+			return false;
+		}
+	}
+	// Go through the bus, the range may span several pages and handlers.
+	for (int i = 0; i < size; i++) {
+		beemu_memory_write(memory, address + i, buffer[i]);
+	}
 	return true;
 }
 
@@ -50,14 +123,16 @@ bool beemu_memory_read_buffer(BeemuMemory *memory, int address, uint8_t *buffer,
 {
 	if (memory->memory_size <= address + size - 1)
 	{
-		beemu_log(
+		BEEMU_LOG(
 			BEEMU_LOG_WARN,
 			"Attempted memory address 0x%X for buffer read above maximum addressable memory address 0x%X",
 			address,
 			memory->memory_size - 1);
 		return false;
 	}
-	memcpy(buffer, memory->memory + address, size);
+	for (int i = 0; i < size; i++) {
+		buffer[i] = beemu_memory_read(memory, address + i);
+	}
 	return true;
 }
 
@@ -73,7 +148,9 @@ bool beemu_memory_copy(BeemuMemory *memory, BeemuMemory *destination, int start,
 	}
 	else
 	{
-		memcpy(destination->memory + dst_start, memory->memory + start, size);
+		for (int i = 0; i < size; i++) {
+			beemu_memory_write(destination, dst_start + i, beemu_memory_read(memory, start + i));
+		}
 		return true;
 	}
 }
@@ -82,14 +159,14 @@ uint16_t beemu_memory_read_16(BeemuMemory *memory, uint16_t address)
 {
 	const uint8_t lower = beemu_memory_read(memory, address + 1);
 	const uint8_t higher = beemu_memory_read(memory, address);
-	beemu_log(BEEMU_LOG_INFO, "Read two bytes from 0x%X, which were 0x%X and 0x%X", address, lower, higher);
 	return (((uint16_t)lower) << 8) | ((uint16_t)higher);
 }
 
 void beemu_memory_write_16(BeemuMemory *memory, uint16_t address, uint16_t value)
 {
-	uint8_t deconstructed[2] = {((uint8_t)(value & 0x00FF)), ((uint8_t)((value & 0xFF00) >> 8))};
-	beemu_memory_write_buffer(memory, address, deconstructed, 2);
+	// Byte by byte, as the bus would, a read only half drops only its own byte.
+	beemu_memory_write(memory, address, value & 0x00FF);
+	beemu_memory_write(memory, (uint16_t)(address + 1), (value & 0xFF00) >> 8);
 }
 
 const uint16_t beemu_memory_block_get_size(BeemuMemoryBlock block)
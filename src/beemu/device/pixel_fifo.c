@@ -0,0 +1,324 @@
+/**
+ * @file pixel_fifo.c
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Pixel FIFO renderer, drawing the line dot by dot through mode 3.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "display_common.h"
+#include "pixel_fifo.h"
+
+/**
+ * @brief Dots the fetcher pauses for to fetch a sprite.
+ */
+#define BEEMU_PIXEL_FIFO_SPRITE_FETCH_DOTS 6
+
+BeemuPixelFifo *beemu_pixel_fifo_new(void)
+{
+	BeemuPixelFifo *fifo = (BeemuPixelFifo *)malloc(sizeof(BeemuPixelFifo));
+	memset(fifo, 0, sizeof(BeemuPixelFifo));
+	return fifo;
+}
+
+void beemu_pixel_fifo_free(BeemuPixelFifo *fifo)
+{
+	free(fifo);
+}
+
+static inline void beemu_pixel_queue_clear(BeemuPixelQueue *queue)
+{
+	queue->head = 0;
+	queue->size = 0;
+}
+
+/**
+ * @brief Get the pixel at an offset from the head of the queue.
+ */
+static inline BeemuQueuedPixel *beemu_pixel_queue_at(BeemuPixelQueue *queue, const uint8_t offset)
+{
+	return &queue->pixels[(queue->head + offset) % BEEMU_PIXEL_FIFO_CAPACITY];
+}
+
+static inline void beemu_pixel_queue_push(BeemuPixelQueue *queue, const BeemuQueuedPixel pixel)
+{
+	*beemu_pixel_queue_at(queue, queue->size++) = pixel;
+}
+
+static inline BeemuQueuedPixel beemu_pixel_queue_pop(BeemuPixelQueue *queue)
+{
+	const BeemuQueuedPixel pixel = queue->pixels[queue->head];
+	queue->head = (queue->head + 1) % BEEMU_PIXEL_FIFO_CAPACITY;
+	queue->size--;
+	return pixel;
+}
+
+/**
+ * @brief Get the colour index of a pixel of a tile row, leftmost bit first.
+ */
+static inline uint8_t beemu_pixel_fifo_index(const uint8_t low, const uint8_t high, const int pixel)
+{
+	const int bit = 7 - pixel;
+	return ((low >> bit) & 1) | (((high >> bit) & 1) << 1);
+}
+
+void beemu_pixel_fifo_start_line(BeemuPixelFifo *fifo, BeemuDisplay *display)
+{
+	const uint8_t lcdc = beemu_memory_read(display->memory, BEEMU_DISPLAY_LCDC_ADDRESS);
+	fifo->line = display->line;
+	beemu_pixel_queue_clear(&fifo->background);
+	beemu_pixel_queue_clear(&fifo->sprites);
+	fifo->step = BEEMU_PIXEL_FETCHER_GET_TILE;
+	fifo->step_dots = 0;
+	fifo->fetcher_x = 0;
+	fifo->in_window = false;
+	fifo->discard = beemu_memory_read(display->memory, BEEMU_DISPLAY_SCX_ADDRESS) % 8;
+	fifo->x = 0;
+	// OAM writes during the line do not change the sprites it selected.
+	const BeemuSpriteSize size = (lcdc & 0x04) ? BEEMU_SPRITE_SIZE_8_TO_16 : BEEMU_SPRITE_SIZE_8_TO_8;
+	const uint16_t *sprites = beemu_sprite_bins_line(&display->sprite_bins, display->memory, size, display->line, &fifo->sprite_count);
+	memcpy(fifo->line_sprites, sprites, fifo->sprite_count * sizeof(uint16_t));
+	fifo->next_sprite = 0;
+	fifo->sprite_dots = 0;
+	fifo->dots = 0;
+}
+
+/**
+ * @brief Get the address of the row of the fetched tile the line is on.
+ */
+static inline uint16_t beemu_pixel_fifo_row_address(const BeemuPixelFifo *fifo, BeemuDisplay *display, const uint8_t lcdc)
+{
+	uint8_t row = display->window_line % 8;
+	if (!fifo->in_window)
+	{
+		row = (uint8_t)(beemu_memory_read(display->memory, BEEMU_DISPLAY_SCY_ADDRESS) + fifo->line) % 8;
+	}
+	return beemu_display_bg_tile_address((lcdc & 0x10) ? 0x8000 : 0x8800, fifo->tile) + row * 2;
+}
+
+/**
+ * @brief Get the address in the tile map of the tile the fetcher is on.
+ */
+static inline uint16_t beemu_pixel_fifo_map_address(const BeemuPixelFifo *fifo, BeemuDisplay *display, const uint8_t lcdc)
+{
+	if (fifo->in_window)
+	{
+		const uint16_t map = (lcdc & 0x40) ? 0x9C00 : 0x9800;
+		return map + (display->window_line / 8) * 32 + (fifo->fetcher_x & 31);
+	}
+	const uint16_t map = (lcdc & 0x08) ? 0x9C00 : 0x9800;
+	const uint8_t y = beemu_memory_read(display->memory, BEEMU_DISPLAY_SCY_ADDRESS) + fifo->line;
+	const uint8_t scroll_x = beemu_memory_read(display->memory, BEEMU_DISPLAY_SCX_ADDRESS);
+	return map + (y / 8) * 32 + ((scroll_x / 8 + fifo->fetcher_x) & 31);
+}
+
+/**
+ * @brief Run the background fetcher for a dot.
+ *
+ * Each read takes two dots, the fetched row is then pushed as soon as the
+ * background queue runs empty.
+ */
+static void beemu_pixel_fifo_fetch(BeemuPixelFifo *fifo, BeemuDisplay *display, const uint8_t lcdc)
+{
+	if (fifo->step == BEEMU_PIXEL_FETCHER_PUSH)
+	{
+		if (fifo->background.size != 0)
+		{
+			return;
+		}
+		for (int pixel = 0; pixel < 8; pixel++)
+		{
+			// With the background off, it is drawn as colour 0.
+			const BeemuQueuedPixel queued = {.index = (lcdc & 0x01) ? beemu_pixel_fifo_index(fifo->low, fifo->high, pixel) : 0, .flags = 0};
+			beemu_pixel_queue_push(&fifo->background, queued);
+		}
+		fifo->fetcher_x++;
+		fifo->step = BEEMU_PIXEL_FETCHER_GET_TILE;
+		return;
+	}
+	if (++fifo->step_dots < 2)
+	{
+		return;
+	}
+	fifo->step_dots = 0;
+	switch (fifo->step)
+	{
+	case BEEMU_PIXEL_FETCHER_GET_TILE:
+		fifo->tile = beemu_memory_read(display->memory, beemu_pixel_fifo_map_address(fifo, display, lcdc));
+		fifo->step = BEEMU_PIXEL_FETCHER_GET_LOW;
+		break;
+	case BEEMU_PIXEL_FETCHER_GET_LOW:
+		fifo->low = beemu_memory_read(display->memory, beemu_pixel_fifo_row_address(fifo, display, lcdc));
+		fifo->step = BEEMU_PIXEL_FETCHER_GET_HIGH;
+		break;
+	default:
+		fifo->high = beemu_memory_read(display->memory, beemu_pixel_fifo_row_address(fifo, display, lcdc) + 1);
+		fifo->step = BEEMU_PIXEL_FETCHER_PUSH;
+		break;
+	}
+}
+
+/**
+ * @brief Merge the row of the next sprite into the sprite queue.
+ *
+ * Pixels already in the queue came from sprites of higher priority, so
+ * the sprite only fills the transparent ones.
+ */
+static void beemu_pixel_fifo_merge_sprite(BeemuPixelFifo *fifo, BeemuDisplay *display, const uint8_t lcdc)
+{
+	const uint16_t sprite = fifo->line_sprites[fifo->next_sprite++];
+	const uint8_t height = (lcdc & 0x04) ? 16 : 8;
+	const uint8_t flags = beemu_memory_read(display->memory, sprite + 3);
+	uint8_t tile = beemu_memory_read(display->memory, sprite + 2);
+	uint8_t row = (uint8_t)(fifo->line + 16 - beemu_memory_read(display->memory, sprite)) & (height - 1);
+	if (height == 16)
+	{
+		tile &= 0xFE;
+	}
+	if (flags & BEEMU_SPRITE_FLAG_Y_FLIP)
+	{
+		row = height - 1 - row;
+	}
+	// Tall sprites continue into the next tile.
+	const uint16_t address = BEEMU_DISPLAY_VRAM_ADDRESS + (tile + row / 8) * 16 + (row % 8) * 2;
+	const uint8_t low = beemu_memory_read(display->memory, address);
+	const uint8_t high = beemu_memory_read(display->memory, address + 1);
+	const int left = beemu_memory_read(display->memory, sprite + 1) - 8;
+	for (int pixel = 0; pixel < 8; pixel++)
+	{
+		// Pixels left of the next one were shifted out, or are off screen.
+		const int offset = left + pixel - fifo->x;
+		if (offset < 0)
+		{
+			continue;
+		}
+		while (fifo->sprites.size <= offset)
+		{
+			const BeemuQueuedPixel transparent = {.index = 0, .flags = 0};
+			beemu_pixel_queue_push(&fifo->sprites, transparent);
+		}
+		BeemuQueuedPixel *queued = beemu_pixel_queue_at(&fifo->sprites, offset);
+		const uint8_t index = beemu_pixel_fifo_index(low, high, (flags & BEEMU_SPRITE_FLAG_X_FLIP) ? 7 - pixel : pixel);
+		if (queued->index == 0 && index != 0)
+		{
+			queued->index = index;
+			queued->flags = flags;
+		}
+	}
+}
+
+/**
+ * @brief Check if the window starts at the next pixel.
+ *
+ * WX is offset by 7, values below 7 start the window left of the screen.
+ */
+static inline bool beemu_pixel_fifo_window_starts(const BeemuPixelFifo *fifo, BeemuDisplay *display, const uint8_t lcdc)
+{
+	if (fifo->in_window || (lcdc & 0x21) != 0x21)
+	{
+		return false;
+	}
+	const uint8_t window_x = beemu_memory_read(display->memory, BEEMU_DISPLAY_WX_ADDRESS);
+	if (fifo->line < beemu_memory_read(display->memory, BEEMU_DISPLAY_WY_ADDRESS) || window_x >= BEEMU_DISPLAY_WIDTH + 7)
+	{
+		return false;
+	}
+	return fifo->x + 7 == window_x || (fifo->x == 0 && window_x < 7);
+}
+
+/**
+ * @brief Get the shade of the next pixel, mixing the sprite over the background.
+ */
+static inline uint8_t beemu_pixel_fifo_mix(BeemuDisplay *display, const BeemuQueuedPixel background, const BeemuQueuedPixel sprite, const uint8_t lcdc)
+{
+	if (sprite.index != 0 && (lcdc & 0x02) && (!(sprite.flags & BEEMU_SPRITE_FLAG_BEHIND_BG) || background.index == 0))
+	{
+		const uint16_t palette = (sprite.flags & BEEMU_SPRITE_FLAG_PALETTE) ? BEEMU_DISPLAY_OBP1_ADDRESS : BEEMU_DISPLAY_OBP0_ADDRESS;
+		return (beemu_memory_read(display->memory, palette) >> (sprite.index * 2)) & 3;
+	}
+	return (beemu_memory_read(display->memory, BEEMU_DISPLAY_BGP_ADDRESS) >> (background.index * 2)) & 3;
+}
+
+/**
+ * @brief Run the FIFO for a single dot.
+ *
+ * @return true if the last pixel of the line was shifted out.
+ */
+static bool beemu_pixel_fifo_tick(BeemuPixelFifo *fifo, BeemuDisplay *display)
+{
+	const uint8_t lcdc = beemu_memory_read(display->memory, BEEMU_DISPLAY_LCDC_ADDRESS);
+	if (fifo->sprite_dots)
+	{
+		if (--fifo->sprite_dots == 0)
+		{
+			beemu_pixel_fifo_merge_sprite(fifo, display, lcdc);
+		}
+		return false;
+	}
+	// Sprites are fetched once the pixel their left edge is on comes up,
+	// or right away for those starting left of the screen.
+	if ((lcdc & 0x02) && fifo->next_sprite < fifo->sprite_count
+		&& beemu_memory_read(display->memory, fifo->line_sprites[fifo->next_sprite] + 1) <= fifo->x + 8)
+	{
+		fifo->sprite_dots = BEEMU_PIXEL_FIFO_SPRITE_FETCH_DOTS;
+		return false;
+	}
+	if (beemu_pixel_fifo_window_starts(fifo, display, lcdc))
+	{
+		// The fetcher starts over from the first tile of the window.
+		const uint8_t window_x = beemu_memory_read(display->memory, BEEMU_DISPLAY_WX_ADDRESS);
+		fifo->in_window = true;
+		beemu_pixel_queue_clear(&fifo->background);
+		fifo->step = BEEMU_PIXEL_FETCHER_GET_TILE;
+		fifo->step_dots = 0;
+		fifo->fetcher_x = 0;
+		fifo->discard = window_x < 7 ? 7 - window_x : 0;
+	}
+	// Shift out before fetching, so a row is pushed the dot the last one runs out.
+	bool done = false;
+	if (fifo->background.size != 0)
+	{
+		const BeemuQueuedPixel background = beemu_pixel_queue_pop(&fifo->background);
+		if (fifo->discard)
+		{
+			fifo->discard--;
+		}
+		else
+		{
+			BeemuQueuedPixel sprite = {.index = 0, .flags = 0};
+			if (fifo->sprites.size != 0)
+			{
+				sprite = beemu_pixel_queue_pop(&fifo->sprites);
+			}
+			display->framebuffer[fifo->line][fifo->x++] = beemu_pixel_fifo_mix(display, background, sprite, lcdc);
+			done = fifo->x == BEEMU_DISPLAY_WIDTH;
+		}
+	}
+	if (!done)
+	{
+		beemu_pixel_fifo_fetch(fifo, display, lcdc);
+	}
+	return done;
+}
+
+bool beemu_pixel_fifo_run(BeemuPixelFifo *fifo, BeemuDisplay *display, const uint32_t dots)
+{
+	fifo->dots += dots;
+	for (uint32_t dot = 0; dot < dots; dot++)
+	{
+		if (beemu_pixel_fifo_tick(fifo, display))
+		{
+			if (fifo->in_window)
+			{
+				display->window_line++;
+			}
+			return true;
+		}
+	}
+	return false;
+}
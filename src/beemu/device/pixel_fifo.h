@@ -0,0 +1,125 @@
+/**
+ * @file pixel_fifo.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Private header for the pixel FIFO renderer of the display.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_DEVICE_PIXEL_FIFO_H
+#define BEEMU_DEVICE_PIXEL_FIFO_H
+#include <stdint.h>
+#include <stdbool.h>
+#include <beemu/device/display.h>
+
+/**
+ * @brief Dots the FIFO runs for each time the display advances in mode 3,
+ * a single M-cycle, so that writes land within an instruction of their dot.
+ */
+#define BEEMU_PIXEL_FIFO_STEP_DOTS 4
+
+/**
+ * @brief Pixels a queue holds at most, the fetcher only pushes to an empty
+ * background queue, so 8 would do if sprites did not overlap it.
+ */
+#define BEEMU_PIXEL_FIFO_CAPACITY 16
+
+/**
+ * @brief Steps of the fetcher, each but the push takes two dots.
+ */
+typedef enum BeemuPixelFetcherStep
+{
+	BEEMU_PIXEL_FETCHER_GET_TILE,
+	BEEMU_PIXEL_FETCHER_GET_LOW,
+	BEEMU_PIXEL_FETCHER_GET_HIGH,
+	BEEMU_PIXEL_FETCHER_PUSH
+} BeemuPixelFetcherStep;
+
+/**
+ * @brief A pixel waiting to be shifted out.
+ */
+typedef struct BeemuQueuedPixel
+{
+	/** Colour index, 0 is transparent for sprites. */
+	uint8_t index;
+	/** Attributes of the sprite the pixel came from, 0 for the background. */
+	uint8_t flags;
+} BeemuQueuedPixel;
+
+/**
+ * @brief Ring buffer of pixels, shifted out from the head.
+ */
+typedef struct BeemuPixelQueue
+{
+	BeemuQueuedPixel pixels[BEEMU_PIXEL_FIFO_CAPACITY];
+	uint8_t head;
+	uint8_t size;
+} BeemuPixelQueue;
+
+/**
+ * @brief State of mode 3 of the line being drawn.
+ *
+ * The fetcher reads the tile map and tile data as the line goes, and the
+ * registers are read on the dot they are used, so that SCX, SCY, palette
+ * and LCDC writes during mode 3 take effect from the next pixels fetched
+ * or shifted out.
+ */
+typedef struct BeemuPixelFifo
+{
+	BeemuPixelQueue background;
+	/** Sprite pixels lined up with the background, from the next pixel on. */
+	BeemuPixelQueue sprites;
+	BeemuPixelFetcherStep step;
+	/** Dots spent in the current step. */
+	uint8_t step_dots;
+	/** Tile of the map the fetcher is on, counted from the start of the line or window. */
+	uint8_t fetcher_x;
+	uint8_t tile;
+	uint8_t low;
+	uint8_t high;
+	bool in_window;
+	/** Background pixels to drop before shifting out, for fine scrolling. */
+	uint8_t discard;
+	/** Next pixel of the line to shift out. */
+	uint8_t x;
+	uint8_t line;
+	uint16_t line_sprites[BEEMU_DISPLAY_SPRITES_PER_LINE];
+	int sprite_count;
+	/** First sprite on the line not fetched yet. */
+	int next_sprite;
+	/** Dots left until the sprite being fetched is merged, 0 when none is. */
+	uint8_t sprite_dots;
+	/** Dots run since mode 3 started. */
+	uint16_t dots;
+} BeemuPixelFifo;
+
+/**
+ * @brief Create a pixel FIFO, before any line starts.
+ */
+BeemuPixelFifo *beemu_pixel_fifo_new(void);
+
+/**
+ * @brief Free the pixel FIFO.
+ */
+void beemu_pixel_fifo_free(BeemuPixelFifo *fifo);
+
+/**
+ * @brief Start mode 3 of the display's current line.
+ *
+ * Selects the sprites on the line and empties the queues.
+ */
+void beemu_pixel_fifo_start_line(BeemuPixelFifo *fifo, BeemuDisplay *display);
+
+/**
+ * @brief Run the FIFO for up to the given dots, drawing to the framebuffer.
+ *
+ * @param dots Dots to run.
+ * @return true if the last pixel of the line was shifted out, the dots
+ * run are added to the dots of the FIFO either way.
+ */
+bool beemu_pixel_fifo_run(BeemuPixelFifo *fifo, BeemuDisplay *display, uint32_t dots);
+
+#endif // BEEMU_DEVICE_PIXEL_FIFO_H
@@ -0,0 +1,305 @@
+/**
+ * @file pixel_kernels.c
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Kernels decoding tile rows and expanding colour indices to pixels.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <beemu/device/pixel_kernels.h>
+#include <stdbool.h>
+#include <string.h>
+#include "../internals/once.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BEEMU_PIXEL_KERNELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVC takes the intrinsics of any instruction set without flags.
+#define BEEMU_TARGET_AVX2
+#else
+#define BEEMU_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+/**
+ * @brief Combine a palette with the pixel value of each shade, to a pixel
+ * value per colour index.
+ */
+#define BEEMU_PALETTE_LOOKUP(lookup, palette, colours)         \
+	for (int index = 0; index < 4; index++)                    \
+	{                                                          \
+		lookup[index] = colours[((palette) >> (index * 2)) & 3]; \
+	}
+
+static void beemu_decode_rows_scalar(const uint8_t *rows, const size_t row_count, uint8_t *indices)
+{
+	for (size_t row = 0; row < row_count; row++)
+	{
+		const uint8_t low = rows[row * 2];
+		const uint8_t high = rows[row * 2 + 1];
+		for (int pixel = 0; pixel < 8; pixel++)
+		{
+			const int bit = 7 - pixel;
+			indices[row * 8 + pixel] = ((high >> bit) & 1) << 1 | ((low >> bit) & 1);
+		}
+	}
+}
+
+static void beemu_expand_32_scalar(const uint8_t *indices, const size_t count, const uint8_t palette, const uint32_t colours[4], uint32_t *pixels)
+{
+	uint32_t lookup[4];
+	BEEMU_PALETTE_LOOKUP(lookup, palette, colours);
+	for (size_t i = 0; i < count; i++)
+	{
+		pixels[i] = lookup[indices[i] & 3];
+	}
+}
+
+static void beemu_expand_16_scalar(const uint8_t *indices, const size_t count, const uint8_t palette, const uint16_t colours[4], uint16_t *pixels)
+{
+	uint16_t lookup[4];
+	BEEMU_PALETTE_LOOKUP(lookup, palette, colours);
+	for (size_t i = 0; i < count; i++)
+	{
+		pixels[i] = lookup[indices[i] & 3];
+	}
+}
+
+static const BeemuPixelKernels SCALAR_KERNELS = {
+	.level = BEEMU_PIXEL_KERNEL_SCALAR,
+	.name = "scalar",
+	.decode_rows = beemu_decode_rows_scalar,
+	.expand_32 = beemu_expand_32_scalar,
+	.expand_16 = beemu_expand_16_scalar};
+
+#ifdef BEEMU_PIXEL_KERNELS_X86
+/**
+ * @brief Bit of each pixel in a row, leftmost pixel in the lowest byte.
+ */
+#define BEEMU_PIXEL_BITS 0x0102040810204080LL
+/**
+ * @brief Broadcasts a byte to all 8 bytes of a 64 bit value.
+ */
+#define BEEMU_BROADCAST_BYTE 0x0101010101010101ULL
+
+/**
+ * @brief Turn broadcast row bytes into colour indices, a byte per pixel.
+ */
+static inline __m128i beemu_decode_broadcast_sse2(const __m128i low, const __m128i high)
+{
+	const __m128i bits = _mm_set1_epi64x(BEEMU_PIXEL_BITS);
+	const __m128i low_set = _mm_cmpeq_epi8(_mm_and_si128(low, bits), bits);
+	const __m128i high_set = _mm_cmpeq_epi8(_mm_and_si128(high, bits), bits);
+	return _mm_or_si128(_mm_and_si128(low_set, _mm_set1_epi8(1)), _mm_and_si128(high_set, _mm_set1_epi8(2)));
+}
+
+static void beemu_decode_rows_sse2(const uint8_t *rows, const size_t row_count, uint8_t *indices)
+{
+	size_t row = 0;
+	for (; row + 2 <= row_count; row += 2)
+	{
+		const uint8_t *pair = rows + row * 2;
+		const __m128i low = _mm_set_epi64x((long long)(pair[2] * BEEMU_BROADCAST_BYTE), (long long)(pair[0] * BEEMU_BROADCAST_BYTE));
+		const __m128i high = _mm_set_epi64x((long long)(pair[3] * BEEMU_BROADCAST_BYTE), (long long)(pair[1] * BEEMU_BROADCAST_BYTE));
+		_mm_storeu_si128((__m128i *)(indices + row * 8), beemu_decode_broadcast_sse2(low, high));
+	}
+	beemu_decode_rows_scalar(rows + row * 2, row_count - row, indices + row * 8);
+}
+
+static void beemu_expand_32_sse2(const uint8_t *indices, const size_t count, const uint8_t palette, const uint32_t colours[4], uint32_t *pixels)
+{
+	uint32_t lookup[4];
+	BEEMU_PALETTE_LOOKUP(lookup, palette, colours);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		// Widen 4 indices to 32 bits, then select each lookup entry where it matches.
+		const __m128i zero = _mm_setzero_si128();
+		int32_t packed;
+		memcpy(&packed, indices + i, sizeof(packed));
+		const __m128i bytes = _mm_cvtsi32_si128(packed & 0x03030303);
+		const __m128i wide = _mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero);
+		__m128i result = zero;
+		for (int index = 0; index < 4; index++)
+		{
+			const __m128i match = _mm_cmpeq_epi32(wide, _mm_set1_epi32(index));
+			result = _mm_or_si128(result, _mm_and_si128(match, _mm_set1_epi32((int)lookup[index])));
+		}
+		_mm_storeu_si128((__m128i *)(pixels + i), result);
+	}
+	for (; i < count; i++)
+	{
+		pixels[i] = lookup[indices[i] & 3];
+	}
+}
+
+static void beemu_expand_16_sse2(const uint8_t *indices, const size_t count, const uint8_t palette, const uint16_t colours[4], uint16_t *pixels)
+{
+	uint16_t lookup[4];
+	BEEMU_PALETTE_LOOKUP(lookup, palette, colours);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i bytes = _mm_and_si128(_mm_loadl_epi64((const __m128i *)(indices + i)), _mm_set1_epi8(3));
+		const __m128i wide = _mm_unpacklo_epi8(bytes, zero);
+		__m128i result = zero;
+		for (int index = 0; index < 4; index++)
+		{
+			const __m128i match = _mm_cmpeq_epi16(wide, _mm_set1_epi16((short)index));
+			result = _mm_or_si128(result, _mm_and_si128(match, _mm_set1_epi16((short)lookup[index])));
+		}
+		_mm_storeu_si128((__m128i *)(pixels + i), result);
+	}
+	for (; i < count; i++)
+	{
+		pixels[i] = lookup[indices[i] & 3];
+	}
+}
+
+static const BeemuPixelKernels SSE2_KERNELS = {
+	.level = BEEMU_PIXEL_KERNEL_SSE2,
+	.name = "sse2",
+	.decode_rows = beemu_decode_rows_sse2,
+	.expand_32 = beemu_expand_32_sse2,
+	.expand_16 = beemu_expand_16_sse2};
+
+BEEMU_TARGET_AVX2 static void beemu_decode_rows_avx2(const uint8_t *rows, const size_t row_count, uint8_t *indices)
+{
+	const __m256i bits = _mm256_set1_epi64x(BEEMU_PIXEL_BITS);
+	size_t row = 0;
+	for (; row + 4 <= row_count; row += 4)
+	{
+		// Broadcast each low and high byte to the 8 bytes of its row.
+		const __m128i pairs = _mm_loadl_epi64((const __m128i *)(rows + row * 2));
+		const __m256i spread = _mm256_broadcastsi128_si256(pairs);
+		const __m256i low = _mm256_shuffle_epi8(spread, _mm256_setr_epi8(
+			0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2,
+			4, 4, 4, 4, 4, 4, 4, 4, 6, 6, 6, 6, 6, 6, 6, 6));
+		const __m256i high = _mm256_shuffle_epi8(spread, _mm256_setr_epi8(
+			1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 3, 3, 3, 3, 3, 3,
+			5, 5, 5, 5, 5, 5, 5, 5, 7, 7, 7, 7, 7, 7, 7, 7));
+		const __m256i low_set = _mm256_cmpeq_epi8(_mm256_and_si256(low, bits), bits);
+		const __m256i high_set = _mm256_cmpeq_epi8(_mm256_and_si256(high, bits), bits);
+		const __m256i result = _mm256_or_si256(_mm256_and_si256(low_set, _mm256_set1_epi8(1)), _mm256_and_si256(high_set, _mm256_set1_epi8(2)));
+		_mm256_storeu_si256((__m256i *)(indices + row * 8), result);
+	}
+	beemu_decode_rows_sse2(rows + row * 2, row_count - row, indices + row * 8);
+}
+
+BEEMU_TARGET_AVX2 static void beemu_expand_32_avx2(const uint8_t *indices, const size_t count, const uint8_t palette, const uint32_t colours[4], uint32_t *pixels)
+{
+	uint32_t lookup[4];
+	BEEMU_PALETTE_LOOKUP(lookup, palette, colours);
+	const __m256i table = _mm256_setr_epi32((int)lookup[0], (int)lookup[1], (int)lookup[2], (int)lookup[3], 0, 0, 0, 0);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m256i wide = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(indices + i)));
+		const __m256i masked = _mm256_and_si256(wide, _mm256_set1_epi32(3));
+		_mm256_storeu_si256((__m256i *)(pixels + i), _mm256_permutevar8x32_epi32(table, masked));
+	}
+	for (; i < count; i++)
+	{
+		pixels[i] = lookup[indices[i] & 3];
+	}
+}
+
+BEEMU_TARGET_AVX2 static void beemu_expand_16_avx2(const uint8_t *indices, const size_t count, const uint8_t palette, const uint16_t colours[4], uint16_t *pixels)
+{
+	uint16_t lookup[4];
+	BEEMU_PALETTE_LOOKUP(lookup, palette, colours);
+	// Look the low and the high bytes up separately, 16 indices at a time.
+	const __m256i low_table = _mm256_setr_epi8(
+		(char)lookup[0], (char)lookup[1], (char)lookup[2], (char)lookup[3], 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		(char)lookup[0], (char)lookup[1], (char)lookup[2], (char)lookup[3], 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+	const __m256i high_table = _mm256_setr_epi8(
+		(char)(lookup[0] >> 8), (char)(lookup[1] >> 8), (char)(lookup[2] >> 8), (char)(lookup[3] >> 8), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		(char)(lookup[0] >> 8), (char)(lookup[1] >> 8), (char)(lookup[2] >> 8), (char)(lookup[3] >> 8), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		const __m256i wide = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(indices + i)));
+		const __m256i masked = _mm256_and_si256(wide, _mm256_set1_epi16(3));
+		// Indices are below 4, so the zero upper byte of each lane looks up entry 0 and is shifted out.
+		const __m256i low = _mm256_and_si256(_mm256_shuffle_epi8(low_table, masked), _mm256_set1_epi16(0xFF));
+		const __m256i high = _mm256_slli_epi16(_mm256_shuffle_epi8(high_table, masked), 8);
+		_mm256_storeu_si256((__m256i *)(pixels + i), _mm256_or_si256(low, high));
+	}
+	for (; i < count; i++)
+	{
+		pixels[i] = lookup[indices[i] & 3];
+	}
+}
+
+static const BeemuPixelKernels AVX2_KERNELS = {
+	.level = BEEMU_PIXEL_KERNEL_AVX2,
+	.name = "avx2",
+	.decode_rows = beemu_decode_rows_avx2,
+	.expand_32 = beemu_expand_32_avx2,
+	.expand_16 = beemu_expand_16_avx2};
+
+/**
+ * @brief Check if both the processor and the operating system support AVX2.
+ */
+static bool beemu_pixel_kernels_has_avx2(void)
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	// OSXSAVE and AVX, then the YMM state enabled by the operating system.
+	if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+	{
+		return false;
+	}
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+const BeemuPixelKernels *beemu_pixel_kernels_for(const BeemuPixelKernelLevel level)
+{
+	switch (level)
+	{
+	case BEEMU_PIXEL_KERNEL_SCALAR:
+		return &SCALAR_KERNELS;
+#ifdef BEEMU_PIXEL_KERNELS_X86
+	case BEEMU_PIXEL_KERNEL_SSE2:
+		return &SSE2_KERNELS;
+	case BEEMU_PIXEL_KERNEL_AVX2:
+		return beemu_pixel_kernels_has_avx2() ? &AVX2_KERNELS : NULL;
+#endif
+	default:
+		return NULL;
+	}
+}
+
+static BeemuOnce selected_once = BEEMU_ONCE_INIT;
+static const BeemuPixelKernels *selected_kernels = &SCALAR_KERNELS;
+
+const BeemuPixelKernels *beemu_pixel_kernels_get(void)
+{
+	if (beemu_once_begin(&selected_once))
+	{
+		for (int level = BEEMU_PIXEL_KERNEL_LEVEL_COUNT - 1; level >= 0; level--)
+		{
+			const BeemuPixelKernels *kernels = beemu_pixel_kernels_for((BeemuPixelKernelLevel)level);
+			if (kernels != NULL)
+			{
+				selected_kernels = kernels;
+				break;
+			}
+		}
+		beemu_once_end(&selected_once);
+	}
+	return selected_kernels;
+}
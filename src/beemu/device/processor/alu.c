@@ -0,0 +1,223 @@
+/**
+ * @file alu.c
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Results and flags of 8 bit ALU operations.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "alu.h"
+#include <beemu/device/processor/registers.h>
+#include "../../internals/once.h"
+
+/**
+ * Calculate the result of an operation as int32_t so that overflow/underflow won't occur.
+ * @return
+ */
+int32_t resolve_result_wo_overflow(const uint16_t first_value, const uint16_t second_value, const BeemuOperation operation, const uint8_t carry_flag)
+{
+	switch (operation) {
+	case BEEMU_OP_ADD:
+	case BEEMU_OP_INC:
+		return first_value + second_value;
+	case BEEMU_OP_ADC:
+		return first_value + second_value + carry_flag;
+	case BEEMU_OP_SUB:
+	case BEEMU_OP_DEC:
+		return first_value - second_value;
+	case BEEMU_OP_SBC:
+		return first_value - second_value - carry_flag;
+	case BEEMU_OP_OR:
+		return first_value | second_value;
+	case BEEMU_OP_XOR:
+		return first_value ^ second_value;
+	case BEEMU_OP_AND:
+		return first_value & second_value;
+	case BEEMU_OP_CP:
+		return first_value - second_value;
+	default:
+		return -1;
+	}
+}
+
+uint8_t resolve_half_carry_for_arithmatic(
+    const uint16_t first_value,
+    const uint16_t second_value,
+    const uint8_t carry_flag,
+    const BeemuOperation operation)
+{
+	switch (operation) {
+	case BEEMU_OP_ADD:
+	case BEEMU_OP_INC:
+		return ((first_value & 0x0F) + (second_value & 0x0F) & 0x10) == 0x10;
+	case BEEMU_OP_ADC:
+		return (((first_value & 0x0F) + (second_value & 0x0F) + carry_flag) & 0x10) == 0x10;
+		;
+	case BEEMU_OP_SUB:
+	case BEEMU_OP_DEC:
+	case BEEMU_OP_CP:
+		return (((first_value & 0x0F) - (second_value & 0x0F)) & 0x10) == 0x10;
+	case BEEMU_OP_SBC:
+		return (((first_value & 0x0F) - (second_value & 0x0F) - carry_flag) & 0x10) == 0x10;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief Number of entries in the DAA table, one per value of A, N, H and C.
+ */
+#define BEEMU_ALU_DAA_TABLE_SIZE 2048
+
+// Outputs of ADD/ADC and SUB/SBC/CP, indexed by carry, first and second
+// operand, and of DAA indexed by N, H, C and A.
+static BeemuAluOutput ADD_TABLE[2][256][256];
+static BeemuAluOutput SUB_TABLE[2][256][256];
+static BeemuAluOutput DAA_TABLE[BEEMU_ALU_DAA_TABLE_SIZE];
+static BeemuOnce alu_tables_once = BEEMU_ONCE_INIT;
+
+/**
+ * @brief Compute the output of an arithmatic operation the slow way.
+ *
+ * Used to generate the tables, so that they agree with the result and
+ * half carry helpers above.
+ */
+static BeemuAluOutput compute_arithmatic_output(
+	const BeemuOperation operation,
+	const uint8_t first_value,
+	const uint8_t second_value,
+	const uint8_t carry_flag)
+{
+	const int32_t would_be_result = resolve_result_wo_overflow(first_value, second_value, operation, carry_flag);
+	const uint8_t actual_result = would_be_result;
+	const bool is_subtraction = operation == BEEMU_OP_SUB || operation == BEEMU_OP_SBC;
+	const uint8_t half_carry = resolve_half_carry_for_arithmatic(first_value, second_value, carry_flag, operation);
+	return actual_result << 8
+		| (actual_result == 0) << BEEMU_FLAG_Z
+		| is_subtraction << BEEMU_FLAG_N
+		| half_carry << BEEMU_FLAG_H
+		| (would_be_result != actual_result) << BEEMU_FLAG_C;
+}
+
+/**
+ * @brief Compute the output of DAA the slow way.
+ *
+ * Adjusts A back into binary coded decimal after an addition or a
+ * subtraction, depending on N, using H and C to tell which digits carried.
+ */
+static BeemuAluOutput compute_daa_output(const uint8_t value, const uint8_t flags)
+{
+	const bool subtraction = (flags >> BEEMU_FLAG_N) & 1;
+	const bool half_carry = (flags >> BEEMU_FLAG_H) & 1;
+	bool carry = (flags >> BEEMU_FLAG_C) & 1;
+	uint8_t correction = 0;
+	if (half_carry || (!subtraction && (value & 0x0F) > 0x09)) {
+		correction |= 0x06;
+	}
+	if (carry || (!subtraction && value > 0x99)) {
+		correction |= 0x60;
+		carry = true;
+	}
+	const uint8_t result = subtraction ? value - correction : value + correction;
+	return result << 8
+		| (result == 0) << BEEMU_FLAG_Z
+		| subtraction << BEEMU_FLAG_N
+		| carry << BEEMU_FLAG_C;
+}
+
+void beemu_alu_tables_build(void)
+{
+	if (!beemu_once_begin(&alu_tables_once)) {
+		return;
+	}
+	for (int carry = 0; carry < 2; carry++) {
+		for (int first = 0; first < 256; first++) {
+			for (int second = 0; second < 256; second++) {
+				ADD_TABLE[carry][first][second] = compute_arithmatic_output(BEEMU_OP_ADC, first, second, carry);
+				SUB_TABLE[carry][first][second] = compute_arithmatic_output(BEEMU_OP_SBC, first, second, carry);
+			}
+		}
+	}
+	for (int index = 0; index < BEEMU_ALU_DAA_TABLE_SIZE; index++) {
+		// N, H and C sit right above A in the index, as they do in F.
+		DAA_TABLE[index] = compute_daa_output(index & 0xFF, (index >> 8) << BEEMU_FLAG_C);
+	}
+	beemu_once_end(&alu_tables_once);
+}
+
+/**
+ * @brief Output of a bitwise operation, which only sets Z and, for AND, H.
+ */
+static inline BeemuAluOutput bitwise_output(const uint8_t result, const bool is_and)
+{
+	return result << 8 | (result == 0) << BEEMU_FLAG_Z | is_and << BEEMU_FLAG_H;
+}
+
+BeemuAluOutput beemu_alu_lookup(
+	const BeemuOperation operation,
+	const uint8_t first_value,
+	const uint8_t second_value,
+	const uint8_t flags)
+{
+	if (!beemu_once_is_done(&alu_tables_once)) {
+		beemu_alu_tables_build();
+	}
+	const uint8_t carry = (flags >> BEEMU_FLAG_C) & 1;
+	const uint8_t zero = flags & (1 << BEEMU_FLAG_Z);
+	switch (operation) {
+	case BEEMU_OP_ADD:
+	case BEEMU_OP_INC:
+		return ADD_TABLE[0][first_value][second_value];
+	case BEEMU_OP_ADC:
+		return ADD_TABLE[carry][first_value][second_value];
+	case BEEMU_OP_SUB:
+	case BEEMU_OP_DEC:
+	case BEEMU_OP_CP:
+		return SUB_TABLE[0][first_value][second_value];
+	case BEEMU_OP_SBC:
+		return SUB_TABLE[carry][first_value][second_value];
+	case BEEMU_OP_AND:
+		return bitwise_output(first_value & second_value, true);
+	case BEEMU_OP_OR:
+		return bitwise_output(first_value | second_value, false);
+	case BEEMU_OP_XOR:
+		return bitwise_output(first_value ^ second_value, false);
+	case BEEMU_OP_DAA:
+		return DAA_TABLE[((flags >> BEEMU_FLAG_C) & 0x07) << 8 | first_value];
+	case BEEMU_OP_CPL:
+		return (uint8_t)~first_value << 8 | zero | 1 << BEEMU_FLAG_N | 1 << BEEMU_FLAG_H | carry << BEEMU_FLAG_C;
+	case BEEMU_OP_SCF:
+		return first_value << 8 | zero | 1 << BEEMU_FLAG_C;
+	case BEEMU_OP_CCF:
+		return first_value << 8 | zero | !carry << BEEMU_FLAG_C;
+	default:
+		return first_value << 8 | (flags & 0xF0);
+	}
+}
+
+bool beemu_alu_has_operand_flags(const BeemuOperation operation)
+{
+	return operation <= BEEMU_OP_XOR;
+}
+
+bool beemu_alu_reads_flags(const BeemuOperation operation)
+{
+	return operation == BEEMU_OP_ADC || operation == BEEMU_OP_SBC || operation > BEEMU_OP_XOR;
+}
+
+uint8_t beemu_alu_flags(
+	const BeemuOperation operation,
+	const uint8_t first_value,
+	const uint8_t second_value,
+	const uint8_t carry_flag,
+	const bool preserve_carry,
+	const uint8_t flags)
+{
+	const uint8_t new_flags = beemu_alu_lookup(operation, first_value, second_value, carry_flag << BEEMU_FLAG_C);
+	// The unused lower nibble is left as is, like writing the flags one by one would.
+	const uint8_t kept_mask = preserve_carry ? 0x0F | (1 << BEEMU_FLAG_C) : 0x0F;
+	return (flags & kept_mask) | (new_flags & ~kept_mask);
+}
@@ -0,0 +1,109 @@
+/**
+ * @file alu.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Private header for the results and flags of 8 bit ALU operations.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_PROCESSOR_ALU_H
+#define BEEMU_PROCESSOR_ALU_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <beemu/device/primitives/instruction.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Calculate the result of an operation without truncating it.
+ *
+ * Result is an int32_t so that overflows and underflows can be detected by
+ * comparing it to its truncated self.
+ * @param first_value First operand, and the destination.
+ * @param second_value Second operand.
+ * @param operation Operation to perform.
+ * @param carry_flag Value of the C flag, used by ADC and SBC.
+ * @return The result, or -1 if the operation is not a binary operation.
+ */
+int32_t resolve_result_wo_overflow(uint16_t first_value, uint16_t second_value, BeemuOperation operation, uint8_t carry_flag);
+
+/**
+ * @brief Calculate the half carry flag of an operation.
+ *
+ * @param first_value First operand.
+ * @param second_value Second operand.
+ * @param carry_flag Value of the C flag, used by ADC and SBC.
+ * @param operation Operation to perform.
+ * @return 1 if the lower nibble carried or borrowed, 0 otherwise.
+ */
+uint8_t resolve_half_carry_for_arithmatic(uint16_t first_value, uint16_t second_value, uint8_t carry_flag, BeemuOperation operation);
+
+/**
+ * @brief Result of an 8 bit ALU operation in the upper byte, and the Z, N,
+ * H and C flags it leaves behind in the upper nibble of the lower byte.
+ */
+typedef uint16_t BeemuAluOutput;
+
+/**
+ * @brief Generate the ALU lookup tables, done once and on demand.
+ */
+void beemu_alu_tables_build(void);
+
+/**
+ * @brief Look up the output of an 8 bit ALU operation.
+ *
+ * ADD, ADC, SUB, SBC, CP, INC and DEC are read from tables indexed by the
+ * carry and the operands, and so is DAA, indexed by N, H, C and A. The
+ * flags are those the operation sets, callers that preserve C (INC and DEC)
+ * have to mask it themselves.
+ * @param operation Operation to perform.
+ * @param first_value First operand, A for DAA, CPL, SCF and CCF.
+ * @param second_value Second operand.
+ * @param flags Value of F before the operation.
+ * @return BeemuAluOutput Packed result and flags.
+ */
+BeemuAluOutput beemu_alu_lookup(BeemuOperation operation, uint8_t first_value, uint8_t second_value, uint8_t flags);
+
+/**
+ * @brief Check if the flags of an operation can be computed from its operands alone.
+ *
+ * These are the 8 bit ADD, ADC, SUB, SBC, AND, XOR, OR, CP, INC and DEC.
+ */
+bool beemu_alu_has_operand_flags(BeemuOperation operation);
+
+/**
+ * @brief Check if an operation reads the flags it runs on.
+ *
+ * These are ADC, SBC, DAA, CPL, SCF and CCF, the flags of a pending
+ * operation have to be materialised before looking them up.
+ */
+bool beemu_alu_reads_flags(BeemuOperation operation);
+
+/**
+ * @brief Compute the F register after an 8 bit ALU operation.
+ *
+ * @param operation Operation, see beemu_alu_has_operand_flags.
+ * @param first_value First operand.
+ * @param second_value Second operand.
+ * @param carry_flag Value of the C flag before the operation.
+ * @param preserve_carry Leave the C flag untouched, as INC and DEC do.
+ * @param flags Value of F before the operation.
+ * @return uint8_t Value of F after the operation.
+ */
+uint8_t beemu_alu_flags(
+	BeemuOperation operation,
+	uint8_t first_value,
+	uint8_t second_value,
+	uint8_t carry_flag,
+	bool preserve_carry,
+	uint8_t flags);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BEEMU_PROCESSOR_ALU_H
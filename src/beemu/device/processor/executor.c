@@ -1,200 +1,338 @@
+/**
+ * @file executor.c
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Executes instructions directly, without emitting commands.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
 #include <beemu/device/primitives/register.h>
 #include <beemu/device/processor/executor.h>
-#include <beemu/internals/logger.h>
 #include <beemu/internals/utility.h>
 
+#include "interpreter/parser/parse_arithmatic.h"
+#include "interpreter/parser/parse_bitwise.h"
+#include "interpreter/parser/parse_common.h"
+#include "interpreter/parser/parse_rot_shift.h"
+
+// Every function here mirrors the effect the commands emitted by its
+// counterpart in interpreter/parser would have once invoked, values are
+// resolved with the same helpers so both engines agree at instruction
+// boundaries.
+
 /**
- * @brief Resolve a param's value.
- *
- * A param's value depends on multiple factors,
- * its type, and whether or not it is a pointer.
+ * @brief Write an 8 bit value to the location a param names.
  *
- * When a parameter is a pointer, its value is
- * dereferenced by taking the value of the memory
- * by interpreting the value as a memory address.
- *
- * Register parameters are resolved to the value
- * of the respective register referred.
- *
- * @param registers Register file pointer.
- * @param memory Memory pointer.
- * @param param Parameter to be resolved.
- * @return int Integer value.
+ * Pointers are written to memory, 8 bit registers directly, anything
+ * else is not a valid destination and is ignored.
  */
-int resolve_param(BeemuRegisters* registers, BeemuMemory* memory, BeemuParam param)
+static void write_byte_to_param(BeemuProcessor *processor, const BeemuParam *param, const uint8_t value)
 {
-	BeemuRegister register_;
-	uint16_t param_value = 0;
-	switch (param.type) {
-	case BEEMU_PARAM_TYPE_REGISTER_8:
-		register_.type = BEEMU_EIGHT_BIT_REGISTER;
-		register_.name_of.eight_bit_register = param.value.register_8;
-		param_value = beemu_registers_read_register_value(registers, register_);
-		break;
-	case BEEMU_PARAM_TYPE_REGISTER_16:
-		register_.type = BEEMU_SIXTEEN_BIT_REGISTER;
-		register_.name_of.sixteen_bit_register = param.value.register_16;
-		param_value = beemu_registers_read_register_value(registers, register_);
-		break;
-	case BEEMU_PARAM_TYPE_UINT16:
-	case BEEMU_PARAM_TYPE_UINT_8:
-		// Both are hold in a uint16_t
-		param_value = param.value.value;
-		break;
-	case BEEMU_PARAM_TYPE_INT_8:
-		// This one is signed.
-		param_value = param.value.signed_value;
-		break;
+	if (param->pointer) {
+		const uint16_t address = beemu_resolve_instruction_parameter_unsigned(param, processor, true);
+		beemu_memory_write(processor->memory, address, value);
+	} else if (param->type == BEEMU_PARAM_TYPE_REGISTER_8) {
+		*beemu_registers_ptr_8(processor->registers, param->value.register_8) = value;
 	}
+}
 
-	// Dereference to memory if exists and if is a pointer.
-	if (param.pointer) {
-		return beemu_memory_read(memory, param_value);
-	} else {
-		// Otherwise return value itself.
-		return param_value;
+/**
+ * @brief Write a 16 bit register.
+ */
+static void write_register_16(BeemuProcessor *processor, const BeemuRegister_16 register_16, const uint16_t value)
+{
+	const BeemuRegister register_ = {
+		.type = BEEMU_SIXTEEN_BIT_REGISTER,
+		.name_of.sixteen_bit_register = register_16};
+	beemu_registers_write_register_value(processor->registers, register_, value);
+}
+
+/**
+ * @brief Push a 16 bit value to the stack, most significant byte first.
+ */
+static void push_stack(BeemuProcessor *processor, const uint16_t value)
+{
+	uint16_t stack_pointer = processor->registers->stack_pointer;
+	beemu_memory_write(processor->memory, --stack_pointer, value >> 8);
+	beemu_memory_write(processor->memory, --stack_pointer, value & 0xFF);
+	processor->registers->stack_pointer = stack_pointer;
+}
+
+/**
+ * @brief Read the little endian 16 bit value at the top of the stack.
+ */
+static uint16_t peek_stack(const BeemuProcessor *processor)
+{
+	const uint16_t stack_pointer = processor->registers->stack_pointer;
+	return beemu_memory_read(processor->memory, stack_pointer)
+		| (beemu_memory_read(processor->memory, (uint16_t)(stack_pointer + 1)) << 8);
+}
+
+/**
+ * @brief Pop a 16 bit value from the stack.
+ */
+static uint16_t pop_stack(BeemuProcessor *processor)
+{
+	const uint16_t value = peek_stack(processor);
+	processor->registers->stack_pointer += 2;
+	return value;
+}
+
+/**
+ * @brief Check if a param refers to the top of the stack, as PUSH and POP do.
+ */
+static bool is_stack_param(const BeemuParam *param)
+{
+	return param->type == BEEMU_PARAM_TYPE_REGISTER_16
+		&& param->pointer
+		&& param->value.register_16 == BEEMU_REGISTER_SP;
+}
+
+/**
+ * @brief Get the signed modifier of a post load operation.
+ */
+static int post_load_modifier(const BeemuPostLoadOperation operation)
+{
+	switch (operation) {
+	case BEEMU_POST_LOAD_INCREMENT_INDIRECT_SOURCE:
+	case BEEMU_POST_LOAD_INCREMENT_INDIRECT_DESTINATION:
+		return 1;
+	case BEEMU_POST_LOAD_DECREMENT_INDIRECT_SOURCE:
+	case BEEMU_POST_LOAD_DECREMENT_INDIRECT_DESTINATION:
+		return -1;
+	default:
+		return 0;
 	}
 }
 
 /**
- * @brief Write to... somewhere, dependening on a param.
+ * @brief Get the value the instruction register holds after the instruction.
  *
- * @param memory Memory object pointer.
- * @param registers Register file pointer.
- * @param param Parameter to dictate where to write.
- * @param value Value to write.
- * @param type Type of the location.
+ * The opcode is latched first, CB prefixed instructions then latch their
+ * second byte, and loads and jumps latch each operand byte as they decode it.
  */
-void write_to_param(BeemuRegisters* registers, BeemuMemory* memory, BeemuParam param, uint16_t value, bool is_eight_bit_write)
+static uint8_t latched_instruction_register(const BeemuInstruction *instruction)
 {
-	BeemuRegister register_;
-	uint16_t write_location;
-	const bool is_register = beemu_util_is_one_of_two(param.type, BEEMU_PARAM_TYPE_REGISTER_8, BEEMU_PARAM_TYPE_REGISTER_16);
-	if (is_register) {
-		// Set the register type regardless.
-		register_.type = param.type == BEEMU_PARAM_TYPE_REGISTER_8 ? BEEMU_EIGHT_BIT_REGISTER : BEEMU_SIXTEEN_BIT_REGISTER;
-		if (param.type == BEEMU_PARAM_TYPE_REGISTER_8) {
-			register_.name_of.eight_bit_register = param.value.register_8;
-		} else {
-			register_.name_of.sixteen_bit_register = param.value.register_16;
-		}
+	const uint32_t omc = instruction->original_machine_code;
+	const bool is_cb_prefixed = instruction->type == BEEMU_INSTRUCTION_TYPE_BITWISE
+		|| (instruction->type == BEEMU_INSTRUCTION_TYPE_ROT_SHIFT && instruction->byte_length == 2);
+	const bool latches_operands = (instruction->type == BEEMU_INSTRUCTION_TYPE_LOAD || instruction->type == BEEMU_INSTRUCTION_TYPE_JUMP)
+		&& instruction->byte_length > 1;
+	if (is_cb_prefixed || latches_operands) {
+		return omc & 0xFF;
+	}
+	uint8_t opcode = (omc & 0xFF0000) ? (omc & 0xFF0000) >> 16 : (omc & 0xFF00) >> 8;
+	if (!opcode) {
+		opcode = omc & 0xFF;
+	}
+	return opcode;
+}
 
-		// Now check if this is a pointer write.
+/**
+ * @brief Execute a single instruction of class LOAD.
+ */
+static void execute_load(BeemuProcessor *processor, const BeemuInstruction *instruction)
+{
+	const BeemuLoadParams *params = &instruction->params.load_params;
+	const BeemuParam *source = &params->source;
+	const BeemuParam *dest = &params->dest;
+	// Single byte loads reading memory may step SP or their source register
+	// before the write, this never targets the register being loaded, so
+	// it is applied last, after every value is read.
+	const bool steps_source = instruction->byte_length == 1
+		&& (source->pointer || dest->type == BEEMU_PARAM_TYPE_UINT16 || dest->type == BEEMU_PARAM_TYPE_UINT_8);
+	const bool pops = steps_source && is_stack_param(source);
+	const bool steps_source_register = steps_source && !pops
+		&& (params->postLoadOperation == BEEMU_POST_LOAD_INCREMENT_INDIRECT_SOURCE
+			|| params->postLoadOperation == BEEMU_POST_LOAD_DECREMENT_INDIRECT_SOURCE);
+	const uint16_t stepped_source = beemu_resolve_instruction_parameter_unsigned(source, processor, true)
+		+ post_load_modifier(params->postLoadOperation);
+	const uint16_t stack_pointer = processor->registers->stack_pointer;
 
-		if (param.pointer) {
-			// Then we shall take the register's value and
-			// write the value to the THAT address at the memory
-			write_location = beemu_registers_read_register_value(registers, register_);
-		} else {
-			// By the way, the other variant is much easier anyhow,
-			// just go
-			beemu_registers_write_register_value(registers, register_, value);
-			return;
+	if (is_stack_param(dest)) {
+		push_stack(processor, beemu_resolve_instruction_parameter_unsigned(source, processor, false));
+	} else if (dest->pointer && beemu_param_holds_double(source)) {
+		const uint16_t address = beemu_resolve_instruction_parameter_unsigned(dest, processor, true);
+		const uint16_t value = beemu_resolve_instruction_parameter_unsigned(source, processor, false);
+		beemu_memory_write(processor->memory, address, value & 0xFF);
+		beemu_memory_write(processor->memory, (uint16_t)(address + 1), value >> 8);
+	} else if (dest->pointer) {
+		const uint16_t address = beemu_resolve_instruction_parameter_unsigned(dest, processor, true);
+		const uint8_t value = beemu_resolve_instruction_parameter_unsigned(source, processor, false);
+		beemu_memory_write(processor->memory, address, value);
+		if (params->postLoadOperation == BEEMU_POST_LOAD_INCREMENT_INDIRECT_DESTINATION
+			|| params->postLoadOperation == BEEMU_POST_LOAD_DECREMENT_INDIRECT_DESTINATION) {
+			const uint16_t stepped_dest = address + post_load_modifier(params->postLoadOperation);
+			if (dest->type == BEEMU_PARAM_TYPE_REGISTER_16) {
+				write_register_16(processor, dest->value.register_16, stepped_dest);
+			} else {
+				*beemu_registers_ptr_8(processor->registers, dest->value.register_8) = stepped_dest;
+			}
 		}
+	} else if (params->postLoadOperation == BEEMU_POST_LOAD_SIGNED_PAYLOAD_SUM) {
+		// LD HL, SP + e8
+		const int offset = instruction->original_machine_code & 0xFF;
+		const uint8_t sp_lsb = stack_pointer & 0xFF;
+		uint8_t lsb_add_result;
+		const int carry = BEEMU_CKD_ADD(&lsb_add_result, sp_lsb, offset);
+		*beemu_registers_ptr_8(processor->registers, BEEMU_REGISTER_L) = lsb_add_result;
+		beemu_registers_flags_set_flag(processor->registers, BEEMU_FLAG_Z, 0);
+		beemu_registers_flags_set_flag(processor->registers, BEEMU_FLAG_N, 0);
+		beemu_registers_flags_set_flag(processor->registers, BEEMU_FLAG_H, (((sp_lsb & 0x0F) + (offset & 0x0F)) & 0x10) == 0x10);
+		beemu_registers_flags_set_flag(processor->registers, BEEMU_FLAG_C, carry);
+		*beemu_registers_ptr_8(processor->registers, BEEMU_REGISTER_H) = (stack_pointer >> 8) + carry;
 	} else {
-		// Otherwise the type HAS to be
-		// BEEMU_PARAM_TYPE_UINT_8 or BEEMU_PARAM_TYPE_UINT_16
-		// and MUST indicate location... I think.
-		write_location = param.value.value;
+		const uint16_t value = is_stack_param(source)
+			? peek_stack(processor)
+			: beemu_resolve_instruction_parameter_unsigned(source, processor, false);
+		if (dest->type == BEEMU_PARAM_TYPE_REGISTER_8) {
+			*beemu_registers_ptr_8(processor->registers, dest->value.register_8) = value;
+		} else {
+			write_register_16(processor, dest->value.register_16, value);
+		}
 	}
 
-	// Allright, if we got to this point, either we have a valid
-	// write location, or we are about to segfault. A logical person
-	// would try to do an error check, I am, however, not a logical person
-	// nor particularly intelligent, so...
-	if (is_eight_bit_write) {
-		beemu_memory_write(memory, write_location, value);
-	} else {
-		beemu_memory_write_16(memory, write_location, value);
+	if (pops) {
+		processor->registers->stack_pointer = stack_pointer + 2;
+	} else if (steps_source_register) {
+		write_register_16(processor, source->value.register_16, stepped_source);
 	}
 }
 
 /**
- * @brief Execute a single instruction of class LOAD_8 or LOAD_16.
- *
- * @param registers Register file pointer.
- * @param memory Memory pointer.
- * @param instruction Instruction to execute.
+ * @brief Set the flags of an 8 bit ALU operation.
+ * @param skip_c Leave the C flag untouched, as INC and DEC do.
  */
-void execute_load(BeemuRegisters* registers, BeemuMemory* memory, BeemuInstruction instruction)
+static void set_arithmatic_flags(
+	BeemuRegisters *registers,
+	const int32_t would_be_result,
+	const int32_t actual_result,
+	const BeemuOperation operation,
+	const uint8_t half_carry,
+	const bool skip_c)
 {
-	const uint16_t load_value = resolve_param(registers, memory, instruction.params.load_params.source);
-	write_to_param(registers, memory, instruction.params.load_params.dest, load_value, instruction.type == BEEMU_INSTRUCTION_TYPE_LOAD);
+	beemu_registers_flags_set_flag(registers, BEEMU_FLAG_Z, actual_result == 0);
+	beemu_registers_flags_set_flag(
+		registers,
+		BEEMU_FLAG_N,
+		operation == BEEMU_OP_SUB || operation == BEEMU_OP_CP || operation == BEEMU_OP_SBC || operation == BEEMU_OP_DEC);
+	if (operation == BEEMU_OP_XOR || operation == BEEMU_OP_OR || operation == BEEMU_OP_AND) {
+		beemu_registers_flags_set_flag(registers, BEEMU_FLAG_H, operation == BEEMU_OP_AND);
+		if (!skip_c) {
+			beemu_registers_flags_set_flag(registers, BEEMU_FLAG_C, 0);
+		}
+	} else {
+		beemu_registers_flags_set_flag(registers, BEEMU_FLAG_H, half_carry);
+		if (!skip_c) {
+			beemu_registers_flags_set_flag(registers, BEEMU_FLAG_C, would_be_result != actual_result);
+		}
+	}
 }
 
 /**
- * @brief Resolve a value to adjust to a given type.
- *
- * Calculate underflows, overflows, and positive adjustments as well.
- * @param num
- * @param paramType
- * @return int
+ * @brief Execute a single instruction of class ARITHMATIC.
  */
-uint16_t resolve_flows(int value, BeemuParamType resolve_to)
+static void execute_arithmatic(BeemuProcessor *processor, const BeemuInstruction *instruction)
 {
-	switch (resolve_to) {
-	case BEEMU_PARAM_TYPE_INT_8:
-	case BEEMU_PARAM_TYPE_UINT_8:
-	case BEEMU_PARAM_TYPE_REGISTER_8:
-		return (uint8_t)value;
-	case BEEMU_PARAM_TYPE_UINT16:
-	case BEEMU_PARAM_TYPE_REGISTER_16:
-		return (uint16_t)value;
-	default:
-		return value;
+	const BeemuArithmaticParams *params = &instruction->params.arithmatic_params;
+	const BeemuParam *dest = &params->dest_or_first;
+	const BeemuParam *source = &params->source_or_second;
+	const uint16_t first_value = beemu_resolve_instruction_parameter_unsigned(dest, processor, false);
+	const uint16_t second_value = beemu_resolve_instruction_parameter_unsigned(source, processor, false);
+	// Only the operations that read the flags materialise pending ones.
+	const bool reads_flags = beemu_alu_reads_flags(params->operation);
+	const uint8_t carry = reads_flags ? beemu_registers_flags_get_flag(processor->registers, BEEMU_FLAG_C) : 0;
+	const bool is_inc_dec = params->operation == BEEMU_OP_INC || params->operation == BEEMU_OP_DEC;
+
+	if (dest->pointer || dest->type == BEEMU_PARAM_TYPE_REGISTER_8) {
+		BeemuRegisters *registers = processor->registers;
+		const BeemuAluOutput output = beemu_alu_lookup(params->operation, first_value, second_value, registers->flags);
+		if (params->operation != BEEMU_OP_CP) {
+			write_byte_to_param(processor, dest, output >> 8);
+		}
+		if (processor->lazy_flags && beemu_alu_has_operand_flags(params->operation)) {
+			beemu_registers_flags_defer(
+				registers,
+				params->operation,
+				first_value,
+				second_value,
+				carry,
+				is_inc_dec);
+			return;
+		}
+		// Written in one go on top of the materialised flags, INC and DEC
+		// leave the carry alone.
+		beemu_registers_flags_materialise(registers);
+		const uint8_t kept_mask = is_inc_dec ? 0x0F | (1 << BEEMU_FLAG_C) : 0x0F;
+		registers->flags = (registers->flags & kept_mask) | (output & ~kept_mask);
+	} else if (dest->type == BEEMU_PARAM_TYPE_REGISTER_16 && is_inc_dec) {
+		// The IDU does not touch the flags.
+		write_register_16(processor, dest->value.register_16, resolve_result_wo_overflow(first_value, second_value, params->operation, carry));
+	} else {
+		// 16 bit additions run through the ALU a byte at a time, the
+		// higher half picks up the carry of the lower one.
+		const BeemuParamTuple dest_parts = beemu_explode_beemu_param(dest, processor);
+		const BeemuParamTuple source_parts = beemu_explode_beemu_param(source, processor);
+		const uint8_t dest_lower = beemu_resolve_instruction_parameter_unsigned(&dest_parts.lower, processor, true);
+		const uint8_t source_lower = beemu_resolve_instruction_parameter_unsigned(&source_parts.lower, processor, true);
+		const uint16_t dest_higher = beemu_resolve_instruction_parameter_unsigned(&dest_parts.higher, processor, true);
+		const uint16_t source_higher = beemu_resolve_instruction_parameter_unsigned(&source_parts.higher, processor, true);
+		const int32_t lower_result = resolve_result_wo_overflow(dest_lower, source_lower, BEEMU_OP_ADD, 0);
+		const uint8_t lower_carry = lower_result != (uint8_t)lower_result;
+		const int32_t higher_result = resolve_result_wo_overflow(dest_higher + lower_carry, source_higher, BEEMU_OP_ADD, 0);
+		write_byte_to_param(processor, &dest_parts.lower, lower_result);
+		write_byte_to_param(processor, &dest_parts.higher, higher_result);
+		set_arithmatic_flags(
+			processor->registers,
+			higher_result,
+			(uint8_t)higher_result,
+			BEEMU_OP_ADD,
+			resolve_half_carry_for_arithmatic(dest_higher + lower_carry, source_higher, 0, BEEMU_OP_ADD),
+			false);
 	}
 }
 
-void execute_arithmatic(BeemuRegisters* registers, BeemuMemory* memory, BeemuInstruction instruction)
+/**
+ * @brief Execute a single instruction of class ROT_SHIFT.
+ */
+static void execute_rot_shift(BeemuProcessor *processor, const BeemuInstruction *instruction)
 {
-	// First we need to resolve the operands.
-	const int operand_one = resolve_param(registers, memory, instruction.params.arithmatic_params.dest_or_first);
-	const int operand_two = resolve_param(registers, memory, instruction.params.arithmatic_params.source_or_second);
-	int result = operand_one;
-	// Do not assign the result.
-	bool silent = false;
-	// Then we need to take our operation upon it.
-	switch (instruction.params.arithmatic_params.operation) {
-	case BEEMU_OP_ADD:
-		result += operand_two;
-		break;
-	case BEEMU_OP_AND:
-		result &= operand_two;
-		break;
-	case BEEMU_OP_CP:
-		silent = true;
-	case BEEMU_OP_SUB:
-		result -= operand_two;
-		break;
-	case BEEMU_OP_XOR:
-		result ^= operand_two;
-		break;
-	case BEEMU_OP_OR:
-		result |= operand_two;
-		break;
-	}
-	// Great, now we will do a few things, first,
-	// we need to properly encode the result
-	// including the over/undef-flows.
-	uint16_t resolved_result = resolve_flows(result, instruction.params.arithmatic_params.dest_or_first.type);
-	// Calculate the flag states.
-	beemu_registers_flags_set_flag(registers, BEEMU_FLAG_Z, resolved_result == 0);
-	beemu_registers_flags_set_flag(registers, BEEMU_FLAG_C, resolved_result != result);
-	// Write the actual result.
-	if (!silent) {
-		write_to_param(
-		    registers,
-		    memory,
-		    instruction.params.arithmatic_params.dest_or_first,
-		    resolved_result,
-		    beemu_util_is_one_of_two(
-		        instruction.params.arithmatic_params.dest_or_first.type,
-		        BEEMU_PARAM_TYPE_REGISTER_8,
-		        BEEMU_PARAM_TYPE_UINT_8));
+	const BeemuRotShiftParams *params = &instruction->params.rot_shift_params;
+	const uint8_t value = beemu_resolve_instruction_parameter_unsigned(&params->target, processor, false);
+	const uint8_t carry = beemu_registers_flags_get_flag(processor->registers, BEEMU_FLAG_C);
+	uint8_t carry_out = 0;
+	const uint8_t result = resolve_rot_shift_op(value, carry, instruction->original_machine_code, &carry_out);
+	write_byte_to_param(processor, &params->target, result);
+	beemu_registers_flags_set_flag(processor->registers, BEEMU_FLAG_Z, !params->set_flags_to_zero && result == 0);
+	beemu_registers_flags_set_flag(processor->registers, BEEMU_FLAG_N, 0);
+	beemu_registers_flags_set_flag(processor->registers, BEEMU_FLAG_H, 0);
+	beemu_registers_flags_set_flag(processor->registers, BEEMU_FLAG_C, carry_out);
+}
+
+/**
+ * @brief Execute a single instruction of class BITWISE.
+ */
+static void execute_bitwise(BeemuProcessor *processor, const BeemuInstruction *instruction)
+{
+	const BeemuBitwiseParams *params = &instruction->params.bitwise_params;
+	const uint8_t value = beemu_resolve_instruction_parameter_unsigned(&params->target, processor, false);
+	const uint8_t result = resolve_bitwise_op(value, params->bit_number, params->operation);
+	if (params->operation == BEEMU_BIT_OP_BIT) {
+		beemu_registers_flags_set_flag(processor->registers, BEEMU_FLAG_Z, result);
+		beemu_registers_flags_set_flag(processor->registers, BEEMU_FLAG_N, 0);
+		beemu_registers_flags_set_flag(processor->registers, BEEMU_FLAG_H, 1);
+		return;
 	}
+	write_byte_to_param(processor, &params->target, result);
 }
 
-bool test_condition(BeemuRegisters* registers, BeemuJumpCondition condition)
+/**
+ * @brief Check if the condition of a conditional jump holds.
+ */
+static bool test_condition(BeemuRegisters *registers, const BeemuJumpCondition condition)
 {
 	const uint8_t zero = beemu_registers_flags_get_flag(registers, BEEMU_FLAG_Z);
 	const uint8_t carry = beemu_registers_flags_get_flag(registers, BEEMU_FLAG_C);
@@ -213,98 +351,98 @@ bool test_condition(BeemuRegisters* registers, BeemuJumpCondition condition)
 }
 
 /**
- * @brief Push to the stack a 16 bit value.
+ * @brief Execute a JUMP instruction
  *
- * @param registers
- * @param memory
- * @param value
- */
-void push_stack(BeemuRegisters* registers, BeemuMemory* memory, uint16_t value)
-{
-	beemu_log(BEEMU_LOG_INFO, "Pushing value 0x%X to stack.", value);
-	static const BeemuRegister sp = { .type = BEEMU_SIXTEEN_BIT_REGISTER, .name_of.sixteen_bit_register = BEEMU_REGISTER_SP };
-	const uint16_t current_sp = beemu_registers_read_register_value(registers, sp);
-	beemu_memory_write_16(memory, current_sp, value);
-	beemu_log(BEEMU_LOG_INFO, "Value of stack pointer before push was 0x%X.", current_sp);
-	beemu_log(BEEMU_LOG_INFO, "Updating stack pointer");
-	beemu_registers_write_register_value(registers, sp, current_sp - 2);
-	beemu_log(BEEMU_LOG_INFO, "Stack push complete.");
-}
-
-/**
- * @brief Pop from the stack a 16 bit value.
+ * This is a CALL, RET, JR, JP or RST instruction.
  *
- * @param registers
- * @param memory
- * @return uint16_t
+ * @return Elapsed M-cycles, which are fewer for conditional jumps not taken.
  */
-uint16_t pop_stack(BeemuRegisters* registers, BeemuMemory* memory)
+static uint8_t execute_jump(BeemuProcessor *processor, const BeemuInstruction *instruction)
 {
-	static const BeemuRegister sp = { .type = BEEMU_SIXTEEN_BIT_REGISTER, .name_of.sixteen_bit_register = BEEMU_REGISTER_SP };
-	const uint16_t current_sp = beemu_registers_read_register_value(registers, sp);
-	beemu_registers_write_register_value(registers, sp, current_sp + 2);
-	const uint16_t val = beemu_memory_read_16(memory, current_sp + 2);
-	return val;
+	const BeemuJumpParams *params = &instruction->params.jump_params;
+	const uint16_t next_address = processor->registers->program_counter + instruction->byte_length;
+	if (params->is_conditional && !test_condition(processor->registers, params->condition)) {
+		// Untaken jumps skip the jump cycle, untaken returns still spend
+		// one cycle checking the condition.
+		processor->registers->program_counter = next_address;
+		return instruction->byte_length > 2 ? instruction->byte_length : 2;
+	}
+	uint16_t new_address;
+	switch (params->type) {
+	case BEEMU_JUMP_TYPE_RET:
+		new_address = pop_stack(processor);
+		if (params->enable_interrupts) {
+			processor->interrupts_enabled = true;
+		}
+		break;
+	case BEEMU_JUMP_TYPE_CALL:
+	case BEEMU_JUMP_TYPE_RST:
+		push_stack(processor, next_address);
+		new_address = params->param.value.value;
+		break;
+	default:
+		if (params->is_relative) {
+			new_address = next_address + params->param.value.signed_value;
+		} else {
+			// Either an absolute address, or HL.
+			new_address = beemu_resolve_instruction_parameter_unsigned(&params->param, processor, false);
+		}
+		break;
+	}
+	processor->registers->program_counter = new_address;
+	return instruction->duration_in_clock_cycles;
 }
 
 /**
- * @brief Execute a JUMP instruction
- *
- * This is a CALL, RET, JR, JMP or RST instruction.
- *
- * @param memory
- * @param registers
- * @param instruction
+ * @brief Execute a CPU control instruction.
  */
-void execute_jump(BeemuMemory* memory, BeemuRegisters* registers, BeemuInstruction instruction)
+static void execute_cpu_control(BeemuProcessor *processor, const BeemuInstruction *instruction)
 {
-	static const BeemuRegister pc = { .type = BEEMU_SIXTEEN_BIT_REGISTER, .name_of.sixteen_bit_register = BEEMU_REGISTER_PC };
-	uint16_t current_address = registers->program_counter;
-	BeemuJumpParams params = instruction.params.jump_params;
-	// Could be a pointer, relative or direct addr.
-	const int addr_param = resolve_param(registers, memory, params.param);
-	if (params.is_conditional && !test_condition(registers, params.condition)) {
-		// Conditional jumps that do not fit the conditions are not executed.
-		return;
-	}
-	// Either non-conditional or true cond.
-	uint16_t new_address = 0x0; // RST
-	if (params.type == BEEMU_JUMP_TYPE_RET) {
-		// First up, RET is a special case where
-		// the addr is determined by the stack.
-		new_address = pop_stack(registers, memory);
-	} else if (params.is_relative) {
-		new_address = current_address + addr_param;
-	} else {
-		// Finally, it could be a direct jump.
-		// or a RST.
-		new_address = addr_param;
-	}
-
-	if (params.type == BEEMU_JUMP_TYPE_CALL) {
-		// Though, if it is a call, some extra
-		// stuff is needed.
-		// Store current address.
-		push_stack(registers, memory, current_address + 3);
+	switch (instruction->params.system_op) {
+	case BEEMU_CPU_OP_HALT:
+		processor->processor_state = BEEMU_DEVICE_HALT;
+		break;
+	case BEEMU_CPU_OP_STOP:
+		processor->processor_state = BEEMU_DEVICE_STOP;
+		break;
+	case BEEMU_CPU_OP_DISABLE_INTERRUPTS:
+		processor->interrupts_enabled = false;
+		// DI right after EI cancels it, see beemu_processor_run.
+		if (processor->processor_state == BEEMU_DEVICE_AWAITING_INTERRUPT_ENABLE) {
+			processor->processor_state = BEEMU_DEVICE_NORMAL;
+		}
+		break;
+	case BEEMU_CPU_OP_ENABLE_INTERRUPTS:
+		// EI takes effect after the next instruction.
+		processor->processor_state = BEEMU_DEVICE_AWAITING_INTERRUPT_ENABLE;
+		break;
+	default:
+		break;
 	}
-
-	// We can finally, actually, jump.
-	beemu_registers_write_register_value(registers, pc, new_address);
-	// TODO: Enable interrupts.
 }
 
-uint8_t execute_instruction(BeemuMemory* memory, BeemuRegisters* file, BeemuInstruction instruction)
+uint8_t beemu_executor_execute_instruction(BeemuProcessor *processor, const BeemuInstruction *instruction)
 {
-	switch (instruction.type) {
+	processor->instruction_register = latched_instruction_register(instruction);
+	switch (instruction->type) {
+	case BEEMU_INSTRUCTION_TYPE_JUMP:
+		return execute_jump(processor, instruction);
 	case BEEMU_INSTRUCTION_TYPE_LOAD:
-		execute_load(file, memory, instruction);
+		execute_load(processor, instruction);
 		break;
 	case BEEMU_INSTRUCTION_TYPE_ARITHMATIC:
+		execute_arithmatic(processor, instruction);
 		break;
-	case BEEMU_INSTRUCTION_TYPE_JUMP:
-		execute_jump(memory, file, instruction);
+	case BEEMU_INSTRUCTION_TYPE_ROT_SHIFT:
+		execute_rot_shift(processor, instruction);
+		break;
+	case BEEMU_INSTRUCTION_TYPE_BITWISE:
+		execute_bitwise(processor, instruction);
+		break;
+	case BEEMU_INSTRUCTION_TYPE_CPU_CONTROL:
+		execute_cpu_control(processor, instruction);
 		break;
 	}
-
-	return instruction.duration_in_clock_cycles;
+	processor->registers->program_counter += instruction->byte_length;
+	return instruction->duration_in_clock_cycles;
 }
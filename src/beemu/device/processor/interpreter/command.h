@@ -34,7 +34,9 @@ extern "C" {
 		BEEMU_WRITE_TARGET_IME,
 		// Reserved for internal gameboy features we do not use
 		// but want to emulate because why not.
-		BEEMU_WRITE_TARGET_INTERNAL
+		BEEMU_WRITE_TARGET_INTERNAL,
+		// Defers the flags of an ALU operation, see beemu_registers_flags_defer.
+		BEEMU_WRITE_TARGET_LAZY_FLAGS
 	} BeemuWriteTargetType;
 
 	typedef enum BeemuInternalTargetType {
@@ -44,6 +46,17 @@ extern "C" {
 		BEEMU_INTERNAL_WRITE_TARGET_INSTRUCTION_REGISTER
 	} BeemuInternalTargetType;
 
+	/**
+	 * Operation whose flags are deferred, its operands are held in the
+	 * write value as first << 8 | second.
+	 */
+	typedef struct BeemuLazyFlagsTarget {
+		/** A BeemuOperation. */
+		uint8_t operation;
+		uint8_t carry_flag;
+		bool preserve_carry;
+	} BeemuLazyFlagsTarget;
+
 	/**
 	 * Used to desribe where to write in the machine state.
 	 */
@@ -55,6 +68,7 @@ extern "C" {
 			uint16_t mem_addr;
 			BeemuFlag flag;
 			BeemuInternalTargetType internal_target;
+			BeemuLazyFlagsTarget lazy_flags;
 		} target;
 	} BeemuWriteTarget;
 
@@ -96,22 +110,27 @@ extern "C" {
 	} BeemuMachineCommand;
 
 
-	struct BeemuCommandQueueNode;
-
 	/**
-	 * Used internally in a command queue, holds a single command.
+	 * Maximum number of commands a queue can hold at once, the worst case
+	 * SM83 instruction (ADD HL, r16 and CALL cc, a16) emits well under this
+	 * many, must be a power of two so that indices can be masked.
 	 */
-	typedef struct BeemuCommandQueueNode {
-		BeemuMachineCommand* current;
-		struct BeemuCommandQueueNode* next;
-	} BeemuCommandQueueNode;
+#define BEEMU_COMMAND_QUEUE_CAPACITY 32
+
+	struct BeemuCommandSlots;
 
 	/**
-	 * Holds a ordered stream of commands.
+	 * Holds a ordered stream of commands, as a fixed-capacity ring buffer
+	 * stored inline, so that no allocations occur per command.
 	 */
 	typedef struct BeemuCommandQueue {
-		BeemuCommandQueueNode *first;
-		BeemuCommandQueueNode *last;
+		BeemuMachineCommand commands[BEEMU_COMMAND_QUEUE_CAPACITY];
+		/** Free running index of the next command to be dequeued. */
+		uint32_t head;
+		/** Free running index of the slot the next command will be enqueued to. */
+		uint32_t tail;
+		/** Where the parsers record their slots while the parse cache is built, null otherwise. */
+		struct BeemuCommandSlots *slots;
 	} BeemuCommandQueue;
 
 	/**
@@ -120,6 +139,12 @@ extern "C" {
 	 */
 	BeemuCommandQueue *beemu_command_queue_new();
 
+	/**
+	 * Initialise a command queue that lives in caller owned storage.
+	 * @param queue Queue to initialise, any existing commands are discarded.
+	 */
+	void beemu_command_queue_init(BeemuCommandQueue *queue);
+
 	/**
 	 * Free an existing command queue.
 	 * @param queue Queue to free.
@@ -128,8 +153,12 @@ extern "C" {
 
 	/**
 	 * Dequeue the next command from the command queue.
+	 *
+	 * The returned pointer points into the queue's own storage and stays valid
+	 * until BEEMU_COMMAND_QUEUE_CAPACITY more commands are enqueued, it must not
+	 * be freed.
 	 * @param queue Command queue to act on.
-	 * @return The next command on the queue.
+	 * @return The next command on the queue, or null if the queue is empty.
 	 */
 	BeemuMachineCommand *beemu_command_queue_dequeue(BeemuCommandQueue *queue);
 
@@ -142,6 +171,9 @@ extern "C" {
 
 	/**
 	 * Enqueue a command to the end of the queue.
+	 *
+	 * The command is copied into the queue, enqueueing to a full queue is
+	 * a programming error.
 	 * @param queue Queue to act on.
 	 * @param command Command to enqueue.
 	 */
@@ -154,6 +186,13 @@ extern "C" {
 	 */
 	bool beemu_command_queue_is_empty(BeemuCommandQueue *queue);
 
+	/**
+	 * Get the number of commands currently waiting in the queue.
+	 * @param queue Queue to check.
+	 * @return Number of commands in the queue.
+	 */
+	uint32_t beemu_command_queue_size(const BeemuCommandQueue *queue);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,241 @@
+/**
+ * @file invoker.c
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Executes the commands emitted by the parser.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "invoker.h"
+
+#include <beemu/device/memory.h>
+#include <beemu/device/processor/registers.h>
+
+// Computed goto is a GNU extension, other compilers fall back to the
+// function pointer table, both dispatch on the same index.
+#if defined(__GNUC__) || defined(__clang__)
+#define BEEMU_INVOKER_COMPUTED_GOTO
+#endif
+
+/**
+ * Dispatch index of halt commands, placed right after the write target types.
+ */
+#define BEEMU_INVOKER_HALT_INDEX (BEEMU_WRITE_TARGET_LAZY_FLAGS + 1)
+
+/**
+ * Map a command to its index in the dispatch table, writes are dispatched
+ * on their target type, halts are given the last slot.
+ */
+static inline uint8_t dispatch_index(const BeemuMachineCommand *command)
+{
+	return command->type == BEEMU_COMMAND_HALT ? BEEMU_INVOKER_HALT_INDEX : command->write.target.type;
+}
+
+static inline void invoke_write_register_16(BeemuProcessor *processor, const BeemuMachineCommand *command)
+{
+	const BeemuRegister register_ = {
+		.type = BEEMU_SIXTEEN_BIT_REGISTER,
+		.name_of.sixteen_bit_register = command->write.target.target.register_16};
+	beemu_registers_write_register_value(processor->registers, register_, command->write.value.value.double_value);
+}
+
+static inline void invoke_write_register_8(BeemuProcessor *processor, const BeemuMachineCommand *command)
+{
+	*beemu_registers_ptr_8(processor->registers, command->write.target.target.register_8) = command->write.value.value.byte_value;
+}
+
+static inline void invoke_write_memory(BeemuProcessor *processor, const BeemuMachineCommand *command)
+{
+	beemu_memory_write(processor->memory, command->write.target.target.mem_addr, command->write.value.value.byte_value);
+}
+
+static inline void invoke_write_flag(BeemuProcessor *processor, const BeemuMachineCommand *command)
+{
+	beemu_registers_flags_set_flag(processor->registers, command->write.target.target.flag, command->write.value.value.byte_value);
+}
+
+static inline void invoke_write_ime(BeemuProcessor *processor, const BeemuMachineCommand *command)
+{
+	processor->interrupts_enabled = command->write.value.value.byte_value;
+}
+
+static inline void invoke_write_internal(BeemuProcessor *processor, const BeemuMachineCommand *command)
+{
+	switch (command->write.target.target.internal_target) {
+	case BEEMU_INTERNAL_WRITE_TARGET_PROGRAM_COUNTER:
+		processor->registers->program_counter = command->write.value.value.double_value;
+		break;
+	case BEEMU_INTERNAL_WRITE_TARGET_INSTRUCTION_REGISTER:
+		processor->instruction_register = command->write.value.value.byte_value;
+		break;
+	default:
+		// Address and data buses are not modelled.
+		break;
+	}
+}
+
+static inline void invoke_write_lazy_flags(BeemuProcessor *processor, const BeemuMachineCommand *command)
+{
+	const BeemuLazyFlagsTarget *lazy_flags = &command->write.target.target.lazy_flags;
+	beemu_registers_flags_defer(
+		processor->registers,
+		lazy_flags->operation,
+		command->write.value.value.double_value >> 8,
+		command->write.value.value.double_value & 0xFF,
+		lazy_flags->carry_flag,
+		lazy_flags->preserve_carry);
+}
+
+/**
+ * Execute a halt command.
+ * @return true if the halt terminates the current M-cycle.
+ */
+static inline bool invoke_halt(BeemuProcessor *processor, const BeemuMachineCommand *command)
+{
+	if (command->halt.is_cycle_terminator) {
+		return true;
+	}
+	switch (command->halt.halt_operation) {
+	case BEEMU_CPU_OP_HALT:
+		processor->processor_state = BEEMU_DEVICE_HALT;
+		break;
+	case BEEMU_CPU_OP_STOP:
+		processor->processor_state = BEEMU_DEVICE_STOP;
+		break;
+	case BEEMU_CPU_OP_DISABLE_INTERRUPTS:
+		processor->interrupts_enabled = false;
+		// DI right after EI cancels it.
+		if (processor->processor_state == BEEMU_DEVICE_AWAITING_INTERRUPT_ENABLE) {
+			processor->processor_state = BEEMU_DEVICE_NORMAL;
+		}
+		break;
+	case BEEMU_CPU_OP_ENABLE_INTERRUPTS:
+		// EI takes effect after the next instruction.
+		processor->processor_state = BEEMU_DEVICE_AWAITING_INTERRUPT_ENABLE;
+		break;
+	default:
+		break;
+	}
+	return false;
+}
+
+#ifdef BEEMU_INVOKER_COMPUTED_GOTO
+
+bool beemu_invoker_invoke_cycle(BeemuProcessor *processor, BeemuCommandQueue *queue)
+{
+	// Parallel to BeemuWriteTargetType, with the halt at the end.
+	static void *const DISPATCH_TABLE[] = {
+		&&write_register_16,
+		&&write_register_8,
+		&&write_memory,
+		&&write_flag,
+		&&write_ime,
+		&&write_internal,
+		&&write_lazy_flags,
+		&&halt};
+	const BeemuMachineCommand *command;
+
+#define DISPATCH_NEXT                                            \
+	if (!(command = beemu_command_queue_dequeue(queue))) {       \
+		return false;                                            \
+	}                                                            \
+	goto *DISPATCH_TABLE[dispatch_index(command)]
+
+	DISPATCH_NEXT;
+write_register_16:
+	invoke_write_register_16(processor, command);
+	DISPATCH_NEXT;
+write_register_8:
+	invoke_write_register_8(processor, command);
+	DISPATCH_NEXT;
+write_memory:
+	invoke_write_memory(processor, command);
+	DISPATCH_NEXT;
+write_flag:
+	invoke_write_flag(processor, command);
+	DISPATCH_NEXT;
+write_ime:
+	invoke_write_ime(processor, command);
+	DISPATCH_NEXT;
+write_internal:
+	invoke_write_internal(processor, command);
+	DISPATCH_NEXT;
+write_lazy_flags:
+	invoke_write_lazy_flags(processor, command);
+	DISPATCH_NEXT;
+halt:
+	if (invoke_halt(processor, command)) {
+		return true;
+	}
+	DISPATCH_NEXT;
+#undef DISPATCH_NEXT
+}
+
+#else
+
+typedef bool (*BeemuInvokeFunction)(BeemuProcessor *, const BeemuMachineCommand *);
+
+// Thin wrappers so that every entry shares a signature, the return value
+// indicates whether the cycle has ended.
+#define DEFINE_WRITE_ENTRY(NAME)                                                                    \
+	static bool NAME##_entry(BeemuProcessor *processor, const BeemuMachineCommand *command)         \
+	{                                                                                               \
+		NAME(processor, command);                                                                   \
+		return false;                                                                               \
+	}
+
+DEFINE_WRITE_ENTRY(invoke_write_register_16)
+DEFINE_WRITE_ENTRY(invoke_write_register_8)
+DEFINE_WRITE_ENTRY(invoke_write_memory)
+DEFINE_WRITE_ENTRY(invoke_write_flag)
+DEFINE_WRITE_ENTRY(invoke_write_ime)
+DEFINE_WRITE_ENTRY(invoke_write_internal)
+DEFINE_WRITE_ENTRY(invoke_write_lazy_flags)
+
+static bool invoke_halt_entry(BeemuProcessor *processor, const BeemuMachineCommand *command)
+{
+	return invoke_halt(processor, command);
+}
+
+// Parallel to BeemuWriteTargetType, with the halt at the end.
+static const BeemuInvokeFunction DISPATCH_TABLE[] = {
+	&invoke_write_register_16_entry,
+	&invoke_write_register_8_entry,
+	&invoke_write_memory_entry,
+	&invoke_write_flag_entry,
+	&invoke_write_ime_entry,
+	&invoke_write_internal_entry,
+	&invoke_write_lazy_flags_entry,
+	&invoke_halt_entry};
+
+bool beemu_invoker_invoke_cycle(BeemuProcessor *processor, BeemuCommandQueue *queue)
+{
+	const BeemuMachineCommand *command;
+	while ((command = beemu_command_queue_dequeue(queue))) {
+		if (DISPATCH_TABLE[dispatch_index(command)](processor, command)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+#endif // BEEMU_INVOKER_COMPUTED_GOTO
+
+uint8_t beemu_invoker_invoke(
+	BeemuProcessor *processor,
+	BeemuCommandQueue *queue,
+	BeemuInvokerCycleCallback on_cycle,
+	void *context)
+{
+	uint8_t completed_cycles = 0;
+	while (beemu_invoker_invoke_cycle(processor, queue)) {
+		completed_cycles++;
+		if (on_cycle) {
+			on_cycle(context, processor);
+		}
+	}
+	return completed_cycles;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file invoker.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Private header file for the invoker, which executes BeemuMachineCommands.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_PROCESSOR_INTERPRETER_INVOKER_H
+#define BEEMU_PROCESSOR_INTERPRETER_INVOKER_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "command.h"
+#include <beemu/device/processor/processor.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+	/**
+	 * Called by the invoker at the end of every M-cycle so that the caller
+	 * can interleave other components with the processor.
+	 * @param context Opaque pointer passed to beemu_invoker_invoke.
+	 * @param processor Processor the cycle was executed on.
+	 */
+	typedef void (*BeemuInvokerCycleCallback)(void *context, BeemuProcessor *processor);
+
+	/**
+	 * @brief Invoke commands until the end of the current M-cycle.
+	 *
+	 * Execute commands from the queue, one by one, until a cycle terminating
+	 * halt is hit or the queue is exhausted.
+	 * @param processor Processor to act on.
+	 * @param queue Queue to consume commands from.
+	 * @return true if the cycle ended on a cycle terminator, false if the queue ran out.
+	 */
+	bool beemu_invoker_invoke_cycle(BeemuProcessor *processor, BeemuCommandQueue *queue);
+
+	/**
+	 * @brief Invoke every command in a queue.
+	 *
+	 * @param processor Processor to act on.
+	 * @param queue Queue to consume, empty on return.
+	 * @param on_cycle Optional callback, called after each completed M-cycle.
+	 * @param context Passed to on_cycle as is.
+	 * @return Number of M-cycles completed, ie: cycle terminators hit.
+	 */
+	uint8_t beemu_invoker_invoke(
+		BeemuProcessor *processor,
+		BeemuCommandQueue *queue,
+		BeemuInvokerCycleCallback on_cycle,
+		void *context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BEEMU_PROCESSOR_INTERPRETER_INVOKER_H
@@ -0,0 +1,122 @@
+/**
+ * @file command_slot.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Descriptions of how the parsers compute the values they emit.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_COMMAND_SLOT_H
+#define BEEMU_COMMAND_SLOT_H
+#include "../command.h"
+#include <stdbool.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Where the value of a slot is read from, before any offset or dereference.
+ */
+typedef enum BeemuCommandSlotBase {
+	/** Value is the offset, which is also the one stored in the command. */
+	BEEMU_SLOT_BASE_CONSTANT,
+	BEEMU_SLOT_BASE_PROGRAM_COUNTER,
+	BEEMU_SLOT_BASE_REGISTER_8,
+	BEEMU_SLOT_BASE_REGISTER_16,
+	/** Last byte of the instruction. */
+	BEEMU_SLOT_BASE_OPERAND_8,
+	/** Little endian 16 bit operand of the instruction. */
+	BEEMU_SLOT_BASE_OPERAND_16,
+	/** Result of the ALU or bit operation on the recorded operands. */
+	BEEMU_SLOT_BASE_RESULT,
+	/** Bit of the ALU output for the flag the command writes. */
+	BEEMU_SLOT_BASE_RESULT_FLAG,
+	/** Recorded operands as first << 8 | second, for deferred flags. */
+	BEEMU_SLOT_BASE_OPERANDS,
+	/** Value cannot be described by a slot. */
+	BEEMU_SLOT_BASE_OPAQUE
+} BeemuCommandSlotBase;
+
+typedef enum BeemuCommandSlotDereference {
+	BEEMU_SLOT_DEREFERENCE_NONE,
+	BEEMU_SLOT_DEREFERENCE_BYTE,
+	BEEMU_SLOT_DEREFERENCE_DOUBLE
+} BeemuCommandSlotDereference;
+
+typedef enum BeemuCommandSlotSelect {
+	BEEMU_SLOT_SELECT_FULL,
+	BEEMU_SLOT_SELECT_LOWER,
+	BEEMU_SLOT_SELECT_HIGHER
+} BeemuCommandSlotSelect;
+
+/**
+ * @brief Describes how to compute a value in a command skeleton.
+ *
+ * Value is computed as select(dereference(base + offset)).
+ */
+typedef struct BeemuCommandSlot {
+	uint8_t base;
+	/** Either a BeemuRegister_8 or a BeemuRegister_16, depending on the base. */
+	uint8_t register_;
+	uint8_t dereference;
+	uint8_t select;
+	uint16_t offset;
+} BeemuCommandSlot;
+
+/**
+ * @brief Slots of every command a parser emitted into a queue.
+ *
+ * Set as the slots of a queue while the parse cache is built, every
+ * command records how its value (and memory address) was computed.
+ */
+typedef struct BeemuCommandSlots {
+	BeemuCommandSlot values[BEEMU_COMMAND_QUEUE_CAPACITY];
+	BeemuCommandSlot addresses[BEEMU_COMMAND_QUEUE_CAPACITY];
+	/** Operands of the operation the result slots refer to. */
+	BeemuCommandSlot operands[2];
+	bool has_operands;
+	/** A value was emitted that no slot describes. */
+	bool opaque;
+} BeemuCommandSlots;
+
+static inline BeemuCommandSlot beemu_slot_constant(const uint16_t value)
+{
+	const BeemuCommandSlot slot = {.base = BEEMU_SLOT_BASE_CONSTANT, .offset = value};
+	return slot;
+}
+
+static inline BeemuCommandSlot beemu_slot_of(const BeemuCommandSlotBase base)
+{
+	const BeemuCommandSlot slot = {.base = base};
+	return slot;
+}
+
+static inline BeemuCommandSlot beemu_slot_program_counter(const uint16_t offset)
+{
+	const BeemuCommandSlot slot = {.base = BEEMU_SLOT_BASE_PROGRAM_COUNTER, .offset = offset};
+	return slot;
+}
+
+static inline BeemuCommandSlot beemu_slot_register_16(const BeemuRegister_16 register_, const uint16_t offset)
+{
+	const BeemuCommandSlot slot = {.base = BEEMU_SLOT_BASE_REGISTER_16, .register_ = register_, .offset = offset};
+	return slot;
+}
+
+/**
+ * @brief Select the lower or the higher byte of a slot.
+ */
+static inline BeemuCommandSlot beemu_slot_select(BeemuCommandSlot slot, const BeemuCommandSlotSelect select)
+{
+	slot.select = select;
+	return slot;
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif // BEEMU_COMMAND_SLOT_H
@@ -11,60 +11,6 @@
 
 #include "parse_arithmatic.h"
 
-/**
- * Calculate the result of an operation as int32_t so that overflow/underflow won't occur.
- * @return
- */
-int32_t resolve_result_wo_overflow(const uint16_t first_value, const uint16_t second_value, const BeemuOperation operation, const uint8_t carry_flag)
-{
-	switch (operation) {
-	case BEEMU_OP_ADD:
-	case BEEMU_OP_INC:
-		return first_value + second_value;
-	case BEEMU_OP_ADC:
-		return first_value + second_value + carry_flag;
-	case BEEMU_OP_SUB:
-	case BEEMU_OP_DEC:
-		return first_value - second_value;
-	case BEEMU_OP_SBC:
-		return first_value - second_value - carry_flag;
-	case BEEMU_OP_OR:
-		return first_value | second_value;
-	case BEEMU_OP_XOR:
-		return first_value ^ second_value;
-	case BEEMU_OP_AND:
-		return first_value & second_value;
-	case BEEMU_OP_CP:
-		return first_value - second_value;
-	default:
-		return -1;
-	}
-}
-
-uint8_t resolve_half_carry_for_arithmatic(
-    const uint16_t first_value,
-    const uint16_t second_value,
-    const uint8_t carry_flag,
-    const BeemuOperation operation)
-{
-	switch (operation) {
-	case BEEMU_OP_ADD:
-	case BEEMU_OP_INC:
-		return ((first_value & 0x0F) + (second_value & 0x0F) & 0x10) == 0x10;
-	case BEEMU_OP_ADC:
-		return (((first_value & 0x0F) + (second_value & 0x0F) + carry_flag) & 0x10) == 0x10;
-		;
-	case BEEMU_OP_SUB:
-	case BEEMU_OP_DEC:
-	case BEEMU_OP_CP:
-		return (((first_value & 0x0F) - (second_value & 0x0F)) & 0x10) == 0x10;
-	case BEEMU_OP_SBC:
-		return (((first_value & 0x0F) - (second_value & 0x0F) - carry_flag) & 0x10) == 0x10;
-	default:
-		return 0;
-	}
-}
-
 /**
  * Insert flag write orders to the queue given the projected and actual result
  * and the executed operation.
@@ -78,31 +24,48 @@ void beemu_cq_write_flags(
 	const bool skip_c
 	)
 {
-	beemu_cq_write_flag(queue, BEEMU_FLAG_Z, actual_result == 0);
-	beemu_cq_write_flag(queue, BEEMU_FLAG_N, operation == BEEMU_OP_SUB || operation == BEEMU_OP_CP || operation == BEEMU_OP_SBC || operation == BEEMU_OP_DEC);
+	// The 16 bit additions these are written for are never cached.
+	const BeemuCommandSlot opaque = beemu_slot_of(BEEMU_SLOT_BASE_OPAQUE);
+	beemu_cq_write_flag(queue, BEEMU_FLAG_Z, actual_result == 0, opaque);
+	beemu_cq_write_flag(queue, BEEMU_FLAG_N, operation == BEEMU_OP_SUB || operation == BEEMU_OP_CP || operation == BEEMU_OP_SBC || operation == BEEMU_OP_DEC, opaque);
 	if (operation == BEEMU_OP_XOR || operation == BEEMU_OP_OR) {
 		// XOR and OR specifically set H and C to 0
-		beemu_cq_write_flag(queue, BEEMU_FLAG_H, 0);
+		beemu_cq_write_flag(queue, BEEMU_FLAG_H, 0, opaque);
 		if (!skip_c) {
-			beemu_cq_write_flag(queue, BEEMU_FLAG_C,  0);
+			beemu_cq_write_flag(queue, BEEMU_FLAG_C, 0, opaque);
 		}
 	} else if (operation == BEEMU_OP_AND) {
 		// AND is a bit different and set half-carry to 1 but carry to 0
-		beemu_cq_write_flag(queue, BEEMU_FLAG_H, 1);
+		beemu_cq_write_flag(queue, BEEMU_FLAG_H, 1, opaque);
 		if (!skip_c) {
-			beemu_cq_write_flag(queue, BEEMU_FLAG_C,  0);
+			beemu_cq_write_flag(queue, BEEMU_FLAG_C, 0, opaque);
 		}
 	} else {
 		// For normal arithmatic operations, we just check if the actual flow overflowed 0x0F for half-carry
 		// and 0xFF for carry, or alternativelly for SBC, we check if it underflowed.
 		// TODO: Unsure about the behaviour of H Flag for SUB and SBC operations.
-		beemu_cq_write_flag(queue, BEEMU_FLAG_H,  half_carry_flag_value);
+		beemu_cq_write_flag(queue, BEEMU_FLAG_H, half_carry_flag_value, opaque);
 		if (!skip_c) {
-			beemu_cq_write_flag(queue, BEEMU_FLAG_C, would_be_result != actual_result);
+			beemu_cq_write_flag(queue, BEEMU_FLAG_C, would_be_result != actual_result, opaque);
 		}
 	}
 }
 
+/**
+ * Insert flag write orders to the queue for the flags packed in an ALU
+ * lookup output.
+ */
+void beemu_cq_write_alu_flags(BeemuCommandQueue *queue, const BeemuAluOutput output, const bool skip_c)
+{
+	const BeemuCommandSlot flag_slot = beemu_slot_of(BEEMU_SLOT_BASE_RESULT_FLAG);
+	beemu_cq_write_flag(queue, BEEMU_FLAG_Z, (output >> BEEMU_FLAG_Z) & 1, flag_slot);
+	beemu_cq_write_flag(queue, BEEMU_FLAG_N, (output >> BEEMU_FLAG_N) & 1, flag_slot);
+	beemu_cq_write_flag(queue, BEEMU_FLAG_H, (output >> BEEMU_FLAG_H) & 1, flag_slot);
+	if (!skip_c) {
+		beemu_cq_write_flag(queue, BEEMU_FLAG_C, (output >> BEEMU_FLAG_C) & 1, flag_slot);
+	}
+}
+
 /**
  * Check if the given parameter is a HL pointer.
  */
@@ -146,21 +109,25 @@ static bool do_param_hold_byte_length_values(const BeemuParam *param)
  * @param dst Parameter specifying the destination.
  * @param result Result value to write
  * @param processor BeemuProcessor to resolve the actual values.
+ * @param instruction Instruction the destination belongs to.
+ * @param result_slot Slot of the result.
  */
 void beemu_cq_write_results_u8(
 	BeemuCommandQueue *queue,
 	const BeemuParam *dst,
 	const uint8_t result,
-	const BeemuProcessor *processor)
+	const BeemuProcessor *processor,
+	const BeemuInstruction *instruction,
+	const BeemuCommandSlot result_slot)
 {
 	if (dst->pointer) {
 		// We will write to memory.
 		// We can just use the resolve_instruction_param function to get the value
 		// which we now is the mem addr, and then we can emit the memory write.
 		const uint16_t memory_addr = beemu_resolve_instruction_parameter_unsigned(dst, processor, true);
-		beemu_cq_write_memory(queue, memory_addr, result);
+		beemu_cq_write_memory(queue, memory_addr, result, beemu_slot_param(dst, instruction, true), result_slot);
 	} else if (dst->type == BEEMU_PARAM_TYPE_REGISTER_8) {
-		beemu_cq_write_reg_8(queue, dst->value.register_8, result);
+		beemu_cq_write_reg_8(queue, dst->value.register_8, result, result_slot);
 	}
 }
 
@@ -171,6 +138,7 @@ void beemu_cq_write_results_u8(
  * @param src Parameter specifying the source.
  * @param result Result value to write
  * @param processor BeemuProcessor to resolve the actual values.
+ * @param instruction Instruction the parameters belong to.
  * @param is_idu_op If set to true, it means this instruction is executed on the INCREMENT DECREMENT UNIT.
  */
 void beemu_cq_write_results_u16(
@@ -179,10 +147,12 @@ void beemu_cq_write_results_u16(
 	const BeemuParam *src,
 	const uint16_t result,
 	const BeemuProcessor *processor,
+	const BeemuInstruction *instruction,
 	const bool is_idu_op)
 {
 	if (is_idu_op) {
-		beemu_cq_write_reg_16(queue, dst->value.register_16, result);
+		const uint16_t step = instruction->params.arithmatic_params.operation == BEEMU_OP_INC ? 1 : 0xFFFF;
+		beemu_cq_write_reg_16(queue, dst->value.register_16, result, beemu_slot_register_16(dst->value.register_16, step));
 		// The cycle stops here, perhaps to restore PC? or a quirk
 		// of the IDU?
 		beemu_cq_halt_cycle(queue);
@@ -206,7 +176,9 @@ void beemu_cq_write_results_u16(
 		// Also get the half carry result to emit the HC.
 		const uint8_t lower_half_carry = resolve_half_carry_for_arithmatic(dst_lower_content, src_lower_content, 0, BEEMU_OP_ADD);
 		// Now emit the result for the lower part AND its flags.
-		beemu_cq_write_results_u8(queue, &dst_parts.lower, lsb_actual_result, processor);
+		// The flags of the halves are not slots, so these are never cached.
+		const BeemuCommandSlot opaque = beemu_slot_of(BEEMU_SLOT_BASE_OPAQUE);
+		beemu_cq_write_results_u8(queue, &dst_parts.lower, lsb_actual_result, processor, instruction, opaque);
 		beemu_cq_write_flags(queue, lsb_wo_overflow, lsb_actual_result, BEEMU_OP_ADD, lower_half_carry, false);
 		// and HALT
 		beemu_cq_halt_cycle(queue);
@@ -220,7 +192,7 @@ void beemu_cq_write_results_u16(
 		const int32_t msb_wo_overflow = resolve_result_wo_overflow(dst_higher_content + lsb_carry, src_higher_content, BEEMU_OP_ADD, 0);
 		const uint8_t msb_actual_result = msb_wo_overflow;
 		const uint8_t msb_half_carry = resolve_half_carry_for_arithmatic(dst_higher_content + lsb_carry, src_higher_content, BEEMU_OP_ADD, 0);
-		beemu_cq_write_results_u8(queue, &dst_parts.higher, msb_actual_result, processor);
+		beemu_cq_write_results_u8(queue, &dst_parts.higher, msb_actual_result, processor, instruction, opaque);
 		beemu_cq_write_flags(queue, msb_wo_overflow, msb_actual_result, BEEMU_OP_ADD, msb_half_carry, false);
 	}
 }
@@ -263,55 +235,64 @@ void parse_arithmatic(BeemuCommandQueue *queue, const BeemuProcessor *processor,
 		second_value = beemu_resolve_instruction_parameter_unsigned(&params.source_or_second, processor, false);
 	}
 
-	// Actually calculate the results
-	const int32_t operation_result = resolve_result_wo_overflow(
-		first_value,
-		second_value,
-		params.operation,
-		beemu_registers_flags_get_flag(processor->registers, BEEMU_FLAG_C));
-	// Half carry is better calculated from the raw params.
-	const uint8_t half_carry_result = resolve_half_carry_for_arithmatic(
-		first_value,
-		second_value,
-		beemu_registers_flags_get_flag(processor->registers, BEEMU_FLAG_C),
-		params.operation
-	);
-
-	// This parameter is used to later handle the over/underflows.
-	uint32_t actual_result = 0;
-
 	// 16 bit increment decrement operations use a special piece of hardware called IDU
 	// that does not emit flag updates.
 	bool is_idu_op = params.dest_or_first.type == BEEMU_PARAM_TYPE_REGISTER_16 && is_op_inc_dec(&params);
 	if (do_param_hold_byte_length_values(&params.dest_or_first)) {
-		// Then we must convert to UINT8_T since destination holds 8 bits.
-		const uint8_t actual_result_size_corrected = operation_result;
+		// 8 bit results and flags come straight out of the ALU tables, only
+		// the operations that read the flags need pending ones computed.
+		// Parsing leaves them pending, the commands materialise them.
+		const bool reads_flags = beemu_alu_reads_flags(params.operation);
+		beemu_cq_record_operands(
+			queue,
+			beemu_slot_param(&params.dest_or_first, instruction, false),
+			beemu_slot_param(&params.source_or_second, instruction, false));
+		const uint8_t flags = reads_flags ? beemu_registers_flags_peek(processor->registers) : processor->registers->flags;
+		const BeemuAluOutput output = beemu_alu_lookup(
+			params.operation,
+			first_value,
+			second_value,
+			flags);
 		if (params.operation != BEEMU_OP_CP) {
 			// Compare operation does not actually modify the contents of the destination.
 			beemu_cq_write_results_u8(
 				queue,
 				&params.dest_or_first,
-				actual_result_size_corrected,
-				processor);
+				output >> 8,
+				processor,
+				instruction,
+				beemu_slot_of(BEEMU_SLOT_BASE_RESULT));
+		}
+		// INC and DEC leave the carry alone.
+		const bool skip_c = is_op_inc_dec(&params);
+		if (processor->lazy_flags && beemu_alu_has_operand_flags(params.operation)) {
+			// A single command instead of the four flag writes.
+			beemu_cq_write_lazy_flags(
+				queue,
+				params.operation,
+				first_value,
+				second_value,
+				reads_flags ? (flags >> BEEMU_FLAG_C) & 1 : 0,
+				skip_c);
+		} else {
+			beemu_cq_write_alu_flags(queue, output, skip_c);
 		}
-		actual_result = actual_result_size_corrected;
 	} else {
-		// For 16 bit holding values.
-		const uint16_t actual_result_size_corrected = operation_result;
+		// For 16 bit holding values, which handle their own flags. ADD, INC
+		// and DEC never take the carry in.
+		const uint16_t actual_result_size_corrected = resolve_result_wo_overflow(
+			first_value,
+			second_value,
+			params.operation,
+			0);
 		beemu_cq_write_results_u16(
 			queue,
 			&params.dest_or_first,
 			&params.source_or_second,
 			actual_result_size_corrected,
 			processor,
+			instruction,
 			is_idu_op);
-		actual_result = actual_result_size_corrected;
-	}
-	// Finally generate write orders for the flag values.
-	// IDU ops do not emit write orders.
-	if (do_param_hold_byte_length_values(&params.dest_or_first)) {
-		// 16 bits handle their own flags.
-		beemu_cq_write_flags(queue, operation_result, actual_result, params.operation, half_carry_result, instruction->original_machine_code < 0x40);
 	}
 	if (halts_after_flags(instruction)) {
 		beemu_cq_halt_cycle(queue);
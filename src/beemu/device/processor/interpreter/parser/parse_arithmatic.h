@@ -12,6 +12,7 @@
 #ifndef BEEMU_PARSE_ARITHMATIC_H
 #define BEEMU_PARSE_ARITHMATIC_H
 #include "parse_common.h"
+#include "../../alu.h"
 #include <beemu/device/processor/processor.h>
 
 /**
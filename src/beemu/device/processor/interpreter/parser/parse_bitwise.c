@@ -47,6 +47,9 @@ void parse_bitwise(BeemuCommandQueue *queue, const BeemuProcessor *processor, co
 		target_value = beemu_resolve_instruction_parameter_unsigned(&params->target, processor, true);
 	}
 
+	beemu_cq_record_operands(queue, beemu_slot_param(&params->target, instruction, false), beemu_slot_constant(0));
+	const BeemuCommandSlot result_slot = beemu_slot_of(BEEMU_SLOT_BASE_RESULT);
+
 	// Now, calculate the goddamn thing.
 	uint8_t result = resolve_bitwise_op(target_value, params->bit_number, params->operation);
 
@@ -54,9 +57,9 @@ void parse_bitwise(BeemuCommandQueue *queue, const BeemuProcessor *processor, co
 		// This only emits flags, and then quits!
 		// Take note that it does not matter if we derefed HL
 		// since we do not write back.
-		beemu_cq_write_flag(queue, BEEMU_FLAG_Z, result);
-		beemu_cq_write_flag(queue, BEEMU_FLAG_N, 0);
-		beemu_cq_write_flag(queue, BEEMU_FLAG_H, 1);
+		beemu_cq_write_flag(queue, BEEMU_FLAG_Z, result, result_slot);
+		beemu_cq_write_flag(queue, BEEMU_FLAG_N, 0, beemu_slot_constant(0));
+		beemu_cq_write_flag(queue, BEEMU_FLAG_H, 1, beemu_slot_constant(1));
 		return;
 	}
 
@@ -66,10 +69,10 @@ void parse_bitwise(BeemuCommandQueue *queue, const BeemuProcessor *processor, co
 	if (has_hl_deref) {
 		// If memory, we deref hl and write to it, then halt before moving on to M5
 		const uint16_t value_of_hl = beemu_resolve_instruction_parameter_unsigned(&params->target, processor, true);
-		beemu_cq_write_memory(queue, value_of_hl, result);
+		beemu_cq_write_memory(queue, value_of_hl, result, beemu_slot_param(&params->target, instruction, true), result_slot);
 		beemu_cq_halt_cycle(queue);
 	} else {
 		// Otherwise we instead emit to register directly and run.
-		beemu_cq_write_reg_8(queue, params->target.value.register_8, result);
+		beemu_cq_write_reg_8(queue, params->target.value.register_8, result, result_slot);
 	}
 }
@@ -25,4 +25,14 @@
  */
 void parse_bitwise(BeemuCommandQueue *queue, const BeemuProcessor *processor, const BeemuInstruction *instruction);
 
+/**
+ * @brief Calculate the result of a bitwise operation on a value.
+ *
+ * @param value Value to act on.
+ * @param targeted_bit nth bit of the byte will be acted upon.
+ * @param operation_type Type of the operation to perform.
+ * @return For BIT, the value of the bit, otherwise the modified value.
+ */
+uint8_t resolve_bitwise_op(uint8_t value, uint8_t targeted_bit, BeemuBitOperation operation_type);
+
 #endif // BEEMU_PARSE_BITWISE_H
@@ -0,0 +1,238 @@
+/**
+ * @file parse_cache.c
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Per opcode cache of pre-parsed command skeletons.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "parse_cache.h"
+#include "parse_bitwise.h"
+#include "parser.h"
+#include "../../alu.h"
+
+#include <beemu/device/memory.h>
+#include <beemu/device/processor/registers.h>
+#include <beemu/device/processor/tokenizer.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../../../internals/once.h"
+
+// Skeletons of processors without and with lazy flags.
+static BeemuCommandSkeleton *UNPREFIXED_SKELETONS[2][256];
+static BeemuCommandSkeleton *CB_PREFIXED_SKELETONS[2][256];
+static BeemuOnce skeletons_once = BEEMU_ONCE_INIT;
+
+/**
+ * Compute the value of a slot for the given processor state and machine code.
+ */
+static uint16_t evaluate_slot(const BeemuCommandSlot *slot, const BeemuProcessor *processor, const uint32_t original_machine_code)
+{
+	uint16_t value = 0;
+	switch (slot->base) {
+	case BEEMU_SLOT_BASE_PROGRAM_COUNTER:
+		value = processor->registers->program_counter;
+		break;
+	case BEEMU_SLOT_BASE_REGISTER_8:
+		value = *beemu_registers_ptr_8(processor->registers, slot->register_);
+		break;
+	case BEEMU_SLOT_BASE_REGISTER_16:
+		value = beemu_resolve_register_16(processor, slot->register_);
+		break;
+	case BEEMU_SLOT_BASE_OPERAND_8:
+		value = original_machine_code & 0xFF;
+		break;
+	case BEEMU_SLOT_BASE_OPERAND_16:
+		// Operands are little endian.
+		value = ((original_machine_code & 0xFF) << 8) | ((original_machine_code >> 8) & 0xFF);
+		break;
+	default:
+		break;
+	}
+	value += slot->offset;
+	switch (slot->dereference) {
+	case BEEMU_SLOT_DEREFERENCE_BYTE:
+		value = beemu_memory_read(processor->memory, value);
+		break;
+	case BEEMU_SLOT_DEREFERENCE_DOUBLE:
+		value = beemu_memory_read(processor->memory, value)
+			| (beemu_memory_read(processor->memory, (uint16_t)(value + 1)) << 8);
+		break;
+	default:
+		break;
+	}
+	switch (slot->select) {
+	case BEEMU_SLOT_SELECT_LOWER:
+		return value & 0xFF;
+	case BEEMU_SLOT_SELECT_HIGHER:
+		return value >> 8;
+	default:
+		return value;
+	}
+}
+
+/**
+ * Record the slots of an opcode and derive its skeleton from them.
+ * @param processor Processor to parse against, only its lazy flags matter.
+ * @param machine_code The opcode bytes, left aligned the way the tokenizer expects.
+ * @return The skeleton, or null if the opcode cannot be cached.
+ */
+static BeemuCommandSkeleton *build_skeleton(const BeemuProcessor *processor, const uint32_t machine_code)
+{
+	BeemuInstruction instruction;
+	BeemuCommandQueue queue;
+	BeemuCommandSlots slots;
+	beemu_tokenizer_tokenize_into(&instruction, machine_code);
+	beemu_parser_record_into(processor, &instruction, &queue, &slots);
+	// Conditional jumps emit different commands depending on the flags,
+	// not only different values.
+	if (slots.opaque || instruction.type == BEEMU_INSTRUCTION_TYPE_JUMP) {
+		return 0;
+	}
+
+	const uint8_t command_count = beemu_command_queue_size(&queue);
+	BeemuCommandSkeleton *skeleton = malloc(sizeof(BeemuCommandSkeleton));
+	skeleton->command_count = command_count;
+	skeleton->commands = malloc(sizeof(BeemuMachineCommand) * command_count);
+	skeleton->value_slots = malloc(sizeof(BeemuCommandSlot) * command_count);
+	skeleton->address_slots = malloc(sizeof(BeemuCommandSlot) * command_count);
+	for (uint8_t i = 0; i < command_count; i++) {
+		skeleton->commands[i] = *beemu_command_queue_dequeue(&queue);
+	}
+	memcpy(skeleton->value_slots, slots.values, sizeof(BeemuCommandSlot) * command_count);
+	memcpy(skeleton->address_slots, slots.addresses, sizeof(BeemuCommandSlot) * command_count);
+	memcpy(skeleton->operand_slots, slots.operands, sizeof(slots.operands));
+	skeleton->has_operands = slots.has_operands;
+	return skeleton;
+}
+
+void beemu_parse_cache_build(void)
+{
+	if (!beemu_once_begin(&skeletons_once)) {
+		return;
+	}
+	// Values are recorded as slots, so the state parsed against does not
+	// matter, the processor is built by hand as beemu_processor_new would
+	// build the cache itself.
+	BeemuProcessor processor;
+	memset(&processor, 0, sizeof(BeemuProcessor));
+	processor.memory = beemu_memory_new(BEEMU_DEVICE_MEMORY_SIZE);
+	processor.registers = beemu_registers_new();
+	for (int lazy_flags = 0; lazy_flags < 2; lazy_flags++) {
+		processor.lazy_flags = lazy_flags;
+		for (uint32_t opcode = 0; opcode < 256; opcode++) {
+			UNPREFIXED_SKELETONS[lazy_flags][opcode] = build_skeleton(&processor, opcode << 16);
+			CB_PREFIXED_SKELETONS[lazy_flags][opcode] = build_skeleton(&processor, (0xCB << 16) | (opcode << 8));
+		}
+	}
+	beemu_memory_free(processor.memory);
+	beemu_registers_free(processor.registers);
+	beemu_once_end(&skeletons_once);
+}
+
+const BeemuCommandSkeleton *beemu_parse_cache_lookup(const BeemuProcessor *processor, const BeemuInstruction *instruction)
+{
+	if (!beemu_once_is_done(&skeletons_once)) {
+		beemu_parse_cache_build();
+	}
+	const int lazy_flags = processor->lazy_flags ? 1 : 0;
+	const uint32_t omc = instruction->original_machine_code;
+	switch (instruction->byte_length) {
+	case 1:
+		return UNPREFIXED_SKELETONS[lazy_flags][omc & 0xFF];
+	case 2:
+		if ((omc >> 8) == 0xCB) {
+			return CB_PREFIXED_SKELETONS[lazy_flags][omc & 0xFF];
+		}
+		return UNPREFIXED_SKELETONS[lazy_flags][(omc >> 8) & 0xFF];
+	case 3:
+		return UNPREFIXED_SKELETONS[lazy_flags][(omc >> 16) & 0xFF];
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Compute the output of the operation a skeleton records the operands of,
+ * packed the same way as the ALU lookup output.
+ */
+static BeemuAluOutput evaluate_operation(
+	const BeemuCommandSkeleton *skeleton,
+	const BeemuProcessor *processor,
+	const BeemuInstruction *instruction)
+{
+	const uint32_t omc = instruction->original_machine_code;
+	const uint8_t first_value = evaluate_slot(&skeleton->operand_slots[0], processor, omc);
+	const uint8_t second_value = evaluate_slot(&skeleton->operand_slots[1], processor, omc);
+	if (instruction->type == BEEMU_INSTRUCTION_TYPE_BITWISE) {
+		const BeemuBitwiseParams *params = &instruction->params.bitwise_params;
+		return resolve_bitwise_op(first_value, params->bit_number, params->operation) << 8;
+	}
+	const BeemuOperation operation = instruction->params.arithmatic_params.operation;
+	const uint8_t flags = beemu_alu_reads_flags(operation) ? beemu_registers_flags_peek(processor->registers) : processor->registers->flags;
+	return beemu_alu_lookup(operation, first_value, second_value, flags);
+}
+
+/**
+ * Compute the value of a slot that refers to the recorded operation.
+ */
+static uint16_t evaluate_operation_slot(
+	const BeemuCommandSlot *slot,
+	const BeemuMachineCommand *command,
+	const BeemuCommandSkeleton *skeleton,
+	const BeemuProcessor *processor,
+	const uint32_t original_machine_code,
+	const BeemuAluOutput output)
+{
+	switch (slot->base) {
+	case BEEMU_SLOT_BASE_RESULT:
+		return output >> 8;
+	case BEEMU_SLOT_BASE_RESULT_FLAG:
+		return (output >> command->write.target.target.flag) & 1;
+	default:
+		return (evaluate_slot(&skeleton->operand_slots[0], processor, original_machine_code) & 0xFF) << 8
+			| (evaluate_slot(&skeleton->operand_slots[1], processor, original_machine_code) & 0xFF);
+	}
+}
+
+void beemu_parse_cache_evaluate(
+	const BeemuCommandSkeleton *skeleton,
+	const BeemuProcessor *processor,
+	const BeemuInstruction *instruction,
+	BeemuCommandQueue *queue)
+{
+	const uint32_t omc = instruction->original_machine_code;
+	// Operands are read before any of the commands run, as the parser does.
+	const BeemuAluOutput output = skeleton->has_operands ? evaluate_operation(skeleton, processor, instruction) : 0;
+	for (uint8_t i = 0; i < skeleton->command_count; i++) {
+		BeemuMachineCommand command = skeleton->commands[i];
+		if (command.type == BEEMU_COMMAND_WRITE) {
+			const BeemuCommandSlot *value_slot = &skeleton->value_slots[i];
+			// Constants are already stored in the command.
+			if (value_slot->base != BEEMU_SLOT_BASE_CONSTANT || value_slot->dereference != BEEMU_SLOT_DEREFERENCE_NONE) {
+				const uint16_t value = value_slot->base >= BEEMU_SLOT_BASE_RESULT
+					? evaluate_operation_slot(value_slot, &command, skeleton, processor, omc, output)
+					: evaluate_slot(value_slot, processor, omc);
+				if (command.write.value.is_16) {
+					command.write.value.value.double_value = value;
+				} else {
+					command.write.value.value.byte_value = value;
+				}
+			}
+			if (command.write.target.type == BEEMU_WRITE_TARGET_LAZY_FLAGS) {
+				// The carry is only taken in by the operations that read it.
+				const BeemuOperation operation = command.write.target.target.lazy_flags.operation;
+				command.write.target.target.lazy_flags.carry_flag = beemu_alu_reads_flags(operation)
+					? (beemu_registers_flags_peek(processor->registers) >> BEEMU_FLAG_C) & 1
+					: 0;
+			}
+			if (command.write.target.type == BEEMU_WRITE_TARGET_MEMORY_ADDRESS) {
+				command.write.target.target.mem_addr = evaluate_slot(&skeleton->address_slots[i], processor, omc);
+			}
+		}
+		beemu_command_queue_enqueue(queue, &command);
+	}
+}
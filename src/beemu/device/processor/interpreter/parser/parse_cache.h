@@ -0,0 +1,75 @@
+/**
+ * @file parse_cache.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Per opcode cache of pre-parsed command skeletons.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_PARSE_CACHE_H
+#define BEEMU_PARSE_CACHE_H
+#include "../command.h"
+#include "command_slot.h"
+#include <beemu/device/processor/processor.h>
+#include <stdbool.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Pre-parsed commands for a single opcode.
+ *
+ * Commands hold the shape of the emitted queue, the values (and memory
+ * addresses) that depend on the processor state are filled from the slots.
+ */
+typedef struct BeemuCommandSkeleton {
+	uint8_t command_count;
+	BeemuMachineCommand *commands;
+	BeemuCommandSlot *value_slots;
+	BeemuCommandSlot *address_slots;
+	/** Operands of the ALU or bit operation the result slots refer to. */
+	BeemuCommandSlot operand_slots[2];
+	bool has_operands;
+} BeemuCommandSkeleton;
+
+/**
+ * @brief Build the skeletons for every opcode.
+ *
+ * Each opcode is parsed once while the parsers record the slot of every value
+ * they emit, opcodes with values no slot describes are left to the parser.
+ * Skeletons are built for processors with and without lazy flags, since the
+ * flag writes differ. Idempotent.
+ */
+void beemu_parse_cache_build(void);
+
+/**
+ * @brief Get the skeleton for an instruction, if it is cached.
+ *
+ * @param processor Processor the instruction will be parsed for.
+ * @param instruction Instruction to look up.
+ * @return The skeleton or null if the instruction must be parsed in full.
+ */
+const BeemuCommandSkeleton *beemu_parse_cache_lookup(const BeemuProcessor *processor, const BeemuInstruction *instruction);
+
+/**
+ * @brief Fill a command queue from a skeleton.
+ *
+ * @param skeleton Skeleton to evaluate.
+ * @param processor Processor state to resolve the slots with.
+ * @param instruction Instruction the skeleton was looked up with.
+ * @param queue Queue to emit the commands to.
+ */
+void beemu_parse_cache_evaluate(
+	const BeemuCommandSkeleton *skeleton,
+	const BeemuProcessor *processor,
+	const BeemuInstruction *instruction,
+	BeemuCommandQueue *queue);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // BEEMU_PARSE_CACHE_H
@@ -15,6 +15,33 @@
 #include <beemu/device/processor/registers.h>
 #include <stddef.h>
 
+/**
+ * Record the slots of the command that was enqueued last, if the queue
+ * records them.
+ */
+static inline void record_slots(BeemuCommandQueue *queue, const BeemuCommandSlot value_slot, const BeemuCommandSlot address_slot)
+{
+	BeemuCommandSlots *slots = queue->slots;
+	if (!slots) {
+		return;
+	}
+	const uint32_t index = beemu_command_queue_size(queue) - 1;
+	slots->values[index] = value_slot;
+	slots->addresses[index] = address_slot;
+	slots->opaque = slots->opaque || value_slot.base == BEEMU_SLOT_BASE_OPAQUE || address_slot.base == BEEMU_SLOT_BASE_OPAQUE;
+}
+
+void beemu_cq_record_operands(BeemuCommandQueue *queue, const BeemuCommandSlot first_slot, const BeemuCommandSlot second_slot)
+{
+	BeemuCommandSlots *slots = queue->slots;
+	if (!slots) {
+		return;
+	}
+	slots->operands[0] = first_slot;
+	slots->operands[1] = second_slot;
+	slots->has_operands = true;
+}
+
 void beemu_cq_halt_cycle(BeemuCommandQueue *queue)
 {
 	BeemuMachineCommand command;
@@ -23,7 +50,7 @@ void beemu_cq_halt_cycle(BeemuCommandQueue *queue)
 	beemu_command_queue_enqueue(queue, &command);
 }
 
-void beemu_cq_write_reg_8(BeemuCommandQueue *queue, const BeemuRegister_8 reg, const uint8_t value)
+void beemu_cq_write_reg_8(BeemuCommandQueue *queue, const BeemuRegister_8 reg, const uint8_t value, const BeemuCommandSlot value_slot)
 {
 	BeemuMachineCommand command;
 	command.type = BEEMU_COMMAND_WRITE;
@@ -32,9 +59,10 @@ void beemu_cq_write_reg_8(BeemuCommandQueue *queue, const BeemuRegister_8 reg, c
 	command.write.value.is_16 = false;
 	command.write.value.value.byte_value = value;
 	beemu_command_queue_enqueue(queue, &command);
+	record_slots(queue, value_slot, beemu_slot_constant(0));
 }
 
-void beemu_cq_write_reg_16(BeemuCommandQueue *queue, const BeemuRegister_16 reg, const uint16_t value)
+void beemu_cq_write_reg_16(BeemuCommandQueue *queue, const BeemuRegister_16 reg, const uint16_t value, const BeemuCommandSlot value_slot)
 {
 	BeemuMachineCommand command;
 	command.type = BEEMU_COMMAND_WRITE;
@@ -43,9 +71,10 @@ void beemu_cq_write_reg_16(BeemuCommandQueue *queue, const BeemuRegister_16 reg,
 	command.write.value.is_16 = true;
 	command.write.value.value.double_value = value;
 	beemu_command_queue_enqueue(queue, &command);
+	record_slots(queue, value_slot, beemu_slot_constant(0));
 }
 
-void beemu_cq_write_flag(BeemuCommandQueue *queue, const BeemuFlag flag, const uint8_t value)
+void beemu_cq_write_flag(BeemuCommandQueue *queue, const BeemuFlag flag, const uint8_t value, const BeemuCommandSlot value_slot)
 {
 	BeemuMachineCommand command;
 	command.type = BEEMU_COMMAND_WRITE;
@@ -54,9 +83,30 @@ void beemu_cq_write_flag(BeemuCommandQueue *queue, const BeemuFlag flag, const u
 	command.write.value.is_16 = false;
 	command.write.value.value.byte_value = value;
 	beemu_command_queue_enqueue(queue, &command);
+	record_slots(queue, value_slot, beemu_slot_constant(0));
 }
 
-void beemu_cq_write_ir(BeemuCommandQueue *queue, const uint8_t instruction_opcode)
+void beemu_cq_write_lazy_flags(
+	BeemuCommandQueue *queue,
+	const BeemuOperation operation,
+	const uint8_t first_value,
+	const uint8_t second_value,
+	const uint8_t carry_flag,
+	const bool preserve_carry)
+{
+	BeemuMachineCommand command;
+	command.type = BEEMU_COMMAND_WRITE;
+	command.write.target.type = BEEMU_WRITE_TARGET_LAZY_FLAGS;
+	command.write.target.target.lazy_flags.operation = operation;
+	command.write.target.target.lazy_flags.carry_flag = carry_flag;
+	command.write.target.target.lazy_flags.preserve_carry = preserve_carry;
+	command.write.value.is_16 = true;
+	command.write.value.value.double_value = first_value << 8 | second_value;
+	beemu_command_queue_enqueue(queue, &command);
+	record_slots(queue, beemu_slot_of(BEEMU_SLOT_BASE_OPERANDS), beemu_slot_constant(0));
+}
+
+void beemu_cq_write_ir(BeemuCommandQueue *queue, const uint8_t instruction_opcode, const BeemuCommandSlot value_slot)
 {
 	BeemuMachineCommand command;
 	command.type = BEEMU_COMMAND_WRITE;
@@ -65,9 +115,10 @@ void beemu_cq_write_ir(BeemuCommandQueue *queue, const uint8_t instruction_opcod
 	command.write.value.is_16 = false;
 	command.write.value.value.byte_value = instruction_opcode;
 	beemu_command_queue_enqueue(queue, &command);
+	record_slots(queue, value_slot, beemu_slot_constant(0));
 }
 
-void beemu_cq_write_pc(BeemuCommandQueue *queue, uint16_t program_counter_value)
+void beemu_cq_write_pc(BeemuCommandQueue *queue, uint16_t program_counter_value, const BeemuCommandSlot value_slot)
 {
 
 	BeemuMachineCommand command;
@@ -77,9 +128,27 @@ void beemu_cq_write_pc(BeemuCommandQueue *queue, uint16_t program_counter_value)
 	command.write.value.is_16 = true;
 	command.write.value.value.double_value = program_counter_value;
 	beemu_command_queue_enqueue(queue, &command);
+	record_slots(queue, value_slot, beemu_slot_constant(0));
 }
 
-void beemu_cq_write_memory(BeemuCommandQueue *queue, const uint16_t memory_address, const uint8_t memory_value)
+void beemu_cq_write_ime(BeemuCommandQueue *queue, const uint8_t value, const BeemuCommandSlot value_slot)
+{
+	BeemuMachineCommand command;
+	command.type = BEEMU_COMMAND_WRITE;
+	command.write.target.type = BEEMU_WRITE_TARGET_IME;
+	command.write.target.target.mem_addr = 0;
+	command.write.value.is_16 = false;
+	command.write.value.value.byte_value = value;
+	beemu_command_queue_enqueue(queue, &command);
+	record_slots(queue, value_slot, beemu_slot_constant(0));
+}
+
+void beemu_cq_write_memory(
+	BeemuCommandQueue *queue,
+	const uint16_t memory_address,
+	const uint8_t memory_value,
+	const BeemuCommandSlot address_slot,
+	const BeemuCommandSlot value_slot)
 {
 	BeemuMachineCommand command;
 	command.type = BEEMU_COMMAND_WRITE;
@@ -88,9 +157,19 @@ void beemu_cq_write_memory(BeemuCommandQueue *queue, const uint16_t memory_addre
 	command.write.value.is_16 = false;
 	command.write.value.value.byte_value = memory_value;
 	beemu_command_queue_enqueue(queue, &command);
+	record_slots(queue, value_slot, address_slot);
 }
 
 
+uint16_t beemu_resolve_register_16(const BeemuProcessor *processor, const BeemuRegister_16 register_)
+{
+	if (register_ == BEEMU_REGISTER_AF) {
+		// Reading AF from the register file would materialise pending flags.
+		return (processor->registers->pairs[BEEMU_REGISTER_AF] & 0xFF00) | beemu_registers_flags_peek(processor->registers);
+	}
+	return processor->registers->pairs[register_];
+}
+
 uint16_t beemu_resolve_instruction_parameter_unsigned(const BeemuParam *parameter, const BeemuProcessor *processor, bool skip_deref)
 {
 	switch (parameter->type) {
@@ -114,10 +193,7 @@ uint16_t beemu_resolve_instruction_parameter_unsigned(const BeemuParam *paramete
 		return mem_value;
 	}
 	case BEEMU_PARAM_TYPE_REGISTER_16: {
-		BeemuRegister register16_to_read;
-		register16_to_read.type = BEEMU_SIXTEEN_BIT_REGISTER;
-		register16_to_read.name_of.sixteen_bit_register = parameter->value.register_16;
-		const uint16_t register16_value = beemu_registers_read_register_value(processor->registers, register16_to_read);
+		const uint16_t register16_value = beemu_resolve_register_16(processor, parameter->value.register_16);
 		if (!parameter->pointer || skip_deref) {
 			// If not pointer, nothing else to do.
 			return register16_value;
@@ -150,6 +226,47 @@ uint16_t beemu_resolve_instruction_parameter_unsigned(const BeemuParam *paramete
 	}
 }
 
+BeemuCommandSlot beemu_slot_param(const BeemuParam *parameter, const BeemuInstruction *instruction, const bool skip_deref)
+{
+	BeemuCommandSlot slot = beemu_slot_constant(0);
+	switch (parameter->type) {
+	case BEEMU_PARAM_TYPE_REGISTER_8:
+		slot.base = BEEMU_SLOT_BASE_REGISTER_8;
+		slot.register_ = parameter->value.register_8;
+		if (parameter->pointer) {
+			// Offsetted to 0xFF00, the same as when resolving them.
+			slot.offset = 0xFF00;
+		}
+		break;
+	case BEEMU_PARAM_TYPE_REGISTER_16:
+		slot.base = BEEMU_SLOT_BASE_REGISTER_16;
+		slot.register_ = parameter->value.register_16;
+		break;
+	case BEEMU_PARAM_TYPE_UINT_8:
+	case BEEMU_PARAM_TYPE_UINT16: {
+		// Immediates of multibyte instructions are their operand, those of
+		// single byte ones (the 1 of INC and DEC) are constants.
+		const bool is_double = parameter->type == BEEMU_PARAM_TYPE_UINT16;
+		if (instruction->byte_length == (is_double ? 3 : 2)) {
+			slot.base = is_double ? BEEMU_SLOT_BASE_OPERAND_16 : BEEMU_SLOT_BASE_OPERAND_8;
+		} else {
+			slot.offset = parameter->value.value;
+		}
+		if (parameter->pointer && !is_double) {
+			slot.offset += 0xFF00;
+		}
+		break;
+	}
+	default:
+		// Signed operands are summed by hand, see offsetted_sp_copy.
+		return beemu_slot_of(BEEMU_SLOT_BASE_OPAQUE);
+	}
+	if (parameter->pointer && !skip_deref) {
+		slot.dereference = BEEMU_SLOT_DEREFERENCE_BYTE;
+	}
+	return slot;
+}
+
 BeemuParamTuple beemu_explode_beemu_param(const BeemuParam *param, const BeemuProcessor *processor)
 {
 	BeemuParamTuple tuple;
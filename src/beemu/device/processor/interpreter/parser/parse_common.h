@@ -12,6 +12,7 @@
 #ifndef BEEMU_PARSE_COMMON_H
 #define BEEMU_PARSE_COMMON_H
 #include "../command.h"
+#include "command_slot.h"
 #include <stdint.h>
 #include <stdbool.h>
 #include <beemu/device/processor/processor.h>
@@ -26,33 +27,71 @@ void beemu_cq_halt_cycle(BeemuCommandQueue *queue);
 
 /**
  * Add a write register 8 machine command to the command queue.
+ *
+ * Like every write below, it takes the slot describing how the value was
+ * computed, which the parse cache is built from.
  */
-void beemu_cq_write_reg_8(BeemuCommandQueue *queue, BeemuRegister_8 reg, uint8_t value);
+void beemu_cq_write_reg_8(BeemuCommandQueue *queue, BeemuRegister_8 reg, uint8_t value, BeemuCommandSlot value_slot);
 
 /**
  * Add a write register 16 machine command to the command queue.
  */
-void beemu_cq_write_reg_16(BeemuCommandQueue *queue, BeemuRegister_16 reg, uint16_t value);
+void beemu_cq_write_reg_16(BeemuCommandQueue *queue, BeemuRegister_16 reg, uint16_t value, BeemuCommandSlot value_slot);
 
 /**
  * Add a flag write command to the command queue.
  */
-void beemu_cq_write_flag(BeemuCommandQueue *queue, BeemuFlag flag, uint8_t value);
+void beemu_cq_write_flag(BeemuCommandQueue *queue, BeemuFlag flag, uint8_t value, BeemuCommandSlot value_slot);
+
+/**
+ * Record the operands of the ALU or bit operation whose result the
+ * following writes use, see BEEMU_SLOT_BASE_RESULT.
+ */
+void beemu_cq_record_operands(BeemuCommandQueue *queue, BeemuCommandSlot first_slot, BeemuCommandSlot second_slot);
+
+/**
+ * Add a command that defers the flags of an 8 bit ALU operation, replacing
+ * the flag writes it would have emitted, its operands must be recorded.
+ */
+void beemu_cq_write_lazy_flags(
+	BeemuCommandQueue *queue,
+	BeemuOperation operation,
+	uint8_t first_value,
+	uint8_t second_value,
+	uint8_t carry_flag,
+	bool preserve_carry);
 
 /**
  * Write an instruction opcode to the instruction register.
  */
-void beemu_cq_write_ir(BeemuCommandQueue *queue, uint8_t instruction_opcode);
+void beemu_cq_write_ir(BeemuCommandQueue *queue, uint8_t instruction_opcode, BeemuCommandSlot value_slot);
 
 /**
  * Write a instruction's location to the program counter
  */
-void beemu_cq_write_pc(BeemuCommandQueue *queue, uint16_t program_counter_value);
+void beemu_cq_write_pc(BeemuCommandQueue *queue, uint16_t program_counter_value, BeemuCommandSlot value_slot);
+
+/**
+ * Write the interrupt master enable flag.
+ */
+void beemu_cq_write_ime(BeemuCommandQueue *queue, uint8_t value, BeemuCommandSlot value_slot);
 
 /**
  * Emit a write order for a memory address.
  */
-void beemu_cq_write_memory(BeemuCommandQueue *queue, uint16_t memory_address, uint8_t memory_value);
+void beemu_cq_write_memory(
+	BeemuCommandQueue *queue,
+	uint16_t memory_address,
+	uint8_t memory_value,
+	BeemuCommandSlot address_slot,
+	BeemuCommandSlot value_slot);
+
+/**
+ * @brief Read a 16 bit register without changing the register file.
+ *
+ * AF is read with its pending flags computed, but left pending.
+ */
+uint16_t beemu_resolve_register_16(const BeemuProcessor *processor, BeemuRegister_16 register_);
 
 /**
  * @brief Resolve the value of a parameter holding an 8 or 16 bit unsigned value.
@@ -67,6 +106,16 @@ void beemu_cq_write_memory(BeemuCommandQueue *queue, uint16_t memory_address, ui
  */
 uint16_t beemu_resolve_instruction_parameter_unsigned(const BeemuParam *parameter, const BeemuProcessor *processor, bool skip_deref);
 
+/**
+ * @brief Get the slot that resolves a parameter the way
+ * beemu_resolve_instruction_parameter_unsigned does.
+ *
+ * @param parameter Parameter to describe.
+ * @param instruction Instruction the parameter belongs to.
+ * @param skip_deref Do not reference the pointer.
+ */
+BeemuCommandSlot beemu_slot_param(const BeemuParam *parameter, const BeemuInstruction *instruction, bool skip_deref);
+
 /**
  * Holds two params, typically exploded 16 bit register to two 8 bits.
  */
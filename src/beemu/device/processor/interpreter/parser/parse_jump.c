@@ -11,9 +11,134 @@
 
 #include "parse_jump.h"
 
+#include <beemu/device/processor/registers.h>
+
+/**
+ * Check if the condition of a conditional jump holds, pending flags are
+ * read without being materialised.
+ * @param processor Processor context
+ * @param condition Condition to test.
+ * @return true if the jump is taken.
+ */
+static bool condition_holds(const BeemuProcessor *processor, const BeemuJumpCondition condition)
+{
+	const uint8_t flags = beemu_registers_flags_peek(processor->registers);
+	const uint8_t zero = (flags >> BEEMU_FLAG_Z) & 1;
+	const uint8_t carry = (flags >> BEEMU_FLAG_C) & 1;
+	switch (condition) {
+	case BEEMU_JUMP_IF_CARRY:
+		return carry == 1;
+	case BEEMU_JUMP_IF_NOT_CARRY:
+		return carry == 0;
+	case BEEMU_JUMP_IF_ZERO:
+		return zero == 1;
+	case BEEMU_JUMP_IF_NOT_ZERO:
+		return zero == 0;
+	default:
+		return true;
+	}
+}
+
+/**
+ * Each operand byte following the opcode is fetched in a cycle of its own,
+ * with the PC stepping over it and the byte latched to the IR.
+ * @param queue Queue to emit at.
+ * @param processor Processor context
+ * @param instruction Instruction whose operands are fetched.
+ */
+static void emit_operand_fetches(BeemuCommandQueue *queue, const BeemuProcessor *processor, const BeemuInstruction *instruction)
+{
+	const uint16_t pc = processor->registers->program_counter;
+	const uint32_t omc = instruction->original_machine_code;
+	for (uint8_t operand = 1; operand < instruction->byte_length; operand++) {
+		// Operands are little endian, and the last byte is the lowest one of the machine code.
+		const uint8_t operand_value = omc >> (8 * (instruction->byte_length - 1 - operand));
+		beemu_cq_write_pc(queue, pc + operand + 1, beemu_slot_program_counter(operand + 1));
+		beemu_cq_write_ir(queue, operand_value, beemu_slot_of(BEEMU_SLOT_BASE_OPAQUE));
+		beemu_cq_halt_cycle(queue);
+	}
+}
+
+/**
+ * Push a 16 bit value to the stack, the most significant byte first, the
+ * last write does not halt so the caller can load the PC in the same cycle.
+ */
+static void emit_push(BeemuCommandQueue *queue, const BeemuProcessor *processor, const uint16_t value)
+{
+	const BeemuCommandSlot opaque = beemu_slot_of(BEEMU_SLOT_BASE_OPAQUE);
+	const uint16_t stack_pointer = processor->registers->stack_pointer;
+	beemu_cq_write_reg_16(queue, BEEMU_REGISTER_SP, stack_pointer - 1, opaque);
+	beemu_cq_halt_cycle(queue);
+	beemu_cq_write_memory(queue, stack_pointer - 1, value >> 8, opaque, opaque);
+	beemu_cq_write_reg_16(queue, BEEMU_REGISTER_SP, stack_pointer - 2, opaque);
+	beemu_cq_halt_cycle(queue);
+	beemu_cq_write_memory(queue, stack_pointer - 2, value & 0xFF, opaque, opaque);
+}
+
+/**
+ * Pop a 16 bit value from the stack, a byte per cycle.
+ * @return The popped value, for the caller to load to the PC.
+ */
+static uint16_t emit_pop(BeemuCommandQueue *queue, const BeemuProcessor *processor)
+{
+	const BeemuCommandSlot opaque = beemu_slot_of(BEEMU_SLOT_BASE_OPAQUE);
+	const uint16_t stack_pointer = processor->registers->stack_pointer;
+	const uint8_t lower = beemu_memory_read(processor->memory, stack_pointer);
+	const uint8_t higher = beemu_memory_read(processor->memory, (uint16_t)(stack_pointer + 1));
+	beemu_cq_write_reg_16(queue, BEEMU_REGISTER_SP, stack_pointer + 1, opaque);
+	beemu_cq_halt_cycle(queue);
+	beemu_cq_write_reg_16(queue, BEEMU_REGISTER_SP, stack_pointer + 2, opaque);
+	beemu_cq_halt_cycle(queue);
+	return higher << 8 | lower;
+}
+
 void parse_jump(
 	BeemuCommandQueue *queue,
 	const BeemuProcessor *processor,
-	const BeemuInstruction *instruction) {
-	0;
+	const BeemuInstruction *instruction)
+{
+	const BeemuJumpParams *params = &instruction->params.jump_params;
+	// Jump targets depend on the flags and the stack, the parse cache cannot describe them.
+	const BeemuCommandSlot opaque = beemu_slot_of(BEEMU_SLOT_BASE_OPAQUE);
+	const uint16_t next_address = processor->registers->program_counter + instruction->byte_length;
+	emit_operand_fetches(queue, processor, instruction);
+	if (params->type == BEEMU_JUMP_TYPE_RET && params->is_conditional) {
+		// RET cc spends a cycle checking its condition, taken or not.
+		beemu_cq_halt_cycle(queue);
+	}
+	if (params->is_conditional && !condition_holds(processor, params->condition)) {
+		// The PC already points to the next instruction.
+		return;
+	}
+
+	switch (params->type) {
+	case BEEMU_JUMP_TYPE_RET:
+		beemu_cq_write_pc(queue, emit_pop(queue, processor), opaque);
+		if (params->enable_interrupts) {
+			// RETI enables the interrupts immediately, unlike EI.
+			beemu_cq_write_ime(queue, 1, beemu_slot_constant(1));
+		}
+		beemu_cq_halt_cycle(queue);
+		break;
+	case BEEMU_JUMP_TYPE_CALL:
+	case BEEMU_JUMP_TYPE_RST:
+		emit_push(queue, processor, next_address);
+		beemu_cq_write_pc(queue, params->param.value.value, opaque);
+		beemu_cq_halt_cycle(queue);
+		break;
+	default:
+		if (params->is_relative) {
+			// The ALU spends a cycle adding the offset to the PC, which is
+			// then loaded as the next instruction is fetched.
+			beemu_cq_halt_cycle(queue);
+			beemu_cq_write_pc(queue, next_address + params->param.value.signed_value, opaque);
+		} else if (params->param.type == BEEMU_PARAM_TYPE_REGISTER_16) {
+			// JP HL loads the PC without spending a cycle of its own.
+			beemu_cq_write_pc(queue, beemu_resolve_register_16(processor, params->param.value.register_16), opaque);
+		} else {
+			beemu_cq_write_pc(queue, params->param.value.value, opaque);
+			beemu_cq_halt_cycle(queue);
+		}
+		break;
+	}
 }
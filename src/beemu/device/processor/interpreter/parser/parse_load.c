@@ -99,18 +99,22 @@ DEFINE_STATE(dst_post_load)
 		&ctx->ld_params->dest,
 		ctx->processor,
 		true) + post_load_modifier;
+	BeemuCommandSlot new_target_slot = beemu_slot_param(&ctx->ld_params->dest, ctx->instruction, true);
+	new_target_slot.offset += post_load_modifier;
 	if (ctx->ld_params->dest.type == BEEMU_PARAM_TYPE_REGISTER_16) {
 		beemu_cq_write_reg_16(
 			ctx->queue,
 			 ctx->ld_params->dest.value.register_16,
-			new_target_value
+			new_target_value,
+			new_target_slot
 			);
 	} else {
 		// Otherwise write to r8
 		beemu_cq_write_reg_8(
 			ctx->queue,
 			 ctx->ld_params->dest.value.register_8,
-			new_target_value);
+			new_target_value,
+			new_target_slot);
 	}
 
 	RETURN_TO_PREVIOUS_STATE;
@@ -129,13 +133,15 @@ DEFINE_TERMINAL_STATE(offsetted_sp_copy)
 	const int carry = BEEMU_CKD_ADD(&lsb_add_result, sp_lsb, offset);
 	// Calculate H and C by hand
 	const int h_flag = (((sp_lsb & 0x0F) + (offset & 0x0F)) & 0x10) == 0x10;
-	beemu_cq_write_reg_8(ctx->queue, BEEMU_REGISTER_L, lsb_add_result);
-	beemu_cq_write_flag(ctx->queue, BEEMU_FLAG_Z, 0);
-	beemu_cq_write_flag(ctx->queue, BEEMU_FLAG_N, 0);
-	beemu_cq_write_flag(ctx->queue, BEEMU_FLAG_H, h_flag);
-	beemu_cq_write_flag(ctx->queue, BEEMU_FLAG_C, carry);
+	// The sum and its flags are not slots, so this is always parsed in full.
+	const BeemuCommandSlot opaque = beemu_slot_of(BEEMU_SLOT_BASE_OPAQUE);
+	beemu_cq_write_reg_8(ctx->queue, BEEMU_REGISTER_L, lsb_add_result, opaque);
+	beemu_cq_write_flag(ctx->queue, BEEMU_FLAG_Z, 0, beemu_slot_constant(0));
+	beemu_cq_write_flag(ctx->queue, BEEMU_FLAG_N, 0, beemu_slot_constant(0));
+	beemu_cq_write_flag(ctx->queue, BEEMU_FLAG_H, h_flag, opaque);
+	beemu_cq_write_flag(ctx->queue, BEEMU_FLAG_C, carry, opaque);
 	beemu_cq_halt_cycle(ctx->queue);
-	beemu_cq_write_reg_8(ctx->queue, BEEMU_REGISTER_H, sp_msb + carry);
+	beemu_cq_write_reg_8(ctx->queue, BEEMU_REGISTER_H, sp_msb + carry, opaque);
 	TERMINATE_STATE_MACHINE;
 }
 
@@ -153,20 +159,25 @@ DEFINE_TERMINAL_STATE(register_write)
 		&ctx->ld_params->source,
 		ctx->processor,
 		false);
+	BeemuCommandSlot write_slot = beemu_slot_param(&ctx->ld_params->source, ctx->instruction, false);
 
 	if (is_stack_op(ctx->ld_params->source)) {
 		write_value = beemu_memory_read_16(ctx->processor->memory, ctx->processor->registers->stack_pointer);
+		write_slot = beemu_slot_register_16(BEEMU_REGISTER_SP, 0);
+		write_slot.dereference = BEEMU_SLOT_DEREFERENCE_DOUBLE;
 	}
 	if (ctx->ld_params->dest.type == BEEMU_PARAM_TYPE_REGISTER_8) {
 		beemu_cq_write_reg_8(
 			ctx->queue,
 			ctx->ld_params->dest.value.register_8,
-			write_value);
+			write_value,
+			write_slot);
 	} else {
 		beemu_cq_write_reg_16(
 			ctx->queue,
 			ctx->ld_params->dest.value.register_16,
-			write_value);
+			write_value,
+			write_slot);
 		if (ctx->ld_params->dest.type == ctx->ld_params->source.type && !ctx->ld_params->dest.pointer && !ctx->ld_params->source.pointer ) {
 			// Transfering data from a 16 bit register to another 16 bit
 			// register directly causes an extra machine cycle being spent.
@@ -186,15 +197,18 @@ DEFINE_TERMINAL_STATE(write_to_stack)
 		&ctx->ld_params->source,
 		ctx->processor,
 		false);
+	const BeemuCommandSlot value_slot = beemu_slot_param(&ctx->ld_params->source, ctx->instruction, false);
 	const uint8_t msb_value = value_to_push >> 8;
 	const uint8_t lsb_value = value_to_push & 0xFF;
+	const BeemuCommandSlot msb_slot = beemu_slot_register_16(BEEMU_REGISTER_SP, 0xFFFF);
+	const BeemuCommandSlot lsb_slot = beemu_slot_register_16(BEEMU_REGISTER_SP, 0xFFFE);
 	// Write is performed in byte-wise order in reverse.
-	beemu_cq_write_reg_16(ctx->queue, BEEMU_REGISTER_SP, --stack_ptr);
+	beemu_cq_write_reg_16(ctx->queue, BEEMU_REGISTER_SP, --stack_ptr, msb_slot);
 	beemu_cq_halt_cycle(ctx->queue);
-	beemu_cq_write_memory(ctx->queue, stack_ptr, msb_value);
-	beemu_cq_write_reg_16(ctx->queue, BEEMU_REGISTER_SP, --stack_ptr);
+	beemu_cq_write_memory(ctx->queue, stack_ptr, msb_value, msb_slot, beemu_slot_select(value_slot, BEEMU_SLOT_SELECT_HIGHER));
+	beemu_cq_write_reg_16(ctx->queue, BEEMU_REGISTER_SP, --stack_ptr, lsb_slot);
 	beemu_cq_halt_cycle(ctx->queue);
-	beemu_cq_write_memory(ctx->queue, stack_ptr, lsb_value);
+	beemu_cq_write_memory(ctx->queue, stack_ptr, lsb_value, lsb_slot, beemu_slot_select(value_slot, BEEMU_SLOT_SELECT_LOWER));
 	beemu_cq_halt_cycle(ctx->queue);
 }
 
@@ -211,7 +225,9 @@ DEFINE_TERMINAL_STATE(write_to_memory)
 	beemu_cq_write_memory(
 		ctx->queue,
 		memory_addr,
-		memory_value
+		memory_value,
+		beemu_slot_param(&ctx->ld_params->dest, ctx->instruction, true),
+		beemu_slot_param(&ctx->ld_params->source, ctx->instruction, false)
 		);
 
 	if (post_load_impacts_dst(ctx->ld_params->postLoadOperation)) {
@@ -237,9 +253,13 @@ DEFINE_TERMINAL_STATE(write_double_to_memory)
 		false);
 	const uint8_t lsb = value & 0xFF;
 	const uint8_t msb = value >> 8;
-	beemu_cq_write_memory(ctx->queue, mem_addr, lsb);
+	const BeemuCommandSlot address_slot = beemu_slot_param(&ctx->ld_params->dest, ctx->instruction, true);
+	BeemuCommandSlot next_address_slot = address_slot;
+	next_address_slot.offset++;
+	const BeemuCommandSlot value_slot = beemu_slot_param(&ctx->ld_params->source, ctx->instruction, false);
+	beemu_cq_write_memory(ctx->queue, mem_addr, lsb, address_slot, beemu_slot_select(value_slot, BEEMU_SLOT_SELECT_LOWER));
 	beemu_cq_halt_cycle(ctx->queue);
-	beemu_cq_write_memory(ctx->queue, mem_addr + 1, msb);
+	beemu_cq_write_memory(ctx->queue, mem_addr + 1, msb, next_address_slot, beemu_slot_select(value_slot, BEEMU_SLOT_SELECT_HIGHER));
 	beemu_cq_halt_cycle(ctx->queue);
 	TERMINATE_STATE_MACHINE;
 }
@@ -280,12 +300,17 @@ DEFINE_STATE(decode_operand)
 		// representation, so we can just read it from the end
 		const uint8_t offset = (ctx->instruction->byte_length - decoding_nth_byte - 2) * 8;
 		const uint8_t next_ir_value = (ctx->instruction->original_machine_code >> offset) & 0xFF;
+		// Which is the lower byte of the little endian operand first.
+		const BeemuCommandSlot next_ir_slot = ctx->instruction->byte_length == 2
+			? beemu_slot_of(BEEMU_SLOT_BASE_OPERAND_8)
+			: beemu_slot_select(beemu_slot_of(BEEMU_SLOT_BASE_OPERAND_16), decoding_nth_byte == 0 ? BEEMU_SLOT_SELECT_LOWER : BEEMU_SLOT_SELECT_HIGHER);
 		// Increment to PC, write the new PC value to IR and Halt.
 		beemu_cq_write_pc(
 			ctx->queue,
 			// + 1 for initial read, +1 for 0 indexed
-			ctx->processor->registers->program_counter + (decoding_nth_byte + 2));
-		beemu_cq_write_ir(ctx->queue, next_ir_value);
+			ctx->processor->registers->program_counter + (decoding_nth_byte + 2),
+			beemu_slot_program_counter(decoding_nth_byte + 2));
+		beemu_cq_write_ir(ctx->queue, next_ir_value, next_ir_slot);
 		beemu_cq_halt_cycle(ctx->queue);
 	}
 
@@ -310,9 +335,9 @@ DEFINE_STATE(read_from_stack)
 	const uint16_t former_sp_value = beemu_registers_read_register_value(
 		ctx->processor->registers,
 		sp_reg_query);
-	beemu_cq_write_reg_16(ctx->queue, BEEMU_REGISTER_SP, former_sp_value + 1);
+	beemu_cq_write_reg_16(ctx->queue, BEEMU_REGISTER_SP, former_sp_value + 1, beemu_slot_register_16(BEEMU_REGISTER_SP, 1));
 	beemu_cq_halt_cycle(ctx->queue);
-	beemu_cq_write_reg_16(ctx->queue, BEEMU_REGISTER_SP, former_sp_value + 2);
+	beemu_cq_write_reg_16(ctx->queue, BEEMU_REGISTER_SP, former_sp_value + 2, beemu_slot_register_16(BEEMU_REGISTER_SP, 2));
 	beemu_cq_halt_cycle(ctx->queue);
 	TRANSITION_TO(write_cycle_start);
 }
@@ -328,10 +353,13 @@ DEFINE_STATE(src_post_load)
 		);
 	const int modifier = post_load_decrements(ctx->ld_params->postLoadOperation) ? -1 : 1;
 	const uint16_t new_value = value + modifier;
+	BeemuCommandSlot new_value_slot = beemu_slot_param(&ctx->ld_params->source, ctx->instruction, true);
+	new_value_slot.offset += modifier;
 	beemu_cq_write_reg_16(
 		ctx->queue,
 		ctx->ld_params->source.value.register_16,
-		new_value);
+		new_value,
+		new_value_slot);
 	beemu_cq_halt_cycle(ctx->queue);
 	TRANSITION_TO(write_cycle_start);
 }
@@ -0,0 +1,78 @@
+/**
+ * @file parse_rot_shift.c
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Instructions
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "parse_rot_shift.h"
+
+#include <beemu/device/processor/registers.h>
+
+uint8_t resolve_rot_shift_op(const uint8_t value, const uint8_t carry, const uint32_t original_machine_code, uint8_t *carry_out)
+{
+	*carry_out = 0;
+	switch ((original_machine_code >> 3) & 0x07) {
+	case 0: // RLC
+		*carry_out = value >> 7;
+		return (value << 1) | (value >> 7);
+	case 1: // RRC
+		*carry_out = value & 0x01;
+		return (value >> 1) | (value << 7);
+	case 2: // RL
+		*carry_out = value >> 7;
+		return (value << 1) | carry;
+	case 3: // RR
+		*carry_out = value & 0x01;
+		return (value >> 1) | (carry << 7);
+	case 4: // SLA
+		*carry_out = value >> 7;
+		return value << 1;
+	case 5: // SRA
+		*carry_out = value & 0x01;
+		return (value >> 1) | (value & 0x80);
+	case 6: // SWAP
+		return (value << 4) | (value >> 4);
+	default: // SRL
+		*carry_out = value & 0x01;
+		return value >> 1;
+	}
+}
+
+void parse_rot_shift(BeemuCommandQueue *queue, const BeemuProcessor *processor, const BeemuInstruction *instruction)
+{
+	const BeemuRotShiftParams *params = &instruction->params.rot_shift_params;
+	// The parse cache cannot evaluate these operations, leave them uncached.
+	const BeemuCommandSlot opaque = beemu_slot_of(BEEMU_SLOT_BASE_OPAQUE);
+	uint8_t target_value = 0;
+	if (params->target.pointer) {
+		// Spend a cycle dereferencing the HL and getting the value to the data bus.
+		target_value = dereference_hl_with_halt(queue, processor);
+	} else {
+		target_value = beemu_resolve_instruction_parameter_unsigned(&params->target, processor, true);
+	}
+	// Read without materialising pending flags, parsing must not change the processor.
+	const uint8_t carry = (beemu_registers_flags_peek(processor->registers) >> BEEMU_FLAG_C) & 1;
+	uint8_t carry_out = 0;
+	const uint8_t result = resolve_rot_shift_op(target_value, carry, instruction->original_machine_code, &carry_out);
+
+	if (params->target.pointer) {
+		const uint16_t value_of_hl = beemu_resolve_instruction_parameter_unsigned(&params->target, processor, true);
+		beemu_cq_write_memory(queue, value_of_hl, result, opaque, opaque);
+	} else {
+		beemu_cq_write_reg_8(queue, params->target.value.register_8, result, opaque);
+	}
+	// RLCA, RRCA, RLA and RRA always reset the Z flag.
+	beemu_cq_write_flag(queue, BEEMU_FLAG_Z, !params->set_flags_to_zero && result == 0, opaque);
+	beemu_cq_write_flag(queue, BEEMU_FLAG_N, 0, beemu_slot_constant(0));
+	beemu_cq_write_flag(queue, BEEMU_FLAG_H, 0, beemu_slot_constant(0));
+	beemu_cq_write_flag(queue, BEEMU_FLAG_C, carry_out, opaque);
+	if (params->target.pointer) {
+		// Writing back to memory takes a cycle of its own.
+		beemu_cq_halt_cycle(queue);
+	}
+}
@@ -0,0 +1,43 @@
+/**
+ * @file parse_rot_shift.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Instructions
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_PARSE_ROT_SHIFT_H
+#define BEEMU_PARSE_ROT_SHIFT_H
+#include "parse_common.h"
+#include <beemu/device/processor/processor.h>
+
+/**
+ * @brief Parse a rotate, shift or swap token.
+ *
+ * Given a queue, the current state of the processor and a rot/shift instruction token,
+ * parse the token and populate the queue with the resulting write and halt command.
+ * @param queue Queue to populate
+ * @param processor Current processor state.
+ * @param instruction Instruction to parse.
+ */
+void parse_rot_shift(BeemuCommandQueue *queue, const BeemuProcessor *processor, const BeemuInstruction *instruction);
+
+/**
+ * @brief Calculate the result of a rotate, shift or swap operation on a value.
+ *
+ * Bits 3 to 5 of the (second, if CB prefixed) opcode byte select the
+ * operation, the single byte RLCA, RRCA, RLA and RRA share the encoding
+ * of their CB prefixed counterparts.
+ *
+ * @param value Value to act on.
+ * @param carry Carry flag before the operation.
+ * @param original_machine_code Machine code of the instruction.
+ * @param carry_out Set to the carry flag after the operation.
+ * @return The modified value.
+ */
+uint8_t resolve_rot_shift_op(uint8_t value, uint8_t carry, uint32_t original_machine_code, uint8_t *carry_out);
+
+#endif // BEEMU_PARSE_ROT_SHIFT_H
@@ -12,8 +12,12 @@
 #include "parser.h"
 #include "parse_arithmatic.h"
 #include "parse_bitwise.h"
+#include "parse_cache.h"
 #include "parse_load.h"
 #include "parse_jump.h"
+#include "parse_rot_shift.h"
+
+#include <string.h>
 
 /**
  * Every gameboy instruction loads the PC and IR values and sets the
@@ -32,8 +36,8 @@ void emit_m1_commands(const BeemuProcessor *processor, const BeemuInstruction *i
 	}
 	uint16_t pc_value = processor->registers->program_counter;
 	pc_value++;
-	beemu_cq_write_pc(queue, pc_value);
-	beemu_cq_write_ir(queue, opcode);
+	beemu_cq_write_pc(queue, pc_value, beemu_slot_program_counter(1));
+	beemu_cq_write_ir(queue, opcode, beemu_slot_constant(opcode));
 	beemu_cq_halt_cycle(queue);
 }
 
@@ -50,15 +54,60 @@ void emit_m2_commands_for_cbxx(const BeemuProcessor *processor, const BeemuInstr
 	const uint8_t actual_opcode = omc & 0xFF;
 	// Iterate the PC so that we can act as if the Gameboy read the instruction opcode.
 	uint16_t pc_value = processor->registers->program_counter + 2;
-	beemu_cq_write_pc(queue, pc_value);
-	beemu_cq_write_ir(queue, actual_opcode);
+	beemu_cq_write_pc(queue, pc_value, beemu_slot_program_counter(2));
+	beemu_cq_write_ir(queue, actual_opcode, beemu_slot_constant(actual_opcode));
 	beemu_cq_halt_cycle(queue);
 }
 
+/**
+ * CPU control instructions other than NOP change the processor state, emit
+ * a (non cycle terminating) halt order carrying the operation.
+ * @param instruction Instruction to parse.
+ * @param queue Queue to emit at.
+ */
+void emit_system_commands(const BeemuInstruction *instruction, BeemuCommandQueue *queue)
+{
+	if (instruction->params.system_op == BEEMU_CPU_OP_NOP) {
+		return;
+	}
+	BeemuMachineCommand command;
+	command.type = BEEMU_COMMAND_HALT;
+	command.halt.is_cycle_terminator = false;
+	command.halt.halt_operation = instruction->params.system_op;
+	beemu_command_queue_enqueue(queue, &command);
+}
+
 BeemuCommandQueue *beemu_parser_parse(const BeemuProcessor *processor, const BeemuInstruction *instruction) {
 	BeemuCommandQueue *queue = beemu_command_queue_new();
+	beemu_parser_parse_into(processor, instruction, queue);
+	return queue;
+}
+
+void beemu_parser_init(void)
+{
+	beemu_parse_cache_build();
+}
+
+void beemu_parser_parse_into(const BeemuProcessor *processor, const BeemuInstruction *instruction, BeemuCommandQueue *queue)
+{
+	const BeemuCommandSkeleton *skeleton = beemu_parse_cache_lookup(processor, instruction);
+	if (!skeleton) {
+		beemu_parser_parse_uncached_into(processor, instruction, queue);
+		return;
+	}
+	beemu_command_queue_init(queue);
+	beemu_parse_cache_evaluate(skeleton, processor, instruction, queue);
+}
+
+/**
+ * Emit the commands of an instruction to the end of a queue.
+ */
+static void emit_commands(const BeemuProcessor *processor, const BeemuInstruction *instruction, BeemuCommandQueue *queue)
+{
 	emit_m1_commands(processor, instruction, queue);
-	if (instruction->type == BEEMU_INSTRUCTION_TYPE_BITWISE) {
+	const bool is_cb_prefixed = instruction->type == BEEMU_INSTRUCTION_TYPE_BITWISE
+		|| (instruction->type == BEEMU_INSTRUCTION_TYPE_ROT_SHIFT && instruction->byte_length == 2);
+	if (is_cb_prefixed) {
 		// This is a CBXX instruction and therefore must also get its
 		// actual OPCODE decoded to IR and PC
 		emit_m2_commands_for_cbxx(processor, instruction, queue);
@@ -73,11 +122,36 @@ BeemuCommandQueue *beemu_parser_parse(const BeemuProcessor *processor, const Bee
 	case BEEMU_INSTRUCTION_TYPE_LOAD:
 		parse_load(queue, processor, instruction);
 		break;
+	case BEEMU_INSTRUCTION_TYPE_ROT_SHIFT:
+		parse_rot_shift(queue, processor, instruction);
+		break;
 	case BEEMU_INSTRUCTION_TYPE_JUMP:
 		parse_jump(queue, processor, instruction);
 		break;
+	case BEEMU_INSTRUCTION_TYPE_CPU_CONTROL:
+		emit_system_commands(instruction, queue);
+		break;
 	default:
 		break;
 	}
-	return queue;
+}
+
+void beemu_parser_parse_uncached_into(const BeemuProcessor *processor, const BeemuInstruction *instruction, BeemuCommandQueue *queue)
+{
+	// Discard whatever was left from the previous instruction.
+	beemu_command_queue_init(queue);
+	emit_commands(processor, instruction, queue);
+}
+
+void beemu_parser_record_into(
+	const BeemuProcessor *processor,
+	const BeemuInstruction *instruction,
+	BeemuCommandQueue *queue,
+	BeemuCommandSlots *slots)
+{
+	beemu_command_queue_init(queue);
+	memset(slots, 0, sizeof(BeemuCommandSlots));
+	queue->slots = slots;
+	emit_commands(processor, instruction, queue);
+	queue->slots = 0;
 }
@@ -16,6 +16,7 @@ extern "C"
 {
 #endif
 #include "../command.h"
+#include "command_slot.h"
 #include "beemu/device/processor/processor.h"
 
 /**
@@ -31,6 +32,53 @@ extern "C"
  */
 BeemuCommandQueue *beemu_parser_parse(const BeemuProcessor *processor, const BeemuInstruction *instruction);
 
+/**
+ * @brief Parse an instruction into an existing command queue.
+ *
+ * Non-allocating counterpart of beemu_parser_parse, the queue is reset in
+ * constant time before the commands are emitted into it, so a single queue
+ * can be reused for every instruction.
+ * @param processor BeemuProcessor to act on.
+ * @param instruction Instruction to parse.
+ * @param queue Queue to reset and emit the commands to.
+ */
+void beemu_parser_parse_into(const BeemuProcessor *processor, const BeemuInstruction *instruction, BeemuCommandQueue *queue);
+
+/**
+ * @brief Parse an instruction without consulting the command skeleton cache.
+ *
+ * Always walks the per instruction type parsers.
+ * @param processor BeemuProcessor to act on.
+ * @param instruction Instruction to parse.
+ * @param queue Queue to reset and emit the commands to.
+ */
+void beemu_parser_parse_uncached_into(const BeemuProcessor *processor, const BeemuInstruction *instruction, BeemuCommandQueue *queue);
+
+/**
+ * @brief Parse an instruction without the cache, recording the slot of every value.
+ *
+ * Each value the parsers emit comes with the slot describing how it is
+ * computed from the processor state, this is what the skeleton cache is
+ * built from.
+ * @param processor BeemuProcessor to act on.
+ * @param instruction Instruction to parse.
+ * @param queue Queue to reset and emit the commands to.
+ * @param slots Set to the slots of the commands in the queue.
+ */
+void beemu_parser_record_into(
+	const BeemuProcessor *processor,
+	const BeemuInstruction *instruction,
+	BeemuCommandQueue *queue,
+	BeemuCommandSlots *slots);
+
+/**
+ * @brief Build the parser's per opcode command skeleton cache.
+ *
+ * Parsing builds the cache lazily on first use, calling this beforehand
+ * moves that cost to startup.
+ */
+void beemu_parser_init(void);
+
 #endif // BEEMU_PARSER_H
 #ifdef __cplusplus
 	}
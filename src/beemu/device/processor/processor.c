@@ -1,13 +1,28 @@
 #include <stdlib.h>
+#include <beemu/device/processor/executor.h>
 #include <beemu/device/processor/processor.h>
+#include <beemu/device/processor/tokenizer.h>
+#include "alu.h"
+#include "interpreter/invoker.h"
+#include "interpreter/parser/parser.h"
 
 BeemuProcessor *beemu_processor_new(void)
 {
+	// Build the decode tables, ALU tables and command skeletons up front
+	// rather than on the first fetch.
+	beemu_tokenizer_init();
+	beemu_alu_tables_build();
+	beemu_parser_init();
 	BeemuProcessor *processor = (BeemuProcessor *)malloc(sizeof(BeemuProcessor));
 	processor->memory = beemu_memory_new(BEEMU_DEVICE_MEMORY_SIZE);
 	processor->registers = beemu_registers_new();
 	processor->interrupts_enabled = true;
 	processor->processor_state = BEEMU_DEVICE_NORMAL;
+	processor->elapsed_clock_cycle = 0;
+	processor->instruction_register = 0;
+	processor->command_queue = beemu_command_queue_new();
+	processor->execution_mode = BEEMU_EXECUTION_MODE_CYCLE_ACCURATE;
+	processor->lazy_flags = false;
 	BeemuRegister pc_register = {.type = BEEMU_SIXTEEN_BIT_REGISTER,
 								 .name_of = {.sixteen_bit_register = BEEMU_REGISTER_PC}};
 	beemu_registers_write_register_value(processor->registers, pc_register, BEEMU_DEVICE_MEMORY_ROM_LOCATION);
@@ -18,9 +33,16 @@ void beemu_processor_free(BeemuProcessor *processor)
 {
 	beemu_memory_free(processor->memory);
 	beemu_registers_free(processor->registers);
+	beemu_command_queue_free(processor->command_queue);
 	free(processor);
 }
 
+bool beemu_processor_load_rom(BeemuProcessor *processor, const BeemuRom *rom)
+{
+	return beemu_rom_map_bank(processor->memory, rom, 0x00, 0)
+		&& beemu_rom_map_bank(processor->memory, rom, 0x40, 1);
+}
+
 /**
  * @brief Set the elapsed clock cycle count for the processor.
  *
@@ -52,8 +74,103 @@ void beemu_processor_set_state(BeemuProcessor *processor, BeemuProcessorState st
 	processor->processor_state = state;
 }
 
+void beemu_processor_set_execution_mode(BeemuProcessor *processor, BeemuExecutionMode mode)
+{
+	processor->execution_mode = mode;
+}
+
+void beemu_processor_set_lazy_flags(BeemuProcessor *processor, bool enabled)
+{
+	processor->lazy_flags = enabled;
+	if (!enabled) {
+		beemu_registers_flags_materialise(processor->registers);
+	}
+}
+
+bool beemu_processor_interrupt_pending(const BeemuProcessor *processor)
+{
+	const uint8_t requested = beemu_memory_read(processor->memory, BEEMU_PROCESSOR_INTERRUPT_FLAG_ADDRESS);
+	const uint8_t enabled = beemu_memory_read(processor->memory, BEEMU_PROCESSOR_INTERRUPT_ENABLE_ADDRESS);
+	return (requested & enabled & 0x1F) != 0;
+}
+
+void beemu_processor_request_interrupt(BeemuProcessor *processor, const BeemuInterrupt interrupt)
+{
+	const uint8_t requested = beemu_memory_read(processor->memory, BEEMU_PROCESSOR_INTERRUPT_FLAG_ADDRESS);
+	beemu_memory_write(processor->memory, BEEMU_PROCESSOR_INTERRUPT_FLAG_ADDRESS, requested | (1 << interrupt));
+}
+
+/**
+ * @brief Fetch the (up to) three bytes an instruction may span.
+ *
+ * @param processor BeemuProcessor object pointer.
+ * @return uint32_t Instruction bytes in the format the tokenizer expects.
+ */
+static inline uint32_t beemu_processor_fetch(BeemuProcessor *processor)
+{
+	const uint16_t pc = processor->registers->program_counter;
+	const uint32_t opcode = beemu_memory_read(processor->memory, pc);
+	const uint32_t first_operand = beemu_memory_read(processor->memory, (uint16_t)(pc + 1));
+	const uint32_t second_operand = beemu_memory_read(processor->memory, (uint16_t)(pc + 2));
+	return (opcode << 16) | (first_operand << 8) | second_operand;
+}
+
+/**
+ * @brief Let a pending EI take effect, after the instruction following it.
+ *
+ * A DI in between cancels it by putting the processor back to normal, any
+ * other state, HALT included, enables the interrupts.
+ */
+static inline void beemu_processor_finish_interrupt_enable(BeemuProcessor *processor)
+{
+	if (processor->processor_state == BEEMU_DEVICE_NORMAL) {
+		return;
+	}
+	processor->interrupts_enabled = true;
+	if (processor->processor_state == BEEMU_DEVICE_AWAITING_INTERRUPT_ENABLE) {
+		processor->processor_state = BEEMU_DEVICE_NORMAL;
+	}
+}
+
+/**
+ * @brief Fetch, decode and execute the instruction at the program counter.
+ *
+ * @return uint8_t Elapsed clock cycles, in M-cycles.
+ */
+static inline uint8_t beemu_processor_execute(BeemuProcessor *processor)
+{
+	const uint16_t pc = processor->registers->program_counter;
+	BeemuInstruction instruction;
+	beemu_tokenizer_tokenize_into(&instruction, beemu_processor_fetch(processor));
+	if (processor->execution_mode == BEEMU_EXECUTION_MODE_INSTRUCTION) {
+		return beemu_executor_execute_instruction(processor, &instruction);
+	}
+	beemu_parser_parse_into(processor, &instruction, processor->command_queue);
+	const uint8_t elapsed_clock_cycle = beemu_invoker_invoke(processor, processor->command_queue, 0, 0);
+	if (instruction.type != BEEMU_INSTRUCTION_TYPE_JUMP) {
+		// Not every parser emits the PC writes for its operand fetches yet,
+		// so land the PC on the next instruction regardless. Jumps load
+		// the PC themselves.
+		processor->registers->program_counter = pc + instruction.byte_length;
+	}
+	return elapsed_clock_cycle;
+}
+
 uint8_t beemu_processor_run(BeemuProcessor *processor)
 {
-	return 0x0;
-	// execute_instruction(processor->memory, processor->registers, ...);
+	if (beemu_processor_is_halted(processor)) {
+		if (!beemu_processor_interrupt_pending(processor)) {
+			// Idle for a cycle, see beemu_device_run_cycles for skipping ahead.
+			beemu_processor_set_elapsed_clock_cycle(processor, 1);
+			return 1;
+		}
+		processor->processor_state = BEEMU_DEVICE_NORMAL;
+	}
+	const bool enabling_interrupts = processor->processor_state == BEEMU_DEVICE_AWAITING_INTERRUPT_ENABLE;
+	const uint8_t elapsed_clock_cycle = beemu_processor_execute(processor);
+	if (enabling_interrupts) {
+		beemu_processor_finish_interrupt_enable(processor);
+	}
+	beemu_processor_set_elapsed_clock_cycle(processor, elapsed_clock_cycle);
+	return elapsed_clock_cycle;
 }
@@ -0,0 +1,130 @@
+#include "tokenize_table.h"
+#include "tokenize_common.h"
+
+#include <stddef.h>
+#include <string.h>
+#include "../../../internals/once.h"
+
+// One entry per opcode for the unprefixed and the CB prefixed instructions.
+static BeemuDecodeTableEntry UNPREFIXED_DECODE_TABLE[256];
+static BeemuDecodeTableEntry CB_PREFIXED_DECODE_TABLE[256];
+static BeemuOnce decode_tables_once = BEEMU_ONCE_INIT;
+
+/**
+ * Check if a param holds an immediate taken from the instruction operand.
+ */
+static bool is_param_immediate(const BeemuParam *param)
+{
+	return param->type == BEEMU_PARAM_TYPE_UINT_8
+		|| param->type == BEEMU_PARAM_TYPE_UINT16
+		|| param->type == BEEMU_PARAM_TYPE_INT_8;
+}
+
+/**
+ * Find the param that holds the operand of a multibyte instruction, and
+ * record its offset within the token.
+ */
+static void locate_operand(BeemuDecodeTableEntry *entry)
+{
+	const BeemuInstruction *token = &entry->token;
+	const BeemuParam *candidates[3] = {0};
+	entry->has_operand = false;
+	if (token->byte_length == 1) {
+		// The opcode is the whole instruction.
+		return;
+	}
+	switch (token->type) {
+	case BEEMU_INSTRUCTION_TYPE_LOAD:
+		candidates[0] = &token->params.load_params.source;
+		candidates[1] = &token->params.load_params.dest;
+		candidates[2] = &token->params.load_params.auxPostLoadParameter;
+		break;
+	case BEEMU_INSTRUCTION_TYPE_ARITHMATIC:
+		candidates[0] = &token->params.arithmatic_params.source_or_second;
+		candidates[1] = &token->params.arithmatic_params.dest_or_first;
+		break;
+	case BEEMU_INSTRUCTION_TYPE_JUMP:
+		candidates[0] = &token->params.jump_params.param;
+		break;
+	default:
+		// STOP is two bytes long but its operand is meaningless.
+		return;
+	}
+	for (int i = 0; i < 3; i++) {
+		if (candidates[i] && is_param_immediate(candidates[i])) {
+			entry->has_operand = true;
+			entry->operand_offset = (uint16_t)((const char *)candidates[i] - (const char *)token);
+			return;
+		}
+	}
+}
+
+void beemu_tokenizer_table_build(void)
+{
+	if (!beemu_once_begin(&decode_tables_once)) {
+		return;
+	}
+	for (uint32_t opcode = 0; opcode < 256; opcode++) {
+		BeemuDecodeTableEntry *unprefixed = &UNPREFIXED_DECODE_TABLE[opcode];
+		memset(unprefixed, 0, sizeof(BeemuDecodeTableEntry));
+		// Operand bytes are left as zero and patched on decode.
+		beemu_tokenizer_decode_without_table(&unprefixed->token, opcode << 16);
+		locate_operand(unprefixed);
+
+		BeemuDecodeTableEntry *prefixed = &CB_PREFIXED_DECODE_TABLE[opcode];
+		memset(prefixed, 0, sizeof(BeemuDecodeTableEntry));
+		// CB prefixed instructions have no operands, so these are exact.
+		beemu_tokenizer_decode_without_table(&prefixed->token, (0xCB << 16) | (opcode << 8));
+		prefixed->has_operand = false;
+	}
+	beemu_once_end(&decode_tables_once);
+}
+
+/**
+ * Write the operand of an instruction into its param, exactly the way
+ * the tokenize_* functions would.
+ */
+static void patch_operand(BeemuParam *param, const uint32_t original_machine_code)
+{
+	switch (param->type) {
+	case BEEMU_PARAM_TYPE_UINT_8:
+		param->value.value = original_machine_code & 0xFF;
+		break;
+	case BEEMU_PARAM_TYPE_UINT16:
+		param->value.value = beemu_parse_uint16_operand(original_machine_code);
+		break;
+	case BEEMU_PARAM_TYPE_INT_8:
+		parse_signed8_param_from_instruction(param, original_machine_code);
+		break;
+	default:
+		break;
+	}
+}
+
+void beemu_tokenizer_table_decode(BeemuInstruction *token, const uint32_t instruction)
+{
+	if (!beemu_once_is_done(&decode_tables_once)) {
+		beemu_tokenizer_table_build();
+	}
+	if (instruction >> 16 == 0xCB) {
+		*token = CB_PREFIXED_DECODE_TABLE[(instruction >> 8) & 0xFF].token;
+		return;
+	}
+	const BeemuDecodeTableEntry *entry = &UNPREFIXED_DECODE_TABLE[(instruction >> 16) & 0xFF];
+	*token = entry->token;
+	// Canonise the machine code the same way determine_byte_length_and_cleanup does.
+	switch (token->byte_length) {
+	case 1:
+		// Template already holds the opcode.
+		return;
+	case 2:
+		token->original_machine_code = (instruction >> 8) & 0xFFFF;
+		break;
+	default:
+		token->original_machine_code = instruction & 0xFFFFFF;
+		break;
+	}
+	if (entry->has_operand) {
+		patch_operand((BeemuParam *)((char *)token + entry->operand_offset), token->original_machine_code);
+	}
+}
@@ -0,0 +1,65 @@
+/**
+ * @file tokenize_table.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Private header file for the pre-decoded instruction table.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_PROCESSOR_TOKENIZER_TOKENIZE_TABLE_H
+#define BEEMU_PROCESSOR_TOKENIZER_TOKENIZE_TABLE_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <beemu/device/primitives/instruction.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+	/**
+	 * @brief A single pre-decoded opcode.
+	 *
+	 * Token is decoded with its operand bytes set to zero, when the instruction
+	 * has an immediate operand, the param holding it is located at operand_offset
+	 * bytes into the token and is patched on decode.
+	 */
+	typedef struct BeemuDecodeTableEntry {
+		BeemuInstruction token;
+		bool has_operand;
+		uint16_t operand_offset;
+	} BeemuDecodeTableEntry;
+
+	/**
+	 * @brief Build the 256 unprefixed and 256 CB prefixed decode tables.
+	 *
+	 * Idempotent, the tables are built the first time this is called.
+	 */
+	void beemu_tokenizer_table_build(void);
+
+	/**
+	 * @brief Decode an instruction by copying its pre-decoded template.
+	 *
+	 * @param token Token to fill.
+	 * @param instruction Instruction in the same format beemu_tokenizer_tokenize expects.
+	 */
+	void beemu_tokenizer_table_decode(BeemuInstruction *token, uint32_t instruction);
+
+	/**
+	 * @brief Decode an instruction by walking the tokenizer classifiers.
+	 *
+	 * This is the decoder the tables are built from, and is kept around
+	 * to verify the tables against.
+	 *
+	 * @param token Zero initialised token to fill.
+	 * @param instruction Instruction in the same format beemu_tokenizer_tokenize expects.
+	 */
+	void beemu_tokenizer_decode_without_table(BeemuInstruction *token, uint32_t instruction);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BEEMU_PROCESSOR_TOKENIZER_TOKENIZE_TABLE_H
@@ -4,6 +4,7 @@
 #include "tokenize_load.h"
 #include "tokenize_system.h"
 #include "tokenize_jump.h"
+#include "tokenize_table.h"
 
 #include <beemu/device/memory.h>
 #include <beemu/device/processor/processor.h>
@@ -11,13 +12,12 @@
 #include <beemu/internals/utility.h>
 #include <stdlib.h>
 
-BeemuInstruction* beemu_tokenizer_tokenize(uint32_t instruction)
+void beemu_tokenizer_decode_without_table(BeemuInstruction* inst, uint32_t instruction)
 {
-	BeemuInstruction* inst = calloc(1, sizeof(BeemuInstruction));
 	inst->original_machine_code = instruction;
 	uint8_t opcode = determine_byte_length_and_cleanup(inst);
 	if (tokenize_system(inst, opcode)) {
-		return inst;
+		return;
 	}
 
 	if ((inst->byte_length == 2 && opcode == 0xCB) || ((opcode & 0xE7) == 0x07) ) {
@@ -31,11 +31,26 @@ BeemuInstruction* beemu_tokenizer_tokenize(uint32_t instruction)
 	} else if (jump_subtype_if_jump(opcode)) {
 		tokenize_jump(inst, opcode);
 	}
+}
+
+void beemu_tokenizer_init(void)
+{
+	beemu_tokenizer_table_build();
+}
 
+void beemu_tokenizer_tokenize_into(BeemuInstruction* token, uint32_t instruction)
+{
+	beemu_tokenizer_table_decode(token, instruction);
+}
+
+BeemuInstruction* beemu_tokenizer_tokenize(uint32_t instruction)
+{
+	BeemuInstruction* inst = malloc(sizeof(BeemuInstruction));
+	beemu_tokenizer_tokenize_into(inst, instruction);
 	return inst;
 };
 
 void beemu_tokenizer_free_token(BeemuInstruction* token)
 {
 	free(token);
-}
\ No newline at end of file
+}
@@ -0,0 +1,161 @@
+/**
+ * @file rom.c
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Cartridge ROMs mapped straight from their files.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <beemu/device/rom.h>
+#include <beemu/internals/logger.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define BEEMU_ROM_HEADER_TITLE 0x0134
+#define BEEMU_ROM_HEADER_CARTRIDGE_TYPE 0x0147
+#define BEEMU_ROM_HEADER_ROM_SIZE 0x0148
+#define BEEMU_ROM_HEADER_RAM_SIZE 0x0149
+#define BEEMU_ROM_HEADER_CHECKSUM 0x014D
+
+/**
+ * Map the whole file read only, filling the data, size and mapping fields.
+ * @return true if the file was mapped.
+ */
+static bool map_file(BeemuRom *rom, const char *path)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	// The mapping keeps the file open on its own.
+	CloseHandle(file);
+	if (!mapping) {
+		return false;
+	}
+	const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data) {
+		CloseHandle(mapping);
+		return false;
+	}
+	rom->data = data;
+	rom->size = (size_t)file_size.QuadPart;
+	rom->mapping = mapping;
+	return true;
+#else
+	const int file = open(path, O_RDONLY);
+	if (file < 0) {
+		return false;
+	}
+	struct stat file_stat;
+	if (fstat(file, &file_stat) != 0 || file_stat.st_size == 0) {
+		close(file);
+		return false;
+	}
+	// Shared, read only mappings of the same file share their physical
+	// pages, however many instances map it.
+	void *data = mmap(NULL, file_stat.st_size, PROT_READ, MAP_SHARED, file, 0);
+	// The mapping keeps the file open on its own.
+	close(file);
+	if (data == MAP_FAILED) {
+		return false;
+	}
+	rom->data = data;
+	rom->size = file_stat.st_size;
+	rom->mapping = 0;
+	return true;
+#endif
+}
+
+/**
+ * Unmap a file mapped by map_file.
+ */
+static void unmap_file(BeemuRom *rom)
+{
+#ifdef _WIN32
+	UnmapViewOfFile(rom->data);
+	CloseHandle(rom->mapping);
+#else
+	munmap((void *)rom->data, rom->size);
+#endif
+}
+
+/**
+ * Parse the cartridge header of a mapped ROM.
+ */
+static void parse_header(const uint8_t *data, BeemuRomHeader *header)
+{
+	memcpy(header->title, data + BEEMU_ROM_HEADER_TITLE, 16);
+	header->title[16] = '\0';
+	header->cartridge_type = data[BEEMU_ROM_HEADER_CARTRIDGE_TYPE];
+	header->rom_size_code = data[BEEMU_ROM_HEADER_ROM_SIZE];
+	header->ram_size_code = data[BEEMU_ROM_HEADER_RAM_SIZE];
+	// 32 KiB shifted left by the size code.
+	header->bank_count = header->rom_size_code <= 8 ? 2 << header->rom_size_code : 0;
+	uint8_t checksum = 0;
+	for (int address = BEEMU_ROM_HEADER_TITLE; address < BEEMU_ROM_HEADER_CHECKSUM; address++) {
+		checksum = checksum - data[address] - 1;
+	}
+	header->header_checksum_valid = checksum == data[BEEMU_ROM_HEADER_CHECKSUM];
+}
+
+BeemuRom *beemu_rom_open(const char *path)
+{
+	BeemuRom *rom = (BeemuRom *)malloc(sizeof(BeemuRom));
+	if (!map_file(rom, path)) {
+		BEEMU_LOG(BEEMU_LOG_ERR, "Could not map the ROM file %s", path);
+		free(rom);
+		return 0;
+	}
+	if (rom->size < 2 * BEEMU_ROM_BANK_SIZE) {
+		BEEMU_LOG(BEEMU_LOG_ERR, "ROM file %s is smaller than two banks", path);
+		beemu_rom_close(rom);
+		return 0;
+	}
+	parse_header(rom->data, &rom->header);
+	if (rom->header.bank_count == 0 || rom->size < (size_t)rom->header.bank_count * BEEMU_ROM_BANK_SIZE) {
+		BEEMU_LOG(BEEMU_LOG_ERR, "ROM file %s is smaller than its header declares", path);
+		beemu_rom_close(rom);
+		return 0;
+	}
+	if (!rom->header.header_checksum_valid) {
+		BEEMU_LOG(BEEMU_LOG_WARN, "ROM file %s has an invalid header checksum", path);
+	}
+	return rom;
+}
+
+void beemu_rom_close(BeemuRom *rom)
+{
+	unmap_file(rom);
+	free(rom);
+}
+
+bool beemu_rom_map_bank(BeemuMemory *memory, const BeemuRom *rom, uint8_t first_page, uint16_t bank)
+{
+	if (bank >= rom->header.bank_count) {
+		return false;
+	}
+	static const uint16_t pages_per_bank = BEEMU_ROM_BANK_SIZE / BEEMU_MEMORY_PAGE_SIZE;
+	const BeemuMemoryHandler read_only = {0, 0, 0};
+	beemu_memory_map_pages(memory, first_page, pages_per_bank, rom->data + (size_t)bank * BEEMU_ROM_BANK_SIZE, 0);
+	beemu_memory_set_page_handlers(memory, first_page, pages_per_bank, read_only);
+	return true;
+}
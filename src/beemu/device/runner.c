@@ -0,0 +1,241 @@
+/**
+ * @file runner.c
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Work stealing thread pool that runs many devices at once.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <beemu/device/runner.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <threads.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Size of a cache line, queues are padded to it so that threads
+ * popping from their own queue never contend on each other's.
+ */
+#define BEEMU_RUNNER_CACHE_LINE 64
+
+/**
+ * @brief Job indices left to a thread, its owner pops from the front and
+ * other threads steal from the back.
+ */
+typedef struct BeemuRunnerQueue
+{
+	/** @brief front << 32 | back, the half open range of jobs left. */
+	_Atomic uint64_t range;
+	char padding[BEEMU_RUNNER_CACHE_LINE - sizeof(uint64_t)];
+} BeemuRunnerQueue;
+
+/**
+ * @brief State shared by all threads of a single beemu_runner_run call.
+ */
+typedef struct BeemuRunnerPool
+{
+	BeemuRunnerJob *jobs;
+	BeemuRunnerQueue *queues;
+	uint32_t thread_count;
+} BeemuRunnerPool;
+
+/**
+ * @brief State private to a single thread of the pool.
+ */
+typedef struct BeemuRunnerWorker
+{
+	const BeemuRunnerPool *pool;
+	uint32_t index;
+	uint64_t stolen_jobs;
+} BeemuRunnerWorker;
+
+static double now_seconds(void)
+{
+	struct timespec now;
+#ifdef TIME_MONOTONIC
+	timespec_get(&now, TIME_MONOTONIC);
+#else
+	timespec_get(&now, TIME_UTC);
+#endif
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+uint32_t beemu_runner_hardware_thread_count(void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	const long count = (long)info.dwNumberOfProcessors;
+#else
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	return count < 1 ? 1 : (uint32_t)count;
+}
+
+/**
+ * @brief Take a job from either end of a queue.
+ *
+ * @param queue Queue to take from.
+ * @param from_back true to steal from the back, false to pop from the front.
+ * @param job_index Set to the index of the job taken.
+ * @return true if a job was taken, false if the queue is empty.
+ */
+static bool take_job(BeemuRunnerQueue *queue, const bool from_back, uint32_t *job_index)
+{
+	uint64_t range = atomic_load_explicit(&queue->range, memory_order_relaxed);
+	for (;;)
+	{
+		const uint32_t front = range >> 32;
+		const uint32_t back = (uint32_t)range;
+		if (front >= back)
+		{
+			return false;
+		}
+		const uint64_t taken = from_back ? (uint64_t)front << 32 | (back - 1) : (uint64_t)(front + 1) << 32 | back;
+		if (atomic_compare_exchange_weak_explicit(&queue->range, &range, taken, memory_order_acq_rel, memory_order_relaxed))
+		{
+			*job_index = from_back ? back - 1 : front;
+			return true;
+		}
+	}
+}
+
+/**
+ * @brief Run a device until it has used up its budget.
+ */
+static void run_job(BeemuRunnerJob *job)
+{
+	const double start = now_seconds();
+	const uint64_t elapsed_cycles = beemu_device_run_cycles(job->device, job->cycle_budget);
+	job->elapsed_cycles = elapsed_cycles;
+	job->elapsed_seconds = now_seconds() - start;
+}
+
+/**
+ * @brief Body of every thread in the pool, runs jobs until no queue has any left.
+ */
+static int run_worker(void *argument)
+{
+	BeemuRunnerWorker *worker = argument;
+	const BeemuRunnerPool *pool = worker->pool;
+	uint32_t job_index;
+	for (;;)
+	{
+		if (take_job(&pool->queues[worker->index], false, &job_index))
+		{
+			run_job(&pool->jobs[job_index]);
+			continue;
+		}
+		// Jobs are never added once the pool starts, so once every other
+		// queue is empty too, this thread is done.
+		bool stole = false;
+		for (uint32_t offset = 1; offset < pool->thread_count && !stole; offset++)
+		{
+			const uint32_t victim = (worker->index + offset) % pool->thread_count;
+			stole = take_job(&pool->queues[victim], true, &job_index);
+		}
+		if (!stole)
+		{
+			return 0;
+		}
+		worker->stolen_jobs++;
+		run_job(&pool->jobs[job_index]);
+	}
+}
+
+bool beemu_runner_run(BeemuRunnerJob *jobs, const size_t job_count, uint32_t thread_count, BeemuRunnerReport *report)
+{
+	if (job_count > UINT32_MAX)
+	{
+		return false;
+	}
+	if (thread_count == 0)
+	{
+		thread_count = beemu_runner_hardware_thread_count();
+	}
+	if (thread_count > job_count)
+	{
+		thread_count = job_count > 0 ? (uint32_t)job_count : 1;
+	}
+	BeemuRunnerQueue *queues = calloc(thread_count, sizeof(BeemuRunnerQueue));
+	BeemuRunnerWorker *workers = calloc(thread_count, sizeof(BeemuRunnerWorker));
+	thrd_t *threads = calloc(thread_count, sizeof(thrd_t));
+	bool *started = calloc(thread_count, sizeof(bool));
+	if (queues == NULL || workers == NULL || threads == NULL || started == NULL)
+	{
+		free(queues);
+		free(workers);
+		free(threads);
+		free(started);
+		return false;
+	}
+	// Deal out contiguous slices of the jobs, stealing evens out the rest.
+	const BeemuRunnerPool pool = {.jobs = jobs, .queues = queues, .thread_count = thread_count};
+	for (uint32_t i = 0; i < thread_count; i++)
+	{
+		const uint64_t front = job_count * i / thread_count;
+		const uint64_t back = job_count * (i + 1) / thread_count;
+		atomic_init(&queues[i].range, front << 32 | back);
+		workers[i].pool = &pool;
+		workers[i].index = i;
+		workers[i].stolen_jobs = 0;
+	}
+	for (size_t i = 0; i < job_count; i++)
+	{
+		jobs[i].elapsed_cycles = 0;
+		jobs[i].elapsed_seconds = 0;
+	}
+
+	const double start = now_seconds();
+	// The calling thread is worker 0. A thread that fails to start leaves
+	// its queue to be stolen by the others.
+	for (uint32_t i = 1; i < thread_count; i++)
+	{
+		started[i] = thrd_create(&threads[i], run_worker, &workers[i]) == thrd_success;
+	}
+	run_worker(&workers[0]);
+	for (uint32_t i = 1; i < thread_count; i++)
+	{
+		if (started[i])
+		{
+			thrd_join(threads[i], NULL);
+		}
+	}
+	const double wall_seconds = now_seconds() - start;
+
+	if (report != NULL)
+	{
+		report->total_cycles = 0;
+		for (size_t i = 0; i < job_count; i++)
+		{
+			report->total_cycles += jobs[i].elapsed_cycles;
+		}
+		report->wall_seconds = wall_seconds;
+		report->cycles_per_second = wall_seconds > 0 ? report->total_cycles / wall_seconds : 0;
+		report->thread_count = 0;
+		report->stolen_jobs = 0;
+		for (uint32_t i = 0; i < thread_count; i++)
+		{
+			report->thread_count += i == 0 || started[i];
+			report->stolen_jobs += workers[i].stolen_jobs;
+		}
+	}
+	free(started);
+	free(threads);
+	free(workers);
+	free(queues);
+	return true;
+}
+
+double beemu_runner_job_cycles_per_second(const BeemuRunnerJob *job)
+{
+	return job->elapsed_seconds > 0 ? job->elapsed_cycles / job->elapsed_seconds : 0;
+}
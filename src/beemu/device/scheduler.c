@@ -0,0 +1,155 @@
+/**
+ * @file scheduler.c
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Min-heap of the absolute cycles at which components need attention.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <beemu/device/scheduler.h>
+
+/**
+ * @brief Check if an event has to fire before another one.
+ */
+static inline bool is_earlier(const BeemuScheduledEvent *lhs, const BeemuScheduledEvent *rhs)
+{
+	return lhs->deadline < rhs->deadline || (lhs->deadline == rhs->deadline && lhs->type < rhs->type);
+}
+
+/**
+ * @brief Put an event into a heap slot and record its position.
+ */
+static inline void place(BeemuScheduler *scheduler, const uint8_t index, const BeemuScheduledEvent event)
+{
+	scheduler->heap[index] = event;
+	scheduler->positions[event.type] = index;
+}
+
+/**
+ * @brief Move the event at index towards the root until the heap is ordered.
+ */
+static void sift_up(BeemuScheduler *scheduler, uint8_t index)
+{
+	const BeemuScheduledEvent event = scheduler->heap[index];
+	while (index > 0)
+	{
+		const uint8_t parent = (index - 1) / 2;
+		if (!is_earlier(&event, &scheduler->heap[parent]))
+		{
+			break;
+		}
+		place(scheduler, index, scheduler->heap[parent]);
+		index = parent;
+	}
+	place(scheduler, index, event);
+}
+
+/**
+ * @brief Move the event at index towards the leaves until the heap is ordered.
+ */
+static void sift_down(BeemuScheduler *scheduler, uint8_t index)
+{
+	const BeemuScheduledEvent event = scheduler->heap[index];
+	for (;;)
+	{
+		const uint8_t left = index * 2 + 1;
+		if (left >= scheduler->size)
+		{
+			break;
+		}
+		const uint8_t right = left + 1;
+		const uint8_t child = right < scheduler->size && is_earlier(&scheduler->heap[right], &scheduler->heap[left]) ? right : left;
+		if (!is_earlier(&scheduler->heap[child], &event))
+		{
+			break;
+		}
+		place(scheduler, index, scheduler->heap[child]);
+		index = child;
+	}
+	place(scheduler, index, event);
+}
+
+/**
+ * @brief Remove the event at a heap index.
+ */
+static void remove_at(BeemuScheduler *scheduler, const uint8_t index)
+{
+	scheduler->positions[scheduler->heap[index].type] = -1;
+	scheduler->size--;
+	if (index == scheduler->size)
+	{
+		return;
+	}
+	// Fill the hole with the last event, which may have to go either way.
+	const BeemuScheduledEvent last = scheduler->heap[scheduler->size];
+	place(scheduler, index, last);
+	if (index > 0 && is_earlier(&last, &scheduler->heap[(index - 1) / 2]))
+	{
+		sift_up(scheduler, index);
+	}
+	else
+	{
+		sift_down(scheduler, index);
+	}
+}
+
+void beemu_scheduler_init(BeemuScheduler *scheduler)
+{
+	scheduler->size = 0;
+	for (int type = 0; type < BEEMU_EVENT_TYPE_COUNT; type++)
+	{
+		scheduler->positions[type] = -1;
+	}
+}
+
+void beemu_scheduler_schedule(BeemuScheduler *scheduler, const BeemuEventType type, const uint64_t deadline)
+{
+	const BeemuScheduledEvent event = {.deadline = deadline, .type = type};
+	const int8_t position = scheduler->positions[type];
+	if (position < 0)
+	{
+		place(scheduler, scheduler->size, event);
+		scheduler->size++;
+		sift_up(scheduler, scheduler->size - 1);
+		return;
+	}
+	const bool moved_earlier = deadline < scheduler->heap[position].deadline;
+	scheduler->heap[position].deadline = deadline;
+	if (moved_earlier)
+	{
+		sift_up(scheduler, position);
+	}
+	else
+	{
+		sift_down(scheduler, position);
+	}
+}
+
+void beemu_scheduler_cancel(BeemuScheduler *scheduler, const BeemuEventType type)
+{
+	const int8_t position = scheduler->positions[type];
+	if (position >= 0)
+	{
+		remove_at(scheduler, position);
+	}
+}
+
+bool beemu_scheduler_pop_due(BeemuScheduler *scheduler, const uint64_t now, BeemuScheduledEvent *event)
+{
+	if (scheduler->size == 0 || scheduler->heap[0].deadline > now)
+	{
+		return false;
+	}
+	*event = scheduler->heap[0];
+	remove_at(scheduler, 0);
+	return true;
+}
+
+uint64_t beemu_scheduler_deadline(const BeemuScheduler *scheduler, const BeemuEventType type)
+{
+	const int8_t position = scheduler->positions[type];
+	return position < 0 ? BEEMU_SCHEDULER_NEVER : scheduler->heap[position].deadline;
+}
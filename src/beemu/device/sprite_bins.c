@@ -0,0 +1,62 @@
+/**
+ * @file sprite_bins.c
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Sprites of OAM sorted into the lines they are drawn on, rebuilt as OAM is written.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <beemu/device/display.h>
+#include <beemu/device/sprite_bins.h>
+#include <string.h>
+
+void beemu_sprite_bins_init(BeemuSpriteBins *bins)
+{
+	memset(bins->counts, 0, sizeof(bins->counts));
+	bins->size = BEEMU_SPRITE_SIZE_8_TO_8;
+	bins->dirty = true;
+	bins->builds = 0;
+}
+
+void beemu_sprite_bins_build(BeemuSpriteBins *bins, BeemuMemory *memory, const BeemuSpriteSize size)
+{
+	const int height = size == BEEMU_SPRITE_SIZE_8_TO_16 ? 16 : 8;
+	// X of each sprite in the bins, to keep them sorted as they are added.
+	uint8_t xs[BEEMU_SPRITE_BINS_LINE_COUNT][BEEMU_SPRITE_BINS_SPRITES_PER_LINE];
+	memset(bins->counts, 0, sizeof(bins->counts));
+	for (int i = 0; i < BEEMU_DISPLAY_SPRITE_COUNT; i++)
+	{
+		const uint16_t address = BEEMU_DISPLAY_OAM_ADDRESS + i * 4;
+		// Y is offset by 16, so that sprites can start above the screen.
+		const int top = beemu_memory_read(memory, address) - 16;
+		const uint8_t x = beemu_memory_read(memory, address + 1);
+		const int first_line = top < 0 ? 0 : top;
+		const int last_line = top + height > BEEMU_SPRITE_BINS_LINE_COUNT ? BEEMU_SPRITE_BINS_LINE_COUNT : top + height;
+		for (int line = first_line; line < last_line; line++)
+		{
+			// Lines that are full already selected 10 sprites earlier in OAM.
+			uint8_t count = bins->counts[line];
+			if (count == BEEMU_SPRITE_BINS_SPRITES_PER_LINE)
+			{
+				continue;
+			}
+			// Sprites come in OAM order, so going after those with the same X
+			// keeps ties in OAM order.
+			int j = count;
+			for (; j > 0 && xs[line][j - 1] > x; j--)
+			{
+				bins->sprites[line][j] = bins->sprites[line][j - 1];
+				xs[line][j] = xs[line][j - 1];
+			}
+			bins->sprites[line][j] = address;
+			xs[line][j] = x;
+			bins->counts[line] = count + 1;
+		}
+	}
+	bins->size = size;
+	bins->dirty = false;
+	bins->builds++;
+}
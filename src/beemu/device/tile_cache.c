@@ -0,0 +1,34 @@
+/**
+ * @file tile_cache.c
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Decoded tiles of VRAM, invalidated per tile as VRAM is written.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <beemu/device/pixel_kernels.h>
+#include <beemu/device/tile_cache.h>
+#include <string.h>
+
+void beemu_tile_cache_init(BeemuTileCache *cache)
+{
+	memset(cache->tiles, 0, sizeof(cache->tiles));
+	memset(cache->dirty, true, sizeof(cache->dirty));
+	cache->hits = 0;
+	cache->misses = 0;
+}
+
+void beemu_tile_cache_decode(BeemuTileCache *cache, BeemuMemory *memory, const uint16_t tile)
+{
+	const uint16_t address = BEEMU_TILE_CACHE_TILE_DATA_ADDRESS + tile * 16;
+	uint8_t rows[16];
+	for (int i = 0; i < 16; i++)
+	{
+		rows[i] = beemu_memory_read(memory, address + i);
+	}
+	beemu_pixel_kernels_get()->decode_rows(rows, 8, cache->tiles[tile][0]);
+	cache->dirty[tile] = false;
+}
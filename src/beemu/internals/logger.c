@@ -3,35 +3,41 @@
 #include <stdio.h>
 #include <time.h>
 
+BeemuLogLevel beemu_log_level = BEEMU_LOG_WARN;
+
+void beemu_log_set_level(BeemuLogLevel level)
+{
+	beemu_log_level = level;
+}
+
 /**
- * @brief Print log level.
+ * @brief Name of a log level, as printed before the message.
  *
  * @param level
  */
-void print_prelude(BeemuLogLevel level)
+static const char *level_prelude(BeemuLogLevel level)
 {
 	switch (level)
 	{
 	case BEEMU_LOG_INFO:
-		printf("INFO: ");
-		break;
+		return "INFO: ";
 	case BEEMU_LOG_ERR:
-		printf("ERROR: ");
-		break;
+		return "ERROR: ";
 	case BEEMU_LOG_WARN:
-		printf("WARN: ");
-		break;
+		return "WARN: ";
 	}
+	return "";
 }
 
 void beemu_log(BeemuLogLevel level, const char *fmt, ...)
 {
-#ifndef DDEBUG
-	print_prelude(level);
+	// Format the whole line first and print it with a single call, so that
+	// lines logged by devices running on different threads never interleave.
+	char line[BEEMU_LOG_LINE_LENGTH];
+	const int prelude_length = snprintf(line, sizeof(line), "%s", level_prelude(level));
 	va_list fmt_args;
 	va_start(fmt_args, fmt);
-	vprintf(fmt, fmt_args);
+	vsnprintf(line + prelude_length, sizeof(line) - prelude_length, fmt, fmt_args);
 	va_end(fmt_args);
-	printf("\n");
-#endif
-}
\ No newline at end of file
+	puts(line);
+}
@@ -0,0 +1,69 @@
+/**
+ * @file once.h
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Private header for building shared tables exactly once, from any thread.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef BEEMU_INTERNALS_ONCE_H
+#define BEEMU_INTERNALS_ONCE_H
+#include <stdatomic.h>
+#include <stdbool.h>
+
+/**
+ * @brief Guards a lazily built table, so that devices running on different
+ * threads never race on building it.
+ */
+typedef struct BeemuOnce
+{
+	_Atomic bool done;
+	atomic_flag lock;
+} BeemuOnce;
+
+#define BEEMU_ONCE_INIT {false, ATOMIC_FLAG_INIT}
+
+/**
+ * @brief Check if the guarded table is built, costs a plain load on x86.
+ */
+static inline bool beemu_once_is_done(BeemuOnce *once)
+{
+	return atomic_load_explicit(&once->done, memory_order_acquire);
+}
+
+/**
+ * @brief Start building the guarded table.
+ *
+ * Waits for any other thread building it first.
+ * @return true if the caller must build the table and then call
+ * beemu_once_end, false if it is already built.
+ */
+static inline bool beemu_once_begin(BeemuOnce *once)
+{
+	if (beemu_once_is_done(once))
+	{
+		return false;
+	}
+	while (atomic_flag_test_and_set_explicit(&once->lock, memory_order_acquire))
+		;
+	if (atomic_load_explicit(&once->done, memory_order_relaxed))
+	{
+		atomic_flag_clear_explicit(&once->lock, memory_order_release);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Publish the guarded table to every thread.
+ */
+static inline void beemu_once_end(BeemuOnce *once)
+{
+	atomic_store_explicit(&once->done, true, memory_order_release);
+	atomic_flag_clear_explicit(&once->lock, memory_order_release);
+}
+
+#endif // BEEMU_INTERNALS_ONCE_H
@@ -0,0 +1,453 @@
+/**
+ * @file trace.c
+ * @author Ege Özkan (elsaambertide@gmail.com)
+ * @brief Binary trace logger that defers formatting to a consumer.
+ * @version 0.1
+ * @date 2025-10-16
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <beemu/internals/trace.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Single producer, single consumer ring owned by one tracing thread.
+ *
+ * Rings are never freed once registered, so that the consumer can keep
+ * draining events left behind by threads that have exited.
+ */
+typedef struct BeemuTraceRing
+{
+	/** @brief Next slot the producer writes to, only written by the producer. */
+	_Atomic size_t head;
+	/** @brief Next slot the consumer reads from, only written by the consumer. */
+	_Atomic size_t tail;
+	uint32_t thread_id;
+	struct BeemuTraceRing *next;
+	BeemuTraceEvent events[BEEMU_TRACE_RING_CAPACITY];
+} BeemuTraceRing;
+
+static _Atomic(BeemuTraceRing *) rings = NULL;
+static _Atomic uint32_t ring_count = 0;
+static _Atomic uint64_t dropped_count = 0;
+static atomic_flag drain_lock = ATOMIC_FLAG_INIT;
+static _Thread_local BeemuTraceRing *thread_ring = NULL;
+
+static const char *level_names[] = {"ERROR", "WARN", "INFO"};
+
+/**
+ * @brief Allocate the calling thread's ring and publish it to the consumer.
+ */
+static BeemuTraceRing *register_thread_ring(void)
+{
+	BeemuTraceRing *ring = malloc(sizeof(BeemuTraceRing));
+	if (ring == NULL)
+	{
+		return NULL;
+	}
+	atomic_init(&ring->head, 0);
+	atomic_init(&ring->tail, 0);
+	ring->thread_id = atomic_fetch_add_explicit(&ring_count, 1, memory_order_relaxed);
+	ring->next = atomic_load_explicit(&rings, memory_order_relaxed);
+	while (!atomic_compare_exchange_weak_explicit(&rings, &ring->next, ring, memory_order_release, memory_order_relaxed))
+		;
+	thread_ring = ring;
+	return ring;
+}
+
+void beemu_trace_record(BeemuLogLevel level, const char *format, const uint64_t *args, size_t arg_count)
+{
+	BeemuTraceRing *ring = thread_ring;
+	if (ring == NULL && (ring = register_thread_ring()) == NULL)
+	{
+		atomic_fetch_add_explicit(&dropped_count, 1, memory_order_relaxed);
+		return;
+	}
+	const size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	if (head - atomic_load_explicit(&ring->tail, memory_order_acquire) == BEEMU_TRACE_RING_CAPACITY)
+	{
+		atomic_fetch_add_explicit(&dropped_count, 1, memory_order_relaxed);
+		return;
+	}
+	BeemuTraceEvent *event = &ring->events[head & (BEEMU_TRACE_RING_CAPACITY - 1)];
+	struct timespec now;
+	timespec_get(&now, TIME_UTC);
+	event->timestamp = (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+	event->format = format;
+	event->thread_id = ring->thread_id;
+	event->level = level;
+	event->arg_count = arg_count < BEEMU_TRACE_MAX_ARGS ? (uint8_t)arg_count : BEEMU_TRACE_MAX_ARGS;
+	for (uint8_t i = 0; i < event->arg_count; i++)
+	{
+		event->args[i] = args[i];
+	}
+	atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+size_t beemu_trace_drain(BeemuTraceEventHandler handler, void *context)
+{
+	if (atomic_flag_test_and_set_explicit(&drain_lock, memory_order_acquire))
+	{
+		return 0;
+	}
+	size_t consumed = 0;
+	for (BeemuTraceRing *ring = atomic_load_explicit(&rings, memory_order_acquire); ring != NULL; ring = ring->next)
+	{
+		const size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+		size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+		for (; tail != head; tail++)
+		{
+			handler(context, &ring->events[tail & (BEEMU_TRACE_RING_CAPACITY - 1)]);
+			consumed++;
+		}
+		atomic_store_explicit(&ring->tail, tail, memory_order_release);
+	}
+	atomic_flag_clear_explicit(&drain_lock, memory_order_release);
+	return consumed;
+}
+
+uint64_t beemu_trace_dropped_count(void)
+{
+	return atomic_load_explicit(&dropped_count, memory_order_relaxed);
+}
+
+/**
+ * @brief Format a single integer conversion.
+ *
+ * The argument is cast according to the conversion's length modifier the
+ * way printf would have read it from the variadic arguments.
+ *
+ * @param spec Null terminated conversion, such as "%02X".
+ * @param length Length modifier of the conversion, "" if there is none.
+ * @param conversion Conversion character.
+ * @param arg Raw argument.
+ */
+static int format_integer(char *buffer, size_t size, const char *spec, const char *length, char conversion, uint64_t arg)
+{
+	// Rebuild the conversion with an ll modifier so that a single call
+	// covers all widths.
+	char widened[40];
+	const size_t prefix = strlen(spec) - strlen(length) - 1;
+	snprintf(widened, sizeof(widened), "%.*sll%c", (int)prefix, spec, conversion);
+	const bool is_signed = conversion == 'd' || conversion == 'i';
+	if (strcmp(length, "hh") == 0)
+	{
+		arg = is_signed ? (uint64_t)(signed char)arg : (unsigned char)arg;
+	}
+	else if (strcmp(length, "h") == 0)
+	{
+		arg = is_signed ? (uint64_t)(short)arg : (unsigned short)arg;
+	}
+	else if (length[0] == '\0')
+	{
+		arg = is_signed ? (uint64_t)(int)arg : (unsigned int)arg;
+	}
+	if (is_signed)
+	{
+		return snprintf(buffer, size, widened, (long long)arg);
+	}
+	return snprintf(buffer, size, widened, (unsigned long long)arg);
+}
+
+size_t beemu_trace_format_event(const BeemuTraceEvent *event, char *buffer, size_t size)
+{
+	size_t written = 0;
+	// Appends to the buffer while keeping track of the untruncated length.
+#define BEEMU_TRACE_APPEND(count)                                    \
+	do {                                                             \
+		const int appended_ = (count);                               \
+		written += appended_ > 0 ? (size_t)appended_ : 0;            \
+	} while (0)
+#define BEEMU_TRACE_REMAINING() (written < size ? size - written : 0)
+#define BEEMU_TRACE_CURSOR() (written < size ? buffer + written : NULL)
+
+	BEEMU_TRACE_APPEND(snprintf(BEEMU_TRACE_CURSOR(), BEEMU_TRACE_REMAINING(), "%s: ", level_names[event->level]));
+	uint8_t next_arg = 0;
+	const char *cursor = event->format;
+	while (*cursor != '\0')
+	{
+		if (*cursor != '%' || cursor[1] == '%')
+		{
+			if (written + 1 < size)
+			{
+				buffer[written] = *cursor;
+			}
+			written++;
+			cursor += *cursor == '%' ? 2 : 1;
+			continue;
+		}
+		char spec[32];
+		size_t spec_length = 0;
+		// Flags, width and precision are kept as they are.
+		do
+		{
+			spec[spec_length++] = *cursor++;
+		} while (*cursor != '\0' && strchr("-+ #0123456789.", *cursor) != NULL && spec_length < 24);
+		const size_t length_start = spec_length;
+		while (*cursor != '\0' && strchr("hljzt", *cursor) != NULL && spec_length < 28)
+		{
+			spec[spec_length++] = *cursor++;
+		}
+		const char conversion = *cursor;
+		if (conversion == '\0')
+		{
+			break;
+		}
+		cursor++;
+		char length[5] = {0};
+		memcpy(length, spec + length_start, spec_length - length_start);
+		spec[spec_length++] = conversion;
+		spec[spec_length] = '\0';
+		if (next_arg == event->arg_count || strchr("diouxXc", conversion) == NULL)
+		{
+			// Missing or non-integer arguments cannot be recovered.
+			BEEMU_TRACE_APPEND(snprintf(BEEMU_TRACE_CURSOR(), BEEMU_TRACE_REMAINING(), "<%s?>", spec));
+			continue;
+		}
+		const uint64_t arg = event->args[next_arg++];
+		if (conversion == 'c')
+		{
+			BEEMU_TRACE_APPEND(snprintf(BEEMU_TRACE_CURSOR(), BEEMU_TRACE_REMAINING(), spec, (int)arg));
+		}
+		else
+		{
+			BEEMU_TRACE_APPEND(format_integer(BEEMU_TRACE_CURSOR(), BEEMU_TRACE_REMAINING(), spec, length, conversion, arg));
+		}
+	}
+	if (size > 0)
+	{
+		buffer[written < size ? written : size - 1] = '\0';
+	}
+	return written;
+#undef BEEMU_TRACE_APPEND
+#undef BEEMU_TRACE_REMAINING
+#undef BEEMU_TRACE_CURSOR
+}
+
+/** BINARY TRACE FILES */
+
+static const char trace_magic[4] = {'B', 'M', 'T', 'R'};
+static const uint32_t trace_version = 1;
+
+/**
+ * @brief Record tags in a binary trace file.
+ */
+typedef enum BeemuTraceRecordTag
+{
+	/** @brief Followed by format ID, length and the format itself. */
+	BEEMU_TRACE_RECORD_FORMAT = 'F',
+	/** @brief Followed by format ID, level, arg count, thread ID, timestamp and args. */
+	BEEMU_TRACE_RECORD_EVENT = 'E'
+} BeemuTraceRecordTag;
+
+struct BeemuTraceWriter
+{
+	FILE *file;
+	/** @brief Open addressing table from format pointers to their IDs. */
+	const char **formats;
+	uint32_t *format_ids;
+	size_t format_capacity;
+	uint32_t format_count;
+	/** @brief Events dropped by the flush in progress. */
+	size_t dropped;
+	/** @brief An event was ever dropped. */
+	bool failed;
+};
+
+static size_t format_slot(const BeemuTraceWriter *writer, const char *format)
+{
+	size_t slot = ((uintptr_t)format >> 3) * 0x9E3779B97F4A7C15ull;
+	for (slot &= writer->format_capacity - 1; writer->formats[slot] != NULL && writer->formats[slot] != format; slot = (slot + 1) & (writer->format_capacity - 1))
+		;
+	return slot;
+}
+
+static bool grow_formats(BeemuTraceWriter *writer)
+{
+	BeemuTraceWriter grown = *writer;
+	grown.format_capacity = writer->format_capacity * 2;
+	grown.formats = calloc(grown.format_capacity, sizeof(const char *));
+	grown.format_ids = calloc(grown.format_capacity, sizeof(uint32_t));
+	if (grown.formats == NULL || grown.format_ids == NULL)
+	{
+		free(grown.formats);
+		free(grown.format_ids);
+		return false;
+	}
+	for (size_t i = 0; i < writer->format_capacity; i++)
+	{
+		if (writer->formats[i] != NULL)
+		{
+			const size_t slot = format_slot(&grown, writer->formats[i]);
+			grown.formats[slot] = writer->formats[i];
+			grown.format_ids[slot] = writer->format_ids[i];
+		}
+	}
+	free(writer->formats);
+	free(writer->format_ids);
+	*writer = grown;
+	return true;
+}
+
+/**
+ * @brief Get the ID of a format, writing its definition first if it is new.
+ *
+ * @return false if the format table could not grow to hold a new format.
+ */
+static bool intern_format(BeemuTraceWriter *writer, const char *format, uint32_t *format_id)
+{
+	if ((writer->format_count + 1) * 2 > writer->format_capacity && !grow_formats(writer))
+	{
+		return false;
+	}
+	const size_t slot = format_slot(writer, format);
+	if (writer->formats[slot] == NULL)
+	{
+		const uint8_t tag = BEEMU_TRACE_RECORD_FORMAT;
+		const uint32_t id = writer->format_count++;
+		const uint32_t length = (uint32_t)strlen(format);
+		fwrite(&tag, sizeof(tag), 1, writer->file);
+		fwrite(&id, sizeof(id), 1, writer->file);
+		fwrite(&length, sizeof(length), 1, writer->file);
+		fwrite(format, 1, length, writer->file);
+		writer->formats[slot] = format;
+		writer->format_ids[slot] = id;
+	}
+	*format_id = writer->format_ids[slot];
+	return true;
+}
+
+static void write_event(void *context, const BeemuTraceEvent *event)
+{
+	BeemuTraceWriter *writer = context;
+	uint32_t format_id;
+	if (!intern_format(writer, event->format, &format_id))
+	{
+		// Without its format the event could not be decoded.
+		writer->dropped++;
+		writer->failed = true;
+		return;
+	}
+	const uint8_t tag = BEEMU_TRACE_RECORD_EVENT;
+	const uint8_t level = event->level;
+	fwrite(&tag, sizeof(tag), 1, writer->file);
+	fwrite(&format_id, sizeof(format_id), 1, writer->file);
+	fwrite(&level, sizeof(level), 1, writer->file);
+	fwrite(&event->arg_count, sizeof(event->arg_count), 1, writer->file);
+	fwrite(&event->thread_id, sizeof(event->thread_id), 1, writer->file);
+	fwrite(&event->timestamp, sizeof(event->timestamp), 1, writer->file);
+	fwrite(event->args, sizeof(uint64_t), event->arg_count, writer->file);
+}
+
+BeemuTraceWriter *beemu_trace_writer_new(FILE *file)
+{
+	BeemuTraceWriter *writer = calloc(1, sizeof(BeemuTraceWriter));
+	if (writer == NULL)
+	{
+		return NULL;
+	}
+	writer->file = file;
+	writer->format_capacity = 64;
+	writer->formats = calloc(writer->format_capacity, sizeof(const char *));
+	writer->format_ids = calloc(writer->format_capacity, sizeof(uint32_t));
+	if (writer->formats == NULL || writer->format_ids == NULL
+		|| fwrite(trace_magic, sizeof(trace_magic), 1, file) != 1
+		|| fwrite(&trace_version, sizeof(trace_version), 1, file) != 1)
+	{
+		beemu_trace_writer_free(writer);
+		return NULL;
+	}
+	return writer;
+}
+
+size_t beemu_trace_writer_flush(BeemuTraceWriter *writer)
+{
+	writer->dropped = 0;
+	const size_t drained = beemu_trace_drain(write_event, writer);
+	fflush(writer->file);
+	return drained - writer->dropped;
+}
+
+bool beemu_trace_writer_free(BeemuTraceWriter *writer)
+{
+	const bool succeeded = !writer->failed;
+	free(writer->formats);
+	free(writer->format_ids);
+	free(writer);
+	return succeeded;
+}
+
+bool beemu_trace_decode(FILE *input, FILE *output)
+{
+	char magic[sizeof(trace_magic)];
+	uint32_t version;
+	if (fread(magic, sizeof(magic), 1, input) != 1 || memcmp(magic, trace_magic, sizeof(magic)) != 0
+		|| fread(&version, sizeof(version), 1, input) != 1 || version != trace_version)
+	{
+		return false;
+	}
+	char **formats = NULL;
+	uint32_t format_count = 0;
+	bool valid = true;
+	int tag;
+	while (valid && (tag = fgetc(input)) != EOF)
+	{
+		uint32_t format_id;
+		valid = fread(&format_id, sizeof(format_id), 1, input) == 1;
+		if (valid && tag == BEEMU_TRACE_RECORD_FORMAT)
+		{
+			uint32_t length;
+			char **grown = NULL;
+			char *format = NULL;
+			valid = format_id == format_count
+					&& fread(&length, sizeof(length), 1, input) == 1
+					&& (grown = realloc(formats, (format_count + 1) * sizeof(char *))) != NULL
+					&& (format = malloc(length + 1)) != NULL
+					&& fread(format, 1, length, input) == length;
+			formats = grown != NULL ? grown : formats;
+			if (!valid)
+			{
+				free(format);
+				break;
+			}
+			format[length] = '\0';
+			formats[format_count++] = format;
+		}
+		else if (valid && tag == BEEMU_TRACE_RECORD_EVENT)
+		{
+			BeemuTraceEvent event;
+			uint8_t level;
+			valid = format_id < format_count
+					&& fread(&level, sizeof(level), 1, input) == 1
+					&& fread(&event.arg_count, sizeof(event.arg_count), 1, input) == 1
+					&& fread(&event.thread_id, sizeof(event.thread_id), 1, input) == 1
+					&& fread(&event.timestamp, sizeof(event.timestamp), 1, input) == 1
+					&& level <= BEEMU_LOG_INFO
+					&& event.arg_count <= BEEMU_TRACE_MAX_ARGS
+					&& fread(event.args, sizeof(uint64_t), event.arg_count, input) == event.arg_count;
+			if (valid)
+			{
+				char message[512];
+				event.level = level;
+				event.format = formats[format_id];
+				beemu_trace_format_event(&event, message, sizeof(message));
+				fprintf(output, "[%llu] [thread %u] %s\n", (unsigned long long)event.timestamp, event.thread_id, message);
+			}
+		}
+		else
+		{
+			valid = false;
+		}
+	}
+	for (uint32_t i = 0; i < format_count; i++)
+	{
+		free(formats[i]);
+	}
+	free(formats);
+	return valid;
+}
@@ -22,7 +22,8 @@ target_map = {
     "BEEMU_WRITE_TARGET_REGISTER_8": "register_8" ,
     "BEEMU_WRITE_TARGET_MEMORY_ADDRESS": "mem_addr",
     "BEEMU_WRITE_TARGET_FLAG": "flag",
-    "BEEMU_WRITE_TARGET_INTERNAL": "internal_target"
+    "BEEMU_WRITE_TARGET_INTERNAL": "internal_target",
+    "BEEMU_WRITE_TARGET_LAZY_FLAGS": "lazy_flags"
 }
 
 value_map = {
@@ -0,0 +1,33 @@
+#include <beemu/device/clock.h>
+#include <gtest/gtest.h>
+
+namespace BeemuTests {
+
+TEST(BeemuClockTest, ComponentsCatchUpWhenSynced)
+{
+	BeemuClock clock;
+	beemu_clock_init(&clock);
+	beemu_clock_advance(&clock, 12);
+	EXPECT_EQ(clock.now, 12);
+	EXPECT_EQ(beemu_clock_pending(&clock, BEEMU_CLOCK_COMPONENT_PPU), 12);
+	EXPECT_EQ(beemu_clock_sync(&clock, BEEMU_CLOCK_COMPONENT_PPU), 12);
+	EXPECT_EQ(beemu_clock_pending(&clock, BEEMU_CLOCK_COMPONENT_PPU), 0);
+	beemu_clock_advance(&clock, 8);
+	// Every component keeps its own timestamp.
+	EXPECT_EQ(beemu_clock_sync(&clock, BEEMU_CLOCK_COMPONENT_PPU), 8);
+	EXPECT_EQ(beemu_clock_sync(&clock, BEEMU_CLOCK_COMPONENT_TIMER), 20);
+	EXPECT_EQ(beemu_clock_pending(&clock, BEEMU_CLOCK_COMPONENT_DMA), 20);
+}
+
+TEST(BeemuClockTest, CountsPastThirtyTwoBits)
+{
+	BeemuClock clock;
+	beemu_clock_init(&clock);
+	clock.now = UINT32_MAX;
+	clock.synced_at[BEEMU_CLOCK_COMPONENT_TIMER] = UINT32_MAX - 4;
+	beemu_clock_advance(&clock, 16);
+	EXPECT_EQ(clock.now, (uint64_t)UINT32_MAX + 16);
+	EXPECT_EQ(beemu_clock_sync(&clock, BEEMU_CLOCK_COMPONENT_TIMER), 20);
+}
+
+}
@@ -0,0 +1,188 @@
+#include <BeemuDeviceTest.hpp>
+#include <beemu/device/device.h>
+#include <gtest/gtest.h>
+
+namespace BeemuTests {
+
+class BeemuDeviceTestFixture : public ::testing::Test {
+protected:
+	BeemuDevice *device;
+
+	void SetUp() override
+	{
+		device = beemu_device_new();
+	}
+
+	void TearDown() override
+	{
+		beemu_device_free(device);
+	}
+};
+
+TEST_F(BeemuDeviceTestFixture, RunReturnsTCycles)
+{
+	// NOP; JP 0x0101
+	load_program(device, {0x00, 0xC3, 0x01, 0x01});
+	EXPECT_EQ(beemu_device_run(device), 4);
+	EXPECT_EQ(beemu_device_run(device), 16);
+	EXPECT_EQ(beemu_device_frame_cycle(device), 20);
+}
+
+TEST_F(BeemuDeviceTestFixture, ExecutionModesTakeTheSameTCycles)
+{
+	// LD B, 3; DEC B; JR NZ, -3; NOP
+	const std::vector<uint8_t> program = {0x06, 0x03, 0x05, 0x20, 0xFD, 0x00};
+	BeemuDevice *fast = beemu_device_new();
+	beemu_processor_set_execution_mode(fast->processor, BEEMU_EXECUTION_MODE_INSTRUCTION);
+	load_program(device, program);
+	load_program(fast, program);
+	// 8 for the load, 4 for each decrement, 12 for each jump taken and 8
+	// for the one that is not.
+	EXPECT_EQ(beemu_device_run_cycles(device, 52), 52);
+	EXPECT_EQ(beemu_device_run_cycles(fast, 52), 52);
+	for (BeemuDevice *each : {device, fast}) {
+		EXPECT_EQ(each->processor->registers->program_counter, 0x105);
+		EXPECT_EQ(*beemu_registers_ptr_8(each->processor->registers, BEEMU_REGISTER_B), 0);
+		EXPECT_EQ(beemu_device_run(each), 4);
+	}
+	beemu_device_free(fast);
+}
+
+TEST_F(BeemuDeviceTestFixture, RunCyclesIncludesTheOvershoot)
+{
+	// NOP; JP 0x0101
+	load_program(device, {0x00, 0xC3, 0x01, 0x01});
+	// The jump straddles the requested cycles.
+	EXPECT_EQ(beemu_device_run_cycles(device, 10), 20);
+	EXPECT_EQ(beemu_device_run_cycles(device, 16), 16);
+	EXPECT_EQ(beemu_device_run_cycles(device, 0), 0);
+	EXPECT_EQ(beemu_device_frame_cycle(device), 36);
+}
+
+TEST_F(BeemuDeviceTestFixture, RunUntilFrameCarriesTheSpillOver)
+{
+	// NOP; JP 0x0101
+	load_program(device, {0x00, 0xC3, 0x01, 0x01});
+	beemu_device_run(device);
+	// 4 + 16 * 4389 is 4 past the end of the frame.
+	EXPECT_EQ(beemu_device_run_until_frame(device), BEEMU_DEVICE_CYCLES_PER_FRAME);
+	EXPECT_EQ(beemu_device_frame_cycle(device), 4);
+	// The frame after starts 4 cycles in, so it spills over by the same 4.
+	EXPECT_EQ(beemu_device_run_until_frame(device), BEEMU_DEVICE_CYCLES_PER_FRAME);
+	EXPECT_EQ(beemu_device_frame_cycle(device), 4);
+}
+
+TEST_F(BeemuDeviceTestFixture, ClockCountsEveryCycle)
+{
+	// NOP; JP 0x0101
+	load_program(device, {0x00, 0xC3, 0x01, 0x01});
+	uint64_t cycles = beemu_device_run(device);
+	cycles += beemu_device_run_cycles(device, 1000);
+	cycles += beemu_device_run_until_frame(device);
+	EXPECT_EQ(device->clock.now, cycles);
+	EXPECT_EQ(beemu_clock_pending(&device->clock, BEEMU_CLOCK_COMPONENT_TIMER), cycles);
+}
+
+namespace {
+	std::vector<uint64_t> serial_events;
+
+	/**
+	 * Record the event and repeat it every 100 cycles.
+	 */
+	void handle_serial_transfer(BeemuDevice *device, const uint64_t deadline)
+	{
+		serial_events.push_back(deadline);
+		EXPECT_GE(device->clock.now, deadline);
+		EXPECT_LT(device->clock.now, deadline + 16);
+		beemu_scheduler_schedule(&device->scheduler, BEEMU_EVENT_SERIAL_TRANSFER, deadline + 100);
+	}
+}
+
+TEST_F(BeemuDeviceTestFixture, EventsFireAfterTheirDeadline)
+{
+	// NOP; JP 0x0101
+	load_program(device, {0x00, 0xC3, 0x01, 0x01});
+	serial_events.clear();
+	beemu_device_set_event_handler(device, BEEMU_EVENT_SERIAL_TRANSFER, handle_serial_transfer);
+	beemu_scheduler_schedule(&device->scheduler, BEEMU_EVENT_SERIAL_TRANSFER, 50);
+	beemu_device_run_cycles(device, 400);
+	EXPECT_EQ(serial_events, (std::vector<uint64_t>{50, 150, 250, 350}));
+	// Dropped without a handler.
+	beemu_device_set_event_handler(device, BEEMU_EVENT_SERIAL_TRANSFER, nullptr);
+	beemu_device_run_until_frame(device);
+	EXPECT_EQ(serial_events.size(), 4);
+	EXPECT_EQ(device->frame_count, 1);
+	EXPECT_EQ(beemu_scheduler_deadline(&device->scheduler, BEEMU_EVENT_SERIAL_TRANSFER), BEEMU_SCHEDULER_NEVER);
+}
+
+namespace {
+	void request_vblank(BeemuDevice *device, uint64_t)
+	{
+		beemu_processor_request_interrupt(device->processor, BEEMU_INTERRUPT_VBLANK);
+	}
+}
+
+TEST_F(BeemuDeviceTestFixture, HaltedProcessorSkipsToTheNextEvent)
+{
+	// HALT; INC A; JP 0x0100
+	load_program(device, {0x76, 0x3C, 0xC3, 0x00, 0x01});
+	*beemu_registers_ptr_8(device->processor->registers, BEEMU_REGISTER_A) = 0;
+	beemu_memory_write(device->processor->memory, BEEMU_PROCESSOR_INTERRUPT_FLAG_ADDRESS, 0x00);
+	beemu_memory_write(device->processor->memory, BEEMU_PROCESSOR_INTERRUPT_ENABLE_ADDRESS, 0x01);
+	beemu_device_set_event_handler(device, BEEMU_EVENT_SERIAL_TRANSFER, request_vblank);
+	beemu_scheduler_schedule(&device->scheduler, BEEMU_EVENT_SERIAL_TRANSFER, 1001);
+	EXPECT_EQ(beemu_device_run_cycles(device, 1000), 1000);
+	EXPECT_TRUE(beemu_processor_is_halted(device->processor));
+	EXPECT_EQ(*beemu_registers_ptr_8(device->processor->registers, BEEMU_REGISTER_A), 0);
+	// The clock lands on the first machine cycle past the deadline, and the
+	// interrupt wakes the processor up for the instruction after HALT.
+	EXPECT_EQ(beemu_device_run_cycles(device, 1), 4);
+	EXPECT_EQ(device->clock.now, 1004);
+	beemu_device_run(device);
+	EXPECT_FALSE(beemu_processor_is_halted(device->processor));
+	EXPECT_EQ(*beemu_registers_ptr_8(device->processor->registers, BEEMU_REGISTER_A), 1);
+}
+
+TEST_F(BeemuDeviceTestFixture, HaltedProcessorIdlesOneCycleAtATime)
+{
+	// HALT
+	load_program(device, {0x76});
+	beemu_memory_write(device->processor->memory, BEEMU_PROCESSOR_INTERRUPT_ENABLE_ADDRESS, 0x00);
+	beemu_device_run(device);
+	const uint16_t pc = device->processor->registers->program_counter;
+	EXPECT_EQ(beemu_device_run(device), 4);
+	EXPECT_EQ(device->processor->registers->program_counter, pc);
+	// The rest of the frame passes in a single skip.
+	const uint32_t frame_cycle = beemu_device_frame_cycle(device);
+	EXPECT_EQ(beemu_device_run_until_frame(device), BEEMU_DEVICE_CYCLES_PER_FRAME - frame_cycle);
+	EXPECT_EQ(beemu_device_frame_cycle(device), 0);
+}
+
+namespace {
+	struct StopAtAccumulator {
+		uint8_t value;
+		int calls;
+	};
+
+	bool stop_at_accumulator(const BeemuDevice *device, void *context)
+	{
+		StopAtAccumulator *stop = static_cast<StopAtAccumulator *>(context);
+		stop->calls++;
+		return *beemu_registers_ptr_8(device->processor->registers, BEEMU_REGISTER_A) == stop->value;
+	}
+}
+
+TEST_F(BeemuDeviceTestFixture, RunUntilStopsOnThePredicate)
+{
+	// INC A; JP 0x0100
+	load_program(device, {0x3C, 0xC3, 0x00, 0x01});
+	*beemu_registers_ptr_8(device->processor->registers, BEEMU_REGISTER_A) = 0;
+	StopAtAccumulator stop = {3, 0};
+	EXPECT_EQ(beemu_device_run_until(device, stop_at_accumulator, &stop), 3 * 4 + 2 * 16);
+	EXPECT_EQ(stop.calls, 6);
+	// Already holds, so nothing runs.
+	EXPECT_EQ(beemu_device_run_until(device, stop_at_accumulator, &stop), 0);
+	EXPECT_EQ(stop.calls, 7);
+}
+
+}
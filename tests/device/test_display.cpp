@@ -0,0 +1,317 @@
+#include <beemu/device/device.h>
+#include <beemu/device/display.h>
+#include <gtest/gtest.h>
+
+namespace BeemuTests {
+
+class BeemuDisplayTestFixture : public ::testing::Test {
+protected:
+	BeemuMemory *memory;
+	BeemuDisplay *display;
+
+	void SetUp() override
+	{
+		memory = beemu_memory_new(BEEMU_DEVICE_MEMORY_SIZE);
+		display = beemu_display_new(memory);
+		// LCD, background and sprites on, tiles from 0x8000, identity palettes.
+		beemu_memory_write(memory, BEEMU_DISPLAY_LCDC_ADDRESS, 0x93);
+		beemu_memory_write(memory, BEEMU_DISPLAY_BGP_ADDRESS, 0xE4);
+		beemu_memory_write(memory, BEEMU_DISPLAY_OBP0_ADDRESS, 0xE4);
+		beemu_memory_write(memory, BEEMU_DISPLAY_OBP1_ADDRESS, 0x1B);
+		// Tile 1 is all colour 1, tile 2 all colour 2, tile 3 all colour 3.
+		for (int tile = 1; tile <= 3; tile++) {
+			for (int row = 0; row < 8; row++) {
+				write_tile_row(0x8000 + tile * 16, row, (tile & 1) ? 0xFF : 0x00, (tile & 2) ? 0xFF : 0x00);
+			}
+		}
+	}
+
+	void TearDown() override
+	{
+		beemu_display_free(display);
+		beemu_memory_free(memory);
+	}
+
+	void write_tile_row(const uint16_t tile_address, const int row, const uint8_t low, const uint8_t high)
+	{
+		beemu_memory_write(memory, tile_address + row * 2, low);
+		beemu_memory_write(memory, tile_address + row * 2 + 1, high);
+	}
+
+	void write_sprite(const int index, const uint8_t y, const uint8_t x, const uint8_t tile, const uint8_t flags)
+	{
+		const uint16_t address = BEEMU_DISPLAY_OAM_ADDRESS + index * 4;
+		beemu_memory_write(memory, address, y);
+		beemu_memory_write(memory, address + 1, x);
+		beemu_memory_write(memory, address + 2, tile);
+		beemu_memory_write(memory, address + 3, flags);
+	}
+
+	std::vector<uint8_t> line(const uint8_t y, const int from, const int to)
+	{
+		return std::vector<uint8_t>(display->framebuffer[y] + from, display->framebuffer[y] + to);
+	}
+};
+
+TEST_F(BeemuDisplayTestFixture, DecodesTileRowsLeftmostBitFirst)
+{
+	write_tile_row(0x8040, 0, 0x81, 0x03);
+	beemu_memory_write(memory, 0x9800, 4);
+	beemu_display_render_line(display, 0);
+	EXPECT_EQ(line(0, 0, 8), (std::vector<uint8_t>{1, 0, 0, 0, 0, 0, 2, 3}));
+	// Palettes map colours to shades.
+	beemu_memory_write(memory, BEEMU_DISPLAY_BGP_ADDRESS, 0x1B);
+	beemu_display_render_line(display, 0);
+	EXPECT_EQ(line(0, 0, 8), (std::vector<uint8_t>{2, 3, 3, 3, 3, 3, 1, 0}));
+}
+
+TEST_F(BeemuDisplayTestFixture, BackgroundScrollsAndWraps)
+{
+	beemu_memory_write(memory, 0x9800, 1);
+	beemu_memory_write(memory, 0x9801, 2);
+	beemu_memory_write(memory, 0x981F, 3);
+	beemu_memory_write(memory, 0x9820, 2);
+	beemu_memory_write(memory, BEEMU_DISPLAY_SCX_ADDRESS, 4);
+	beemu_display_render_line(display, 0);
+	EXPECT_EQ(line(0, 0, 14), (std::vector<uint8_t>{1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0}));
+	// Scrolling left of the map wraps to its right edge.
+	beemu_memory_write(memory, BEEMU_DISPLAY_SCX_ADDRESS, 0xFE);
+	beemu_display_render_line(display, 0);
+	EXPECT_EQ(line(0, 0, 4), (std::vector<uint8_t>{3, 3, 1, 1}));
+	// The second row of tiles starts 8 lines down.
+	beemu_memory_write(memory, BEEMU_DISPLAY_SCX_ADDRESS, 0);
+	beemu_memory_write(memory, BEEMU_DISPLAY_SCY_ADDRESS, 5);
+	beemu_display_render_line(display, 3);
+	EXPECT_EQ(line(3, 0, 2), (std::vector<uint8_t>{2, 2}));
+}
+
+TEST_F(BeemuDisplayTestFixture, SignedTileDataIsIndexedFrom0x9000)
+{
+	// Tiles from 0x8800, 0xFF is the tile at 0x8FF0 and 0x01 the one at 0x9010.
+	beemu_memory_write(memory, BEEMU_DISPLAY_LCDC_ADDRESS, 0x81);
+	for (int row = 0; row < 8; row++) {
+		write_tile_row(0x8FF0, row, 0xFF, 0xFF);
+		write_tile_row(0x9010, row, 0x00, 0xFF);
+	}
+	beemu_memory_write(memory, 0x9800, 0xFF);
+	beemu_memory_write(memory, 0x9801, 0x01);
+	beemu_display_render_line(display, 0);
+	EXPECT_EQ(display->framebuffer[0][0], 3);
+	EXPECT_EQ(display->framebuffer[0][8], 2);
+}
+
+TEST_F(BeemuDisplayTestFixture, WindowCoversTheBackgroundFromItsPosition)
+{
+	// Window on, its map at 0x9C00.
+	beemu_memory_write(memory, BEEMU_DISPLAY_LCDC_ADDRESS, 0xF1);
+	beemu_memory_write(memory, 0x9800, 1);
+	beemu_memory_write(memory, 0x9C00, 2);
+	beemu_memory_write(memory, 0x9C20, 3);
+	beemu_memory_write(memory, BEEMU_DISPLAY_WY_ADDRESS, 10);
+	beemu_memory_write(memory, BEEMU_DISPLAY_WX_ADDRESS, 7 + 4);
+	beemu_display_render_line(display, 9);
+	EXPECT_EQ(display->framebuffer[9][4], 0);
+	for (int y = 10; y < 20; y++) {
+		beemu_display_render_line(display, y);
+	}
+	EXPECT_EQ(line(10, 0, 13), (std::vector<uint8_t>{0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2, 0}));
+	// The window counts its own lines, starting from where it appeared.
+	EXPECT_EQ(display->framebuffer[17][4], 2);
+	EXPECT_EQ(display->framebuffer[18][4], 3);
+	// Turning off the background hides the window as well.
+	beemu_memory_write(memory, BEEMU_DISPLAY_LCDC_ADDRESS, 0xF0);
+	beemu_display_render_line(display, 10);
+	EXPECT_EQ(display->framebuffer[10][4], 0);
+}
+
+TEST_F(BeemuDisplayTestFixture, SpritesFollowTheHardwarePriority)
+{
+	beemu_memory_write(memory, 0x9800, 1);
+	// Sprite 1 is left of sprite 0, so it wins the pixels they share even
+	// though it comes later in OAM.
+	write_sprite(0, 16, 8 + 4, 3, 0);
+	write_sprite(1, 16, 8 + 2, 2, 0);
+	beemu_display_render_line(display, 0);
+	EXPECT_EQ(line(0, 0, 14), (std::vector<uint8_t>{1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 0, 0}));
+	// Sharing X, the earlier one wins, and OBP1 inverts the shades.
+	write_sprite(1, 16, 8 + 4, 2, 0x10);
+	beemu_display_render_line(display, 0);
+	EXPECT_EQ(line(0, 4, 12), (std::vector<uint8_t>(8, 3)));
+	write_sprite(0, 0, 0, 0, 0);
+	beemu_display_render_line(display, 0);
+	EXPECT_EQ(line(0, 4, 12), (std::vector<uint8_t>(8, 1)));
+	// Behind the background, it only shows over colour 0.
+	write_sprite(1, 16, 8 + 4, 2, 0x80);
+	beemu_display_render_line(display, 0);
+	EXPECT_EQ(line(0, 4, 12), (std::vector<uint8_t>{1, 1, 1, 1, 2, 2, 2, 2}));
+}
+
+TEST_F(BeemuDisplayTestFixture, OnlyTenSpritesAreDrawnPerLine)
+{
+	for (int i = 0; i < 12; i++) {
+		write_sprite(i, 16, 8 + i * 8, 3, 0);
+	}
+	// Sprites off the line do not count towards the limit.
+	write_sprite(0, 40, 8, 3, 0);
+	beemu_display_render_line(display, 0);
+	EXPECT_EQ(display->framebuffer[0][0], 0);
+	for (int i = 1; i <= 10; i++) {
+		EXPECT_EQ(display->framebuffer[0][i * 8], 3) << "sprite " << i;
+	}
+	EXPECT_EQ(display->framebuffer[0][11 * 8], 0);
+}
+
+TEST_F(BeemuDisplayTestFixture, TallSpritesFlipAcrossBothTiles)
+{
+	// 8x16 sprites, the tile number ignores its lowest bit.
+	beemu_memory_write(memory, BEEMU_DISPLAY_LCDC_ADDRESS, 0x87);
+	write_sprite(0, 16, 8, 3, 0);
+	beemu_display_render_line(display, 0);
+	beemu_display_render_line(display, 8);
+	EXPECT_EQ(display->framebuffer[0][0], 2);
+	EXPECT_EQ(display->framebuffer[8][0], 3);
+	write_sprite(0, 16, 8, 3, 0x40);
+	beemu_display_render_line(display, 0);
+	EXPECT_EQ(display->framebuffer[0][0], 3);
+}
+
+TEST_F(BeemuDisplayTestFixture, TileCacheDecodesEachTileOnce)
+{
+	beemu_memory_write(memory, 0x9800, 1);
+	beemu_memory_write(memory, 0x9801, 2);
+	beemu_display_render_line(display, 0);
+	// The background fetches 21 tiles, only tiles 0, 1 and 2 are decoded.
+	EXPECT_EQ(display->tile_cache.misses, 3);
+	EXPECT_EQ(display->tile_cache.hits, 18);
+	beemu_display_render_line(display, 1);
+	EXPECT_EQ(display->tile_cache.misses, 3);
+	EXPECT_EQ(display->tile_cache.hits, 39);
+	// Writing any row of a tile decodes it again.
+	write_tile_row(0x8010, 7, 0x00, 0xFF);
+	beemu_display_render_line(display, 7);
+	EXPECT_EQ(display->tile_cache.misses, 4);
+	EXPECT_EQ(display->framebuffer[7][0], 2);
+	EXPECT_EQ(display->framebuffer[6][0], 0);
+	beemu_display_render_line(display, 6);
+	EXPECT_EQ(display->framebuffer[6][0], 1);
+	// Tile maps are not cached, writing them does not invalidate anything.
+	beemu_memory_write(memory, 0x9800, 2);
+	beemu_display_render_line(display, 0);
+	EXPECT_EQ(display->tile_cache.misses, 4);
+	EXPECT_EQ(display->framebuffer[0][0], 2);
+}
+
+TEST_F(BeemuDisplayTestFixture, TileDataStaysWritableAfterTheDisplay)
+{
+	beemu_memory_write(memory, 0x8123, 0x45);
+	EXPECT_EQ(beemu_memory_read(memory, 0x8123), 0x45);
+	EXPECT_EQ(memory->memory[0x8123], 0x45);
+	beemu_display_free(display);
+	EXPECT_EQ(memory->write_pages[0x81], memory->memory + 0x8100);
+	EXPECT_EQ(memory->write_pages[0xFE], memory->memory + 0xFE00);
+	beemu_memory_write(memory, 0x8123, 0x67);
+	EXPECT_EQ(beemu_memory_read(memory, 0x8123), 0x67);
+	display = beemu_display_new(memory);
+}
+
+TEST_F(BeemuDisplayTestFixture, SpriteBinsAreSortedOnlyWhenOAMChanges)
+{
+	// Starting 6 lines above the screen, the sprite covers lines 0 and 1.
+	write_sprite(0, 10, 8, 3, 0);
+	for (int y = 0; y < 3; y++) {
+		beemu_display_render_line(display, y);
+	}
+	EXPECT_EQ(display->framebuffer[0][0], 3);
+	EXPECT_EQ(display->framebuffer[1][0], 3);
+	EXPECT_EQ(display->framebuffer[2][0], 0);
+	EXPECT_EQ(display->sprite_bins.builds, 1);
+	// Tall sprites cover more lines, changing the size sorts them again.
+	beemu_memory_write(memory, BEEMU_DISPLAY_LCDC_ADDRESS, 0x97);
+	beemu_display_render_line(display, 2);
+	EXPECT_EQ(display->framebuffer[2][0], 3);
+	EXPECT_EQ(display->sprite_bins.builds, 2);
+	// Past the sprites, the rest of the page does not invalidate them.
+	beemu_memory_write(memory, 0xFEA0, 1);
+	EXPECT_EQ(beemu_memory_read(memory, 0xFEA0), 1);
+	beemu_display_render_line(display, 2);
+	EXPECT_EQ(display->sprite_bins.builds, 2);
+	write_sprite(0, 0, 0, 0, 0);
+	beemu_display_render_line(display, 2);
+	EXPECT_EQ(display->framebuffer[2][0], 0);
+	EXPECT_EQ(display->sprite_bins.builds, 3);
+}
+
+TEST_F(BeemuDisplayTestFixture, DmaCopiesSpritesToTheSpriteBins)
+{
+	BeemuDevice *device = beemu_device_new();
+	BeemuMemory *bus = device->processor->memory;
+	beemu_memory_write(bus, BEEMU_DISPLAY_LCDC_ADDRESS, 0x93);
+	beemu_memory_write(bus, BEEMU_DISPLAY_OBP0_ADDRESS, 0xE4);
+	for (int row = 0; row < 8; row++) {
+		beemu_memory_write(bus, 0x8030 + row * 2, 0xFF);
+		beemu_memory_write(bus, 0x8031 + row * 2, 0xFF);
+	}
+	beemu_display_render_line(device->display, 0);
+	const uint8_t sprite[] = {16, 8, 3, 0};
+	for (int i = 0; i < 4; i++) {
+		beemu_memory_write(bus, 0xC000 + i, sprite[i]);
+	}
+	beemu_memory_write(bus, BEEMU_DISPLAY_DMA_ADDRESS, 0xC0);
+	EXPECT_EQ(beemu_memory_read(bus, BEEMU_DISPLAY_DMA_ADDRESS), 0xC0);
+	// Nothing is copied until the transfer completes.
+	beemu_display_render_line(device->display, 0);
+	EXPECT_EQ(device->display->framebuffer[0][0], 0);
+	beemu_device_run_cycles(device, BEEMU_DEVICE_DMA_CYCLES);
+	for (int i = 0; i < 4; i++) {
+		EXPECT_EQ(beemu_memory_read(bus, BEEMU_DISPLAY_OAM_ADDRESS + i), sprite[i]);
+	}
+	beemu_display_render_line(device->display, 0);
+	EXPECT_EQ(device->display->framebuffer[0][0], 3);
+	beemu_device_free(device);
+}
+
+TEST_F(BeemuDisplayTestFixture, DeviceStepsThroughTheModes)
+{
+	BeemuDevice *device = beemu_device_new();
+	BeemuMemory *bus = device->processor->memory;
+	// HALT, with every interrupt disabled.
+	beemu_memory_write(bus, 0x100, 0x76);
+	device->processor->registers->program_counter = 0x100;
+	beemu_memory_write(bus, BEEMU_PROCESSOR_INTERRUPT_ENABLE_ADDRESS, 0);
+	beemu_memory_write(bus, BEEMU_DISPLAY_LCDC_ADDRESS, 0x91);
+	beemu_memory_write(bus, BEEMU_DISPLAY_LYC_ADDRESS, 2);
+	const auto run_to = [&](const uint64_t cycle) {
+		beemu_device_run_cycles(device, cycle - device->clock.now);
+	};
+	const auto stat_mode = [&]() {
+		return beemu_memory_read(bus, BEEMU_DISPLAY_STAT_ADDRESS) & 0x03;
+	};
+	run_to(40);
+	EXPECT_EQ(stat_mode(), BEEMU_DISPLAY_MODE_OAM_SCAN);
+	run_to(100);
+	EXPECT_EQ(stat_mode(), BEEMU_DISPLAY_MODE_DRAWING);
+	run_to(300);
+	EXPECT_EQ(stat_mode(), BEEMU_DISPLAY_MODE_HBLANK);
+	EXPECT_EQ(beemu_memory_read(bus, BEEMU_DISPLAY_LY_ADDRESS), 0);
+	run_to(2 * 456 + 40);
+	EXPECT_EQ(stat_mode(), BEEMU_DISPLAY_MODE_OAM_SCAN);
+	EXPECT_EQ(beemu_memory_read(bus, BEEMU_DISPLAY_LY_ADDRESS), 2);
+	EXPECT_TRUE(beemu_memory_read(bus, BEEMU_DISPLAY_STAT_ADDRESS) & 0x04);
+	EXPECT_EQ(beemu_memory_read(bus, BEEMU_PROCESSOR_INTERRUPT_FLAG_ADDRESS) & 0x01, 0);
+	run_to(144 * 456 + 40);
+	EXPECT_EQ(stat_mode(), BEEMU_DISPLAY_MODE_VBLANK);
+	EXPECT_EQ(beemu_memory_read(bus, BEEMU_DISPLAY_LY_ADDRESS), 144);
+	EXPECT_EQ(beemu_memory_read(bus, BEEMU_PROCESSOR_INTERRUPT_FLAG_ADDRESS) & 0x01, 1);
+	// The next frame starts over from line 0.
+	run_to(BEEMU_DEVICE_CYCLES_PER_FRAME + 40);
+	EXPECT_EQ(stat_mode(), BEEMU_DISPLAY_MODE_OAM_SCAN);
+	EXPECT_EQ(beemu_memory_read(bus, BEEMU_DISPLAY_LY_ADDRESS), 0);
+	// Turning the LCD off resets LY, and it stays there.
+	beemu_memory_write(bus, BEEMU_DISPLAY_LCDC_ADDRESS, 0x00);
+	run_to(BEEMU_DEVICE_CYCLES_PER_FRAME + 10 * 456);
+	EXPECT_EQ(beemu_memory_read(bus, BEEMU_DISPLAY_LY_ADDRESS), 0);
+	EXPECT_EQ(stat_mode(), BEEMU_DISPLAY_MODE_HBLANK);
+	EXPECT_EQ(beemu_scheduler_deadline(&device->scheduler, BEEMU_EVENT_PPU_MODE), 2 * BEEMU_DEVICE_CYCLES_PER_FRAME);
+	beemu_device_free(device);
+}
+}
@@ -0,0 +1,153 @@
+#include <beemu/device/device.h>
+#include <beemu/device/display.h>
+#include <cstring>
+#include <functional>
+#include <gtest/gtest.h>
+#include <random>
+
+namespace BeemuTests {
+
+/**
+ * Runs a scanline and a pixel FIFO device side by side, on the same
+ * program and memory.
+ */
+class BeemuDisplayRenderersTestFixture : public ::testing::Test {
+protected:
+	BeemuDevice *scanline;
+	BeemuDevice *fifo;
+	std::mt19937 random_engine{0xF1F0};
+
+	void SetUp() override
+	{
+		scanline = beemu_device_new();
+		fifo = beemu_device_new_with_renderer(BEEMU_DISPLAY_RENDERER_PIXEL_FIFO);
+		// HALT with every interrupt disabled, so that only the display runs.
+		write(0x100, 0x76);
+		write(BEEMU_PROCESSOR_INTERRUPT_ENABLE_ADDRESS, 0);
+		for (BeemuDevice *device : {scanline, fifo}) {
+			device->processor->registers->program_counter = 0x100;
+		}
+	}
+
+	void TearDown() override
+	{
+		beemu_device_free(scanline);
+		beemu_device_free(fifo);
+	}
+
+	void write(const uint16_t address, const uint8_t value)
+	{
+		beemu_memory_write(scanline->processor->memory, address, value);
+		beemu_memory_write(fifo->processor->memory, address, value);
+	}
+
+	/**
+	 * Fill VRAM and OAM with random tiles and sprites, crowding the sprites
+	 * on the screen so that they overlap.
+	 */
+	void fill_random_scene(const uint8_t lcdc)
+	{
+		std::uniform_int_distribution<int> byte(0, 0xFF);
+		for (int address = 0x8000; address < 0xA000; address++) {
+			write(address, byte(random_engine));
+		}
+		for (int sprite = 0; sprite < BEEMU_DISPLAY_SPRITE_COUNT; sprite++) {
+			const uint16_t address = BEEMU_DISPLAY_OAM_ADDRESS + sprite * 4;
+			write(address, byte(random_engine) % (BEEMU_DISPLAY_HEIGHT + 32));
+			write(address + 1, byte(random_engine) % (BEEMU_DISPLAY_WIDTH + 16));
+			write(address + 2, byte(random_engine));
+			write(address + 3, byte(random_engine) & 0xF0);
+		}
+		write(BEEMU_DISPLAY_SCX_ADDRESS, byte(random_engine));
+		write(BEEMU_DISPLAY_SCY_ADDRESS, byte(random_engine));
+		write(BEEMU_DISPLAY_WX_ADDRESS, byte(random_engine) % (BEEMU_DISPLAY_WIDTH + 10));
+		write(BEEMU_DISPLAY_WY_ADDRESS, byte(random_engine) % BEEMU_DISPLAY_HEIGHT);
+		write(BEEMU_DISPLAY_BGP_ADDRESS, byte(random_engine));
+		write(BEEMU_DISPLAY_OBP0_ADDRESS, byte(random_engine));
+		write(BEEMU_DISPLAY_OBP1_ADDRESS, byte(random_engine));
+		write(BEEMU_DISPLAY_LCDC_ADDRESS, lcdc);
+	}
+
+	void run_frame()
+	{
+		beemu_device_run_until_frame(scanline);
+		beemu_device_run_until_frame(fifo);
+	}
+
+	/**
+	 * Get the first line the frames differ on, BEEMU_DISPLAY_HEIGHT if none.
+	 */
+	int first_different_line() const
+	{
+		for (int y = 0; y < BEEMU_DISPLAY_HEIGHT; y++) {
+			if (std::memcmp(scanline->display->framebuffer[y], fifo->display->framebuffer[y], BEEMU_DISPLAY_WIDTH) != 0) {
+				return y;
+			}
+		}
+		return BEEMU_DISPLAY_HEIGHT;
+	}
+};
+
+TEST_F(BeemuDisplayRenderersTestFixture, RenderersDrawTheSameFrames)
+{
+	// Window and its map, tile data, tall sprites and the background map
+	// in turn, with everything on.
+	for (const uint8_t lcdc : {0xE3, 0xF3, 0xA7, 0xEB, 0x83, 0xE2, 0xF1}) {
+		for (int scene = 0; scene < 4; scene++) {
+			fill_random_scene(lcdc);
+			run_frame();
+			ASSERT_EQ(first_different_line(), BEEMU_DISPLAY_HEIGHT) << std::hex << "LCDC 0x" << +lcdc << ", scene " << scene;
+		}
+	}
+}
+
+TEST_F(BeemuDisplayRenderersTestFixture, MidLineWritesOnlyShowWithThePixelFifo)
+{
+	fill_random_scene(0x81);
+	// Every tile all colour 1, then invert the palette 60 dots into mode 3
+	// of line 10.
+	for (int address = 0x8000; address < 0x9800; address++) {
+		write(address, (address & 1) ? 0x00 : 0xFF);
+	}
+	write(BEEMU_DISPLAY_BGP_ADDRESS, 0xE4);
+	const auto invert_palette = [](BeemuDevice *device, uint64_t) {
+		beemu_memory_write(device->processor->memory, BEEMU_DISPLAY_BGP_ADDRESS, 0x1B);
+	};
+	for (BeemuDevice *device : {scanline, fifo}) {
+		beemu_device_set_event_handler(device, BEEMU_EVENT_SERIAL_TRANSFER, invert_palette);
+		beemu_scheduler_schedule(&device->scheduler, BEEMU_EVENT_SERIAL_TRANSFER, 10 * BEEMU_DISPLAY_CYCLES_PER_LINE + BEEMU_DISPLAY_OAM_SCAN_CYCLES + 60);
+	}
+	run_frame();
+	EXPECT_EQ(first_different_line(), 10);
+	EXPECT_EQ(scanline->display->framebuffer[10][0], 2);
+	EXPECT_EQ(fifo->display->framebuffer[10][0], 1);
+	EXPECT_EQ(fifo->display->framebuffer[10][BEEMU_DISPLAY_WIDTH - 1], 2);
+	for (BeemuDevice *device : {scanline, fifo}) {
+		EXPECT_EQ(device->display->framebuffer[9][BEEMU_DISPLAY_WIDTH - 1], 1);
+		EXPECT_EQ(device->display->framebuffer[11][0], 2);
+	}
+}
+
+TEST_F(BeemuDisplayRenderersTestFixture, SpritesLengthenModeThreeOfThePixelFifo)
+{
+	fill_random_scene(0x83);
+	for (int sprite = 0; sprite < BEEMU_DISPLAY_SPRITE_COUNT; sprite++) {
+		write(BEEMU_DISPLAY_OAM_ADDRESS + sprite * 4, 16);
+	}
+	const auto stat_mode = [](BeemuDevice *device) {
+		return beemu_memory_read(device->processor->memory, BEEMU_DISPLAY_STAT_ADDRESS) & 0x03;
+	};
+	// Ten sprites cost the FIFO 60 dots more, past the 172 of the scanline renderer.
+	const uint64_t cycle = BEEMU_DISPLAY_OAM_SCAN_CYCLES + BEEMU_DISPLAY_DRAWING_CYCLES + 20;
+	beemu_device_run_cycles(scanline, cycle);
+	beemu_device_run_cycles(fifo, cycle);
+	EXPECT_EQ(stat_mode(scanline), BEEMU_DISPLAY_MODE_HBLANK);
+	EXPECT_EQ(stat_mode(fifo), BEEMU_DISPLAY_MODE_DRAWING);
+	// Both end the line at the same time.
+	beemu_device_run_cycles(scanline, BEEMU_DISPLAY_CYCLES_PER_LINE - cycle + 4);
+	beemu_device_run_cycles(fifo, BEEMU_DISPLAY_CYCLES_PER_LINE - cycle + 4);
+	EXPECT_EQ(stat_mode(scanline), BEEMU_DISPLAY_MODE_OAM_SCAN);
+	EXPECT_EQ(stat_mode(fifo), BEEMU_DISPLAY_MODE_OAM_SCAN);
+	EXPECT_EQ(beemu_memory_read(fifo->processor->memory, BEEMU_DISPLAY_LY_ADDRESS), 1);
+}
+}
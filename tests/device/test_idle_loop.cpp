@@ -0,0 +1,93 @@
+#include <BeemuDeviceTest.hpp>
+#include <beemu/device/device.h>
+#include <beemu/device/idle_loop.h>
+#include <gtest/gtest.h>
+
+namespace BeemuTests {
+
+namespace {
+	/**
+	 * Set LY to 0x90, as if the screen reached the vertical blank.
+	 */
+	void enter_vblank(BeemuDevice *device, uint64_t)
+	{
+		beemu_memory_write(device->processor->memory, 0xFF44, 0x90);
+	}
+}
+
+class BeemuIdleLoopTestFixture : public ::testing::Test {
+protected:
+	BeemuDevice *device;
+
+	void SetUp() override
+	{
+		device = beemu_device_new();
+	}
+
+	void TearDown() override
+	{
+		beemu_device_free(device);
+	}
+
+	/**
+	 * Poll LY until it reaches 0x90, then count in B forever.
+	 */
+	static void load_vblank_wait(BeemuDevice *device)
+	{
+		// LDH A, (0x44); CP 0x90; JR NZ, -6; INC B; JR -3
+		load_program(device, {0xF0, 0x44, 0xFE, 0x90, 0x20, 0xFA, 0x04, 0x18, 0xFD});
+		beemu_device_set_event_handler(device, BEEMU_EVENT_SERIAL_TRANSFER, enter_vblank);
+		beemu_scheduler_schedule(&device->scheduler, BEEMU_EVENT_SERIAL_TRANSFER, 10000);
+	}
+};
+
+TEST_F(BeemuIdleLoopTestFixture, PollingLoopIsSkippedUntilTheEvent)
+{
+	BeemuDevice *reference = beemu_device_new();
+	load_vblank_wait(reference);
+	load_vblank_wait(device);
+	beemu_device_set_idle_loop_skipping(device, true);
+	EXPECT_EQ(beemu_device_run_cycles(device, 20000), beemu_device_run_cycles(reference, 20000));
+	// The loop runs a few times to be recognised, then skips to the event.
+	EXPECT_GT(beemu_device_idle_loop_skipped_cycles(device), 9000);
+	EXPECT_EQ(beemu_device_idle_loop_skipped_cycles(reference), 0);
+	// The loop is left at the same cycle, so the counting is identical.
+	EXPECT_EQ(device->processor->registers->program_counter, reference->processor->registers->program_counter);
+	EXPECT_EQ(*beemu_registers_ptr_8(device->processor->registers, BEEMU_REGISTER_B),
+			  *beemu_registers_ptr_8(reference->processor->registers, BEEMU_REGISTER_B));
+	EXPECT_GT(*beemu_registers_ptr_8(device->processor->registers, BEEMU_REGISTER_B), 0);
+	beemu_device_free(reference);
+}
+
+TEST_F(BeemuIdleLoopTestFixture, LoopsThatWriteMemoryAreNotSkipped)
+{
+	// LD (HL), A; JR -3
+	load_program(device, {0x77, 0x18, 0xFD});
+	beemu_device_set_idle_loop_skipping(device, true);
+	beemu_device_run_cycles(device, 10000);
+	EXPECT_EQ(beemu_device_idle_loop_skipped_cycles(device), 0);
+	// INC A; JR -3 changes its registers every iteration.
+	load_program(device, {0x3C, 0x18, 0xFD});
+	beemu_device_run_cycles(device, 10000);
+	EXPECT_EQ(beemu_device_idle_loop_skipped_cycles(device), 0);
+}
+
+TEST_F(BeemuIdleLoopTestFixture, BodiesWithCallsOrStackWritesHaveSideEffects)
+{
+	BeemuMemory *memory = device->processor->memory;
+	// LDH A, (0x44); BIT 7, A; JR Z, -6
+	load_program(device, {0xF0, 0x44, 0xCB, 0x7F, 0x28, 0xFA});
+	EXPECT_TRUE(beemu_idle_loop_is_side_effect_free(memory, 0x100, 0x104));
+	// The branch has to be reachable from the head.
+	EXPECT_FALSE(beemu_idle_loop_is_side_effect_free(memory, 0x100, 0x103));
+	// PUSH BC; POP BC; JR -4
+	load_program(device, {0xC5, 0xC1, 0x18, 0xFC});
+	EXPECT_FALSE(beemu_idle_loop_is_side_effect_free(memory, 0x100, 0x102));
+	// CALL 0x0200; JR -5
+	load_program(device, {0xCD, 0x00, 0x02, 0x18, 0xFB});
+	EXPECT_FALSE(beemu_idle_loop_is_side_effect_free(memory, 0x100, 0x103));
+	// SET 0, (HL); JR -4
+	load_program(device, {0xCB, 0xC6, 0x18, 0xFC});
+	EXPECT_FALSE(beemu_idle_loop_is_side_effect_free(memory, 0x100, 0x102));
+}
+}
@@ -0,0 +1,109 @@
+#include <beemu/device/display.h>
+#include <beemu/device/pixel_kernels.h>
+#include <gtest/gtest.h>
+#include <random>
+
+namespace BeemuTests {
+
+class BeemuPixelKernelsTestFixture : public ::testing::Test {
+protected:
+	std::mt19937 random_engine{0x2B99};
+	const BeemuPixelKernels *scalar = beemu_pixel_kernels_for(BEEMU_PIXEL_KERNEL_SCALAR);
+
+	std::vector<uint8_t> random_bytes(const size_t count, const int mask = 0xFF)
+	{
+		std::uniform_int_distribution<int> byte(0, 0xFF);
+		std::vector<uint8_t> bytes(count);
+		for (uint8_t &value : bytes) {
+			value = byte(random_engine) & mask;
+		}
+		return bytes;
+	}
+
+	/**
+	 * Kernels of every instruction set this processor supports.
+	 */
+	static std::vector<const BeemuPixelKernels *> supported_kernels()
+	{
+		std::vector<const BeemuPixelKernels *> kernels;
+		for (int level = 0; level < BEEMU_PIXEL_KERNEL_LEVEL_COUNT; level++) {
+			if (const BeemuPixelKernels *found = beemu_pixel_kernels_for(static_cast<BeemuPixelKernelLevel>(level))) {
+				kernels.push_back(found);
+			}
+		}
+		return kernels;
+	}
+};
+
+TEST_F(BeemuPixelKernelsTestFixture, ScalarDecodesLeftmostBitFirst)
+{
+	const uint8_t rows[] = {0x81, 0x03, 0xFF, 0x00};
+	uint8_t indices[16];
+	scalar->decode_rows(rows, 2, indices);
+	EXPECT_EQ(std::vector<uint8_t>(indices, indices + 16),
+			  (std::vector<uint8_t>{1, 0, 0, 0, 0, 0, 2, 3, 1, 1, 1, 1, 1, 1, 1, 1}));
+}
+
+TEST_F(BeemuPixelKernelsTestFixture, ScalarExpandsThroughThePalette)
+{
+	const uint8_t indices[] = {0, 1, 2, 3};
+	const uint32_t colours_32[4] = {0xFFFFFFFF, 0xAAAAAAFF, 0x555555FF, 0x000000FF};
+	const uint16_t colours_16[4] = {0xFFFF, 0xAD55, 0x52AA, 0x0000};
+	uint32_t pixels_32[4];
+	uint16_t pixels_16[4];
+	// 0x1B inverts the shades.
+	scalar->expand_32(indices, 4, 0x1B, colours_32, pixels_32);
+	scalar->expand_16(indices, 4, 0x1B, colours_16, pixels_16);
+	EXPECT_EQ(std::vector<uint32_t>(pixels_32, pixels_32 + 4), (std::vector<uint32_t>{0x000000FF, 0x555555FF, 0xAAAAAAFF, 0xFFFFFFFF}));
+	EXPECT_EQ(std::vector<uint16_t>(pixels_16, pixels_16 + 4), (std::vector<uint16_t>{0x0000, 0x52AA, 0xAD55, 0xFFFF}));
+}
+
+TEST_F(BeemuPixelKernelsTestFixture, EveryInstructionSetMatchesScalar)
+{
+	const uint32_t colours_32[4] = {0x11223344, 0x55667788, 0x99AABBCC, 0xDDEEFF00};
+	const uint16_t colours_16[4] = {0x1234, 0x5678, 0x9ABC, 0xDEF0};
+	EXPECT_EQ(beemu_pixel_kernels_get(), supported_kernels().back());
+	for (const BeemuPixelKernels *kernels : supported_kernels()) {
+		// Odd lengths run through the tails of the vector loops.
+		for (size_t count = 0; count < 70; count++) {
+			const std::vector<uint8_t> rows = random_bytes(count * 2);
+			std::vector<uint8_t> expected_indices(count * 8), indices(count * 8);
+			scalar->decode_rows(rows.data(), count, expected_indices.data());
+			kernels->decode_rows(rows.data(), count, indices.data());
+			ASSERT_EQ(indices, expected_indices) << kernels->name << " decoding " << count << " rows";
+
+			const std::vector<uint8_t> colour_indices = random_bytes(count, 3);
+			const uint8_t palette = random_bytes(1)[0];
+			std::vector<uint32_t> expected_32(count), pixels_32(count);
+			scalar->expand_32(colour_indices.data(), count, palette, colours_32, expected_32.data());
+			kernels->expand_32(colour_indices.data(), count, palette, colours_32, pixels_32.data());
+			ASSERT_EQ(pixels_32, expected_32) << kernels->name << " expanding " << count << " pixels";
+			std::vector<uint16_t> expected_16(count), pixels_16(count);
+			scalar->expand_16(colour_indices.data(), count, palette, colours_16, expected_16.data());
+			kernels->expand_16(colour_indices.data(), count, palette, colours_16, pixels_16.data());
+			ASSERT_EQ(pixels_16, expected_16) << kernels->name << " expanding " << count << " pixels";
+		}
+	}
+}
+
+TEST_F(BeemuPixelKernelsTestFixture, DisplayExportsItsShades)
+{
+	BeemuMemory *memory = beemu_memory_new(65536);
+	BeemuDisplay *display = beemu_display_new(memory);
+	display->framebuffer[0][0] = 3;
+	display->framebuffer[BEEMU_DISPLAY_HEIGHT - 1][BEEMU_DISPLAY_WIDTH - 1] = 2;
+	const uint32_t colours_32[4] = {0xFFFFFFFF, 0xAAAAAAFF, 0x555555FF, 0x000000FF};
+	std::vector<uint32_t> pixels_32(BEEMU_DISPLAY_WIDTH * BEEMU_DISPLAY_HEIGHT);
+	beemu_display_export_32(display, colours_32, pixels_32.data());
+	EXPECT_EQ(pixels_32.front(), 0x000000FF);
+	EXPECT_EQ(pixels_32[1], 0xFFFFFFFF);
+	EXPECT_EQ(pixels_32.back(), 0x555555FF);
+	const uint16_t colours_16[4] = {0xFFFF, 0xAD55, 0x52AA, 0x0000};
+	std::vector<uint16_t> pixels_16(BEEMU_DISPLAY_WIDTH * BEEMU_DISPLAY_HEIGHT);
+	beemu_display_export_16(display, colours_16, pixels_16.data());
+	EXPECT_EQ(pixels_16.front(), 0x0000);
+	EXPECT_EQ(pixels_16.back(), 0x52AA);
+	beemu_display_free(display);
+	beemu_memory_free(memory);
+}
+}
@@ -0,0 +1,98 @@
+#include <beemu/device/device.h>
+#include <beemu/device/runner.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace BeemuTests {
+
+class BeemuRunnerTestFixture : public ::testing::Test {
+protected:
+	std::vector<BeemuDevice *> devices;
+
+	void TearDown() override
+	{
+		for (BeemuDevice *device : devices) {
+			beemu_device_free(device);
+		}
+	}
+
+	/**
+	 * Create a device looping over a short ALU program, seeded so that
+	 * every device ends up in a different state.
+	 */
+	BeemuDevice *new_device(const uint8_t seed)
+	{
+		BeemuDevice *device = beemu_device_new();
+		// LD B, seed; ADD A, B; INC C; XOR A, C; LD (HL), A; INC HL; JR -7
+		const uint8_t program[] = {0x06, seed, 0x80, 0x0C, 0xA9, 0x77, 0x23, 0x18, 0xF9};
+		for (size_t i = 0; i < sizeof(program); i++) {
+			beemu_memory_write(device->processor->memory, 0x100 + i, program[i]);
+		}
+		*beemu_registers_ptr_8(device->processor->registers, BEEMU_REGISTER_H) = 0xC0;
+		*beemu_registers_ptr_8(device->processor->registers, BEEMU_REGISTER_L) = 0x00;
+		devices.push_back(device);
+		return device;
+	}
+};
+
+TEST_F(BeemuRunnerTestFixture, ParallelRunMatchesSequentialRun)
+{
+	const int device_count = 64;
+	std::vector<BeemuRunnerJob> parallel_jobs;
+	std::vector<BeemuRunnerJob> sequential_jobs;
+	for (int i = 0; i < device_count; i++) {
+		// Uneven budgets so that threads have to steal.
+		const uint64_t budget = 1000 + (i % 7) * 5000;
+		parallel_jobs.push_back({new_device(i), budget, 0, 0});
+		sequential_jobs.push_back({new_device(i), budget, 0, 0});
+	}
+	BeemuRunnerReport parallel_report;
+	BeemuRunnerReport sequential_report;
+	ASSERT_TRUE(beemu_runner_run(parallel_jobs.data(), parallel_jobs.size(), 4, &parallel_report));
+	ASSERT_TRUE(beemu_runner_run(sequential_jobs.data(), sequential_jobs.size(), 1, &sequential_report));
+	EXPECT_EQ(parallel_report.thread_count, 4);
+	EXPECT_EQ(sequential_report.thread_count, 1);
+	EXPECT_EQ(sequential_report.stolen_jobs, 0);
+	EXPECT_EQ(parallel_report.total_cycles, sequential_report.total_cycles);
+	uint64_t total_cycles = 0;
+	for (int i = 0; i < device_count; i++) {
+		const BeemuProcessor *parallel = parallel_jobs[i].device->processor;
+		const BeemuProcessor *sequential = sequential_jobs[i].device->processor;
+		EXPECT_GE(parallel_jobs[i].elapsed_cycles, parallel_jobs[i].cycle_budget);
+		EXPECT_EQ(parallel_jobs[i].elapsed_cycles, sequential_jobs[i].elapsed_cycles);
+		for (int pair = 0; pair < BEEMU_REGISTER_PAIR_COUNT; pair++) {
+			EXPECT_EQ(parallel->registers->pairs[pair], sequential->registers->pairs[pair]) << "device " << i;
+		}
+		for (int address = 0xC000; address < 0xC100; address++) {
+			ASSERT_EQ(beemu_memory_read(parallel->memory, address), beemu_memory_read(sequential->memory, address)) << "device " << i;
+		}
+		total_cycles += parallel_jobs[i].elapsed_cycles;
+	}
+	EXPECT_EQ(parallel_report.total_cycles, total_cycles);
+}
+
+TEST_F(BeemuRunnerTestFixture, ReportsCyclesPerSecond)
+{
+	std::vector<BeemuRunnerJob> jobs = {
+		{new_device(1), beemu_runner_frames_to_cycles(2), 0, 0},
+		{new_device(2), 0, 0, 0}};
+	BeemuRunnerReport report;
+	ASSERT_TRUE(beemu_runner_run(jobs.data(), jobs.size(), 0, &report));
+	EXPECT_GE(jobs[0].elapsed_cycles, 2 * BEEMU_DEVICE_CYCLES_PER_FRAME);
+	EXPECT_GT(beemu_runner_job_cycles_per_second(&jobs[0]), 0);
+	// A job without a budget never runs.
+	EXPECT_EQ(jobs[1].elapsed_cycles, 0);
+	EXPECT_EQ(beemu_runner_job_cycles_per_second(&jobs[1]), 0);
+	EXPECT_GT(report.cycles_per_second, 0);
+	EXPECT_LE(report.thread_count, 2);
+}
+
+TEST_F(BeemuRunnerTestFixture, RunsWithoutJobs)
+{
+	BeemuRunnerReport report;
+	ASSERT_TRUE(beemu_runner_run(nullptr, 0, 0, &report));
+	EXPECT_EQ(report.total_cycles, 0);
+	EXPECT_EQ(report.thread_count, 1);
+}
+
+}
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <beemu/device/scheduler.h>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace BeemuTests {
+
+class BeemuSchedulerTestFixture : public ::testing::Test {
+protected:
+	BeemuScheduler scheduler;
+
+	void SetUp() override
+	{
+		beemu_scheduler_init(&scheduler);
+	}
+
+	/**
+	 * Pop every event that is due by the given cycle.
+	 */
+	std::vector<BeemuEventType> pop_due(const uint64_t now)
+	{
+		std::vector<BeemuEventType> types;
+		BeemuScheduledEvent event;
+		while (beemu_scheduler_pop_due(&scheduler, now, &event)) {
+			EXPECT_LE(event.deadline, now);
+			types.push_back(event.type);
+		}
+		return types;
+	}
+};
+
+TEST_F(BeemuSchedulerTestFixture, PopsEventsInDeadlineOrder)
+{
+	EXPECT_EQ(beemu_scheduler_next_deadline(&scheduler), BEEMU_SCHEDULER_NEVER);
+	beemu_scheduler_schedule(&scheduler, BEEMU_EVENT_TIMER_OVERFLOW, 300);
+	beemu_scheduler_schedule(&scheduler, BEEMU_EVENT_PPU_MODE, 80);
+	beemu_scheduler_schedule(&scheduler, BEEMU_EVENT_DMA_COMPLETE, 640);
+	// Ties are broken by type.
+	beemu_scheduler_schedule(&scheduler, BEEMU_EVENT_FRAME_END, 300);
+	EXPECT_EQ(beemu_scheduler_next_deadline(&scheduler), 80);
+	EXPECT_TRUE(pop_due(79).empty());
+	EXPECT_EQ(pop_due(80), std::vector<BeemuEventType>{BEEMU_EVENT_PPU_MODE});
+	EXPECT_EQ(pop_due(500), (std::vector<BeemuEventType>{BEEMU_EVENT_FRAME_END, BEEMU_EVENT_TIMER_OVERFLOW}));
+	EXPECT_EQ(beemu_scheduler_next_deadline(&scheduler), 640);
+}
+
+TEST_F(BeemuSchedulerTestFixture, ReschedulingMovesTheEvent)
+{
+	beemu_scheduler_schedule(&scheduler, BEEMU_EVENT_TIMER_OVERFLOW, 300);
+	beemu_scheduler_schedule(&scheduler, BEEMU_EVENT_PPU_MODE, 200);
+	// A write to TAC or TIMA moves the overflow, it is not scheduled twice.
+	beemu_scheduler_schedule(&scheduler, BEEMU_EVENT_TIMER_OVERFLOW, 100);
+	EXPECT_EQ(scheduler.size, 2);
+	EXPECT_EQ(beemu_scheduler_deadline(&scheduler, BEEMU_EVENT_TIMER_OVERFLOW), 100);
+	beemu_scheduler_schedule(&scheduler, BEEMU_EVENT_TIMER_OVERFLOW, 400);
+	EXPECT_EQ(pop_due(1000), (std::vector<BeemuEventType>{BEEMU_EVENT_PPU_MODE, BEEMU_EVENT_TIMER_OVERFLOW}));
+	beemu_scheduler_schedule(&scheduler, BEEMU_EVENT_SERIAL_TRANSFER, 10);
+	beemu_scheduler_cancel(&scheduler, BEEMU_EVENT_SERIAL_TRANSFER);
+	beemu_scheduler_cancel(&scheduler, BEEMU_EVENT_SERIAL_TRANSFER);
+	EXPECT_EQ(beemu_scheduler_deadline(&scheduler, BEEMU_EVENT_SERIAL_TRANSFER), BEEMU_SCHEDULER_NEVER);
+	EXPECT_EQ(scheduler.size, 0);
+}
+
+TEST_F(BeemuSchedulerTestFixture, MatchesASortedReference)
+{
+	std::mt19937 random_engine{0x5C4E};
+	std::uniform_int_distribution<int> type(0, BEEMU_EVENT_TYPE_COUNT - 1);
+	std::uniform_int_distribution<int> action(0, 3);
+	std::uniform_int_distribution<uint64_t> delay(0, 1000);
+	uint64_t reference[BEEMU_EVENT_TYPE_COUNT];
+	std::fill(std::begin(reference), std::end(reference), BEEMU_SCHEDULER_NEVER);
+	uint64_t now = 0;
+	for (int step = 0; step < 20000; step++) {
+		const BeemuEventType event_type = static_cast<BeemuEventType>(type(random_engine));
+		switch (action(random_engine)) {
+		case 0:
+		case 1:
+			reference[event_type] = now + delay(random_engine);
+			beemu_scheduler_schedule(&scheduler, event_type, reference[event_type]);
+			break;
+		case 2:
+			reference[event_type] = BEEMU_SCHEDULER_NEVER;
+			beemu_scheduler_cancel(&scheduler, event_type);
+			break;
+		default: {
+			now += delay(random_engine);
+			std::vector<std::pair<uint64_t, int>> due;
+			for (int i = 0; i < BEEMU_EVENT_TYPE_COUNT; i++) {
+				if (reference[i] <= now) {
+					due.emplace_back(reference[i], i);
+					reference[i] = BEEMU_SCHEDULER_NEVER;
+				}
+			}
+			std::sort(due.begin(), due.end());
+			std::vector<BeemuEventType> expected;
+			for (const auto &[deadline, i] : due) {
+				expected.push_back(static_cast<BeemuEventType>(i));
+			}
+			ASSERT_EQ(pop_due(now), expected) << "step " << step;
+			break;
+		}
+		}
+		const uint64_t earliest = *std::min_element(std::begin(reference), std::end(reference));
+		ASSERT_EQ(beemu_scheduler_next_deadline(&scheduler), earliest) << "step " << step;
+	}
+}
+
+}
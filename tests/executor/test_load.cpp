@@ -58,9 +58,9 @@ TEST_F(BeemuTestFixture, InstructionLoadImmediate)
 	BeemuParam dst = get_register_8(BEEMU_REGISTER_A);
 	BeemuParam src = get_uint_8(10);
 	BeemuInstruction instruction = generate_load_instruction(dst, src);
-	EXPECT_EQ(0x1, registers->registers[BEEMU_REGISTER_A]);
+	EXPECT_EQ(0x1, *beemu_registers_ptr_8(registers, BEEMU_REGISTER_A));
 	execute_instruction(memory, registers, instruction);
-	EXPECT_EQ(10, registers->registers[BEEMU_REGISTER_A]);
+	EXPECT_EQ(10, *beemu_registers_ptr_8(registers, BEEMU_REGISTER_A));
 }
 
 /**
@@ -73,11 +73,11 @@ TEST_F(BeemuTestFixture, InstructionLoadCopy)
 	BeemuInstruction instruction = generate_load_instruction(
 	    dst,
 	    src);
-	EXPECT_EQ(0x1, registers->registers[BEEMU_REGISTER_A]);
-	EXPECT_EQ(0xff, registers->registers[BEEMU_REGISTER_B]);
+	EXPECT_EQ(0x1, *beemu_registers_ptr_8(registers, BEEMU_REGISTER_A));
+	EXPECT_EQ(0xff, *beemu_registers_ptr_8(registers, BEEMU_REGISTER_B));
 	beemu_registers_write_register_value(registers, a, 5);
 	execute_instruction(memory, registers, instruction);
-	EXPECT_EQ(5, registers->registers[BEEMU_REGISTER_B]);
+	EXPECT_EQ(5, *beemu_registers_ptr_8(registers, BEEMU_REGISTER_B));
 }
 
 /**
@@ -85,7 +85,7 @@ TEST_F(BeemuTestFixture, InstructionLoadCopy)
  */
 TEST_F(BeemuTestFixture, InstructionLoadWithPointers)
 {
-	registers->registers[BEEMU_REGISTER_C] = 5;
+	*beemu_registers_ptr_8(registers, BEEMU_REGISTER_C) = 5;
 	beemu_memory_write(memory, 5, 10);
 	// This instruction means, load to the memory address 10,
 	// the value hold in the memory address hold in the register
@@ -38,7 +38,8 @@ NLOHMANN_JSON_SERIALIZE_ENUM(
 		{BEEMU_WRITE_TARGET_MEMORY_ADDRESS, "BEEMU_WRITE_TARGET_MEMORY_ADDRESS"},
 		{BEEMU_WRITE_TARGET_FLAG, "BEEMU_WRITE_TARGET_FLAG"},
 		{BEEMU_WRITE_TARGET_IME, "BEEMU_WRITE_TARGET_IME"},
-		{BEEMU_WRITE_TARGET_INTERNAL, "BEEMU_WRITE_TARGET_INTERNAL"}}
+		{BEEMU_WRITE_TARGET_INTERNAL, "BEEMU_WRITE_TARGET_INTERNAL"},
+		{BEEMU_WRITE_TARGET_LAZY_FLAGS, "BEEMU_WRITE_TARGET_LAZY_FLAGS"}}
 	);
 
 NLOHMANN_JSON_SERIALIZE_ENUM(
@@ -81,6 +82,11 @@ inline void to_json(nlohmann::json &json, const BeemuWriteTarget &param)
 	case BEEMU_WRITE_TARGET_MEMORY_ADDRESS:
 		json["target"]["mem_addr"] = param.target.mem_addr;
 		break;
+	case BEEMU_WRITE_TARGET_LAZY_FLAGS:
+		json["target"]["lazy_flags"]["operation"] = param.target.lazy_flags.operation;
+		json["target"]["lazy_flags"]["carry_flag"] = param.target.lazy_flags.carry_flag;
+		json["target"]["lazy_flags"]["preserve_carry"] = param.target.lazy_flags.preserve_carry;
+		break;
 	case BEEMU_WRITE_TARGET_IME:
 		break;
 	default:
@@ -107,6 +113,11 @@ inline void from_json(const nlohmann::json &json, BeemuWriteTarget &target)
 	case  BEEMU_WRITE_TARGET_MEMORY_ADDRESS:
 		json.at("target").at("mem_addr").get_to(target.target.mem_addr);
 		break;
+	case BEEMU_WRITE_TARGET_LAZY_FLAGS:
+		json.at("target").at("lazy_flags").at("operation").get_to(target.target.lazy_flags.operation);
+		json.at("target").at("lazy_flags").at("carry_flag").get_to(target.target.lazy_flags.carry_flag);
+		json.at("target").at("lazy_flags").at("preserve_carry").get_to(target.target.lazy_flags.preserve_carry);
+		break;
 	case BEEMU_WRITE_TARGET_IME:
 		break;
 	default:
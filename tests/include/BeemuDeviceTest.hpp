@@ -0,0 +1,23 @@
+#include <beemu/device/device.h>
+#include <cstdint>
+#include <vector>
+
+#ifndef BEEMU_BEEMU_DEVICE_TEST_HPP
+#define BEEMU_BEEMU_DEVICE_TEST_HPP
+
+namespace BeemuTests
+{
+	/**
+	 * Write a program to 0x100 and point the processor of the device at it.
+	 */
+	inline void load_program(BeemuDevice *device, const std::vector<uint8_t> &program)
+	{
+		for (size_t i = 0; i < program.size(); i++)
+		{
+			beemu_memory_write(device->processor->memory, 0x100 + i, program[i]);
+		}
+		device->processor->registers->program_counter = 0x100;
+	}
+};
+
+#endif // BEEMU_BEEMU_DEVICE_TEST_HPP
@@ -19,12 +19,31 @@
 #include <nlohmann/json.hpp>
 #include <vector>
 
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(
-	BeemuRegisters,
-	registers,
-	flags,
-	stack_pointer,
-	program_counter);
+// 8 bit registers are kept as an array in the order of BeemuRegister_8,
+// independent of how they are packed into pairs.
+inline void to_json(nlohmann::json &json, const BeemuRegisters &param)
+{
+	std::vector<uint8_t> registers;
+	for (int i = BEEMU_REGISTER_A; i <= BEEMU_REGISTER_L; i++) {
+		registers.push_back(*beemu_registers_ptr_8(const_cast<BeemuRegisters *>(&param), static_cast<BeemuRegister_8>(i)));
+	}
+	json["registers"] = registers;
+	json["flags"] = param.flags;
+	json["stack_pointer"] = param.stack_pointer;
+	json["program_counter"] = param.program_counter;
+}
+
+inline void from_json(const nlohmann::json &json, BeemuRegisters &param)
+{
+	param = BeemuRegisters{};
+	const std::vector<uint8_t> registers = json.at("registers").get<std::vector<uint8_t>>();
+	for (int i = BEEMU_REGISTER_A; i <= BEEMU_REGISTER_L; i++) {
+		*beemu_registers_ptr_8(&param, static_cast<BeemuRegister_8>(i)) = registers.at(i);
+	}
+	json.at("flags").get_to(param.flags);
+	json.at("stack_pointer").get_to(param.stack_pointer);
+	json.at("program_counter").get_to(param.program_counter);
+}
 
 inline void to_json(nlohmann::json &json, const BeemuMemory &param)
 {
@@ -46,6 +65,7 @@ inline void from_json(const nlohmann::json &json, BeemuMemory &param)
 		memory[memaddr++] = cell;
 	}
 	param.memory = memory;
+	beemu_memory_reset_pages(&param);
 }
 
 NLOHMANN_JSON_SERIALIZE_ENUM(
@@ -71,6 +91,7 @@ inline void from_json(const nlohmann::json &json, BeemuProcessor &param)
 	json.at("processor_state").get_to(param.processor_state);
 	json.at("interrupts_enabled").get_to(param.interrupts_enabled);
 	json.at("elapsed_clock_cycle").get_to(param.elapsed_clock_cycle);
+	param.lazy_flags = false;
 	auto memory = static_cast<BeemuMemory*>(std::malloc(sizeof(BeemuMemory)));
 	json.at("memory").get_to(*memory);
 	param.memory = memory;
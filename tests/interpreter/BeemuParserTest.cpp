@@ -1,5 +1,9 @@
 #include "BeemuParserTest.hpp"
 #include "../../src/beemu/device/processor/interpreter/parser/parser.h"
+#include "../../src/beemu/device/processor/interpreter/parser/parse_cache.h"
+#include <beemu/device/memory.h>
+#include <beemu/device/processor/tokenizer.h>
+#include <random>
 
 namespace BeemuTests
 {
@@ -26,8 +30,6 @@ TEST_P(BeemuParserParameterizedTestFixture, TokenParsedCorrectly)
 		auto expected_command = beemu_command_queue_dequeue(&expected_commands);
 		auto actual_command = beemu_command_queue_dequeue(actual_commands);
 		ASSERT_EQ(*expected_command, *actual_command);
-		free(expected_command);
-		free(actual_command);
 	}
 
 	if (!beemu_command_queue_is_empty(&expected_commands)) {
@@ -37,6 +39,121 @@ TEST_P(BeemuParserParameterizedTestFixture, TokenParsedCorrectly)
 
 }
 
+TEST_P(BeemuParserParameterizedTestFixture, TokenParsedIntoReusedQueueCorrectly)
+{
+	auto params = GetParam();
+	auto instruction = std::get<1>(params);
+	auto processor = std::get<2>(params);
+	auto expected_commands = beemu_parser_parse(&processor, &instruction);
+	// Leave junk in the queue, parsing into it must discard it.
+	static BeemuCommandQueue reused_queue = {};
+	BeemuMachineCommand junk;
+	junk.type = BEEMU_COMMAND_HALT;
+	junk.halt.is_cycle_terminator = true;
+	beemu_command_queue_enqueue(&reused_queue, &junk);
+	beemu_parser_parse_into(&processor, &instruction, &reused_queue);
+	ASSERT_EQ(beemu_command_queue_size(&reused_queue), beemu_command_queue_size(expected_commands));
+	while (!beemu_command_queue_is_empty(expected_commands)) {
+		ASSERT_EQ(*beemu_command_queue_dequeue(expected_commands), *beemu_command_queue_dequeue(&reused_queue));
+	}
+	beemu_command_queue_free(expected_commands);
+}
+
+TEST_P(BeemuParserParameterizedTestFixture, CachedAndUncachedParsesAgree)
+{
+	auto params = GetParam();
+	auto instruction = std::get<1>(params);
+	auto processor = std::get<2>(params);
+	BeemuCommandQueue cached_commands;
+	BeemuCommandQueue uncached_commands;
+	beemu_parser_parse_into(&processor, &instruction, &cached_commands);
+	beemu_parser_parse_uncached_into(&processor, &instruction, &uncached_commands);
+	ASSERT_EQ(beemu_command_queue_size(&cached_commands), beemu_command_queue_size(&uncached_commands));
+	while (!beemu_command_queue_is_empty(&uncached_commands)) {
+		ASSERT_EQ(*beemu_command_queue_dequeue(&uncached_commands), *beemu_command_queue_dequeue(&cached_commands));
+	}
+}
+
+/**
+ * @brief Fill the registers with random values, leaving flags pending if lazy.
+ */
+static void randomise_registers(BeemuProcessor *processor, std::mt19937 &random)
+{
+	for (int i = 0; i < 7; i++) {
+		*beemu_registers_ptr_8(processor->registers, static_cast<BeemuRegister_8>(i)) = random();
+	}
+	processor->registers->stack_pointer = random();
+	processor->registers->program_counter = random();
+	processor->registers->flags = random() & 0xF0;
+	processor->registers->lazy_flags.pending = false;
+	if (processor->lazy_flags) {
+		const BeemuOperation operations[] = {BEEMU_OP_ADD, BEEMU_OP_SUB, BEEMU_OP_INC, BEEMU_OP_DEC, BEEMU_OP_AND};
+		const BeemuOperation operation = operations[random() % 5];
+		beemu_registers_flags_defer(
+			processor->registers,
+			operation,
+			random(),
+			random(),
+			random() & 1,
+			operation == BEEMU_OP_INC || operation == BEEMU_OP_DEC);
+	}
+}
+
+TEST(BeemuParserCacheTest, CachedAndUncachedParsesAgreeOnEveryOpcode)
+{
+	std::mt19937 random(0xBEE);
+	BeemuProcessor *processor = beemu_processor_new();
+	for (int address = 0; address < processor->memory->memory_size; address++) {
+		beemu_memory_write(processor->memory, address, random());
+	}
+	for (const bool lazy_flags : {false, true}) {
+		processor->lazy_flags = lazy_flags;
+		for (uint32_t opcode = 0; opcode < 512; opcode++) {
+			const uint32_t machine_code = opcode < 256
+				? (opcode << 16) | (random() & 0xFFFF)
+				: (0xCB << 16) | ((opcode - 256) << 8);
+			BeemuInstruction instruction;
+			beemu_tokenizer_tokenize_into(&instruction, machine_code);
+			for (int state = 0; state < 8; state++) {
+				randomise_registers(processor, random);
+				const BeemuRegisters registers = *processor->registers;
+				BeemuCommandQueue cached_commands;
+				BeemuCommandQueue uncached_commands;
+				beemu_parser_parse_into(processor, &instruction, &cached_commands);
+				beemu_parser_parse_uncached_into(processor, &instruction, &uncached_commands);
+				// Parsing only emits commands, pending flags stay pending.
+				ASSERT_EQ(memcmp(processor->registers->pairs, registers.pairs, sizeof(registers.pairs)), 0)
+					<< "Machine code " << std::hex << machine_code << (lazy_flags ? " with lazy flags" : "");
+				ASSERT_EQ(processor->registers->lazy_flags.pending, registers.lazy_flags.pending);
+				ASSERT_EQ(beemu_command_queue_size(&cached_commands), beemu_command_queue_size(&uncached_commands))
+					<< "Machine code " << std::hex << machine_code << (lazy_flags ? " with lazy flags" : "");
+				while (!beemu_command_queue_is_empty(&uncached_commands)) {
+					ASSERT_EQ(*beemu_command_queue_dequeue(&uncached_commands), *beemu_command_queue_dequeue(&cached_commands))
+						<< "Machine code " << std::hex << machine_code << (lazy_flags ? " with lazy flags" : "");
+				}
+			}
+		}
+	}
+	beemu_processor_free(processor);
+}
+
+TEST(BeemuParserCacheTest, ArithmaticAndBitwiseInstructionsAreCached)
+{
+	BeemuProcessor *processor = beemu_processor_new();
+	// ADD A,B, ADC A,(HL), SUB A,d8, INC (HL), BIT 3,B and SET 0,(HL).
+	const uint32_t machine_codes[] = {0x800000, 0x8E0000, 0xD60000, 0x340000, 0xCB5800, 0xCBC600};
+	for (const bool lazy_flags : {false, true}) {
+		processor->lazy_flags = lazy_flags;
+		for (const uint32_t machine_code : machine_codes) {
+			BeemuInstruction instruction;
+			beemu_tokenizer_tokenize_into(&instruction, machine_code);
+			ASSERT_NE(beemu_parse_cache_lookup(processor, &instruction), nullptr)
+				<< "Machine code " << std::hex << machine_code << (lazy_flags ? " with lazy flags" : "");
+		}
+	}
+	beemu_processor_free(processor);
+}
+
 auto parser_tests = BeemuTests::getCommandsFromTestFile();
 
 INSTANTIATE_TEST_SUITE_P(
@@ -8,8 +8,8 @@ namespace BeemuTests {
 TEST_F(BeemuTestFixture, CommandQueueNew)
 {
 	const BeemuCommandQueue *queue = beemu_command_queue_new();
-	EXPECT_EQ(queue->first, nullptr);
-	EXPECT_EQ(queue->last, nullptr);
+	EXPECT_EQ(queue->head, 0);
+	EXPECT_EQ(queue->tail, 0);
 }
 
 TEST_F(BeemuTestFixture, CommandQueueEnqueue)
@@ -21,9 +21,9 @@ TEST_F(BeemuTestFixture, CommandQueueEnqueue)
 	command.halt.is_cycle_terminator = false;
 	beemu_command_queue_enqueue(queue, &command);
 	// Values must be the same.
-	EXPECT_EQ(command.type, queue->first->current->type);
-	EXPECT_EQ(command.halt.halt_operation, queue->first->current->halt.halt_operation);
-	EXPECT_EQ(command.halt.is_cycle_terminator, queue->first->current->halt.is_cycle_terminator);
+	EXPECT_EQ(command.type, beemu_command_queue_peek(queue)->type);
+	EXPECT_EQ(command.halt.halt_operation, beemu_command_queue_peek(queue)->halt.halt_operation);
+	EXPECT_EQ(command.halt.is_cycle_terminator, beemu_command_queue_peek(queue)->halt.is_cycle_terminator);
 }
 
 TEST_F(BeemuTestFixture, CommandQueueEnqueueShouldCopy)
@@ -35,7 +35,7 @@ TEST_F(BeemuTestFixture, CommandQueueEnqueueShouldCopy)
 	command.halt.is_cycle_terminator = false;
 	beemu_command_queue_enqueue(queue, &command);
 	// The addresses must be different.
-	EXPECT_NE(&command, queue->first->current);
+	EXPECT_NE(&command, beemu_command_queue_peek(queue));
 }
 
 TEST_F(BeemuTestFixture, CommandQueueEnqueueFirstLastTrackingShouldBeCorrect)
@@ -60,10 +60,11 @@ TEST_F(BeemuTestFixture, CommandQueueEnqueueFirstLastTrackingShouldBeCorrect)
 
 	// Expect first and last to be the correct ones.
 
-	EXPECT_EQ(command.type, queue->first->current->type);
-	EXPECT_EQ(second_command.type, queue->last->current->type);
-	// Also check if internal nodes are correct.
-	EXPECT_EQ(queue->first->next->next->current->type, second_command.type);
+	EXPECT_EQ(beemu_command_queue_size(queue), 3);
+	EXPECT_EQ(command.type, beemu_command_queue_peek(queue)->type);
+	EXPECT_EQ(second_command.type, queue->commands[queue->tail - 1].type);
+	// Also check if internal slots are correct.
+	EXPECT_EQ(queue->commands[queue->head + 2].type, second_command.type);
 }
 
 TEST_F(BeemuTestFixture, CommandQueueDequeueShouldReturnFirstMember)
@@ -116,9 +117,9 @@ TEST_F(BeemuTestFixture, CommandQueueDequeueShouldCorrectlyReturnToEmptyState)
 	beemu_command_queue_dequeue(queue);
 	beemu_command_queue_dequeue(queue);
 
-	// Expect first and last to be the correct ones.
-	EXPECT_EQ(queue->first, nullptr);
-	EXPECT_EQ(queue->last, nullptr);
+	// Expect head to have caught up with the tail.
+	EXPECT_EQ(queue->head, queue->tail);
+	EXPECT_EQ(beemu_command_queue_dequeue(queue), nullptr);
 }
 
 TEST_F(BeemuTestFixture, CommandQueueDequeueShouldUpdateFirstPointer)
@@ -144,9 +145,9 @@ TEST_F(BeemuTestFixture, CommandQueueDequeueShouldUpdateFirstPointer)
 	beemu_command_queue_dequeue(queue);
 
 	// Expect first and last to be the correct ones.
-	EXPECT_EQ(queue->last->current->type, command.type);
-	EXPECT_EQ(queue->first->current->type, second_command.type);
-	EXPECT_EQ(queue->first->next, queue->last);
+	EXPECT_EQ(queue->commands[queue->tail - 1].type, command.type);
+	EXPECT_EQ(beemu_command_queue_peek(queue)->type, second_command.type);
+	EXPECT_EQ(beemu_command_queue_size(queue), 2);
 }
 
 TEST_F(BeemuTestFixture, CommandQueueIsEmptyShouldBeTrueOnNew)
@@ -180,4 +181,40 @@ TEST_F(BeemuTestFixture, CommandQueueEmptyAfterDequeue)
 	beemu_command_queue_dequeue(queue);
 	EXPECT_TRUE(beemu_command_queue_is_empty(queue));
 }
+TEST_F(BeemuTestFixture, CommandQueueShouldWrapAroundCapacity)
+{
+	BeemuCommandQueue *queue = beemu_command_queue_new();
+	BeemuMachineCommand command;
+	command.type = BEEMU_COMMAND_WRITE;
+	command.write.target = {BEEMU_WRITE_TARGET_REGISTER_8, { .register_8=BEEMU_REGISTER_A}};
+	// Push the indices well past the capacity so that the ring wraps multiple times.
+	for (uint16_t i = 0; i < BEEMU_COMMAND_QUEUE_CAPACITY * 3; i++) {
+		command.write.value = {false, {.byte_value=static_cast<uint8_t>(i)}};
+		beemu_command_queue_enqueue(queue, &command);
+		command.write.value = {false, {.byte_value=static_cast<uint8_t>(i + 1)}};
+		beemu_command_queue_enqueue(queue, &command);
+		EXPECT_EQ(beemu_command_queue_dequeue(queue)->write.value.value.byte_value, static_cast<uint8_t>(i));
+		EXPECT_EQ(beemu_command_queue_dequeue(queue)->write.value.value.byte_value, static_cast<uint8_t>(i + 1));
+	}
+	EXPECT_TRUE(beemu_command_queue_is_empty(queue));
+	beemu_command_queue_free(queue);
+}
+
+TEST_F(BeemuTestFixture, CommandQueueShouldHoldFullCapacity)
+{
+	BeemuCommandQueue queue;
+	beemu_command_queue_init(&queue);
+	BeemuMachineCommand command;
+	command.type = BEEMU_COMMAND_WRITE;
+	command.write.target = {BEEMU_WRITE_TARGET_REGISTER_8, { .register_8=BEEMU_REGISTER_A}};
+	for (uint16_t i = 0; i < BEEMU_COMMAND_QUEUE_CAPACITY; i++) {
+		command.write.value = {false, {.byte_value=static_cast<uint8_t>(i)}};
+		beemu_command_queue_enqueue(&queue, &command);
+	}
+	EXPECT_EQ(beemu_command_queue_size(&queue), BEEMU_COMMAND_QUEUE_CAPACITY);
+	for (uint16_t i = 0; i < BEEMU_COMMAND_QUEUE_CAPACITY; i++) {
+		EXPECT_EQ(beemu_command_queue_dequeue(&queue)->write.value.value.byte_value, i);
+	}
+	EXPECT_TRUE(beemu_command_queue_is_empty(&queue));
+}
 }
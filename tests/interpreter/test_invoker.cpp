@@ -0,0 +1,164 @@
+#include "../../src/beemu/device/processor/interpreter/invoker.h"
+#include <BeemuTest.hpp>
+#include <gtest/gtest.h>
+#include <beemu/device/processor/processor.h>
+
+namespace BeemuTests {
+
+class BeemuInvokerTestFixture : public ::testing::Test {
+protected:
+	BeemuProcessor *processor;
+	BeemuCommandQueue queue;
+
+	void SetUp() override
+	{
+		processor = beemu_processor_new();
+		beemu_command_queue_init(&queue);
+	}
+
+	void TearDown() override
+	{
+		beemu_processor_free(processor);
+	}
+
+	void enqueue_write(BeemuWriteTarget target, BeemuWriteValue value)
+	{
+		BeemuMachineCommand command;
+		command.type = BEEMU_COMMAND_WRITE;
+		command.write.target = target;
+		command.write.value = value;
+		beemu_command_queue_enqueue(&queue, &command);
+	}
+
+	void enqueue_halt(bool is_cycle_terminator, BeemuSystemOperation operation = BEEMU_CPU_OP_NOP)
+	{
+		BeemuMachineCommand command;
+		command.type = BEEMU_COMMAND_HALT;
+		command.halt.is_cycle_terminator = is_cycle_terminator;
+		command.halt.halt_operation = operation;
+		beemu_command_queue_enqueue(&queue, &command);
+	}
+};
+
+TEST_F(BeemuInvokerTestFixture, InvokerWritesEveryTargetType)
+{
+	enqueue_write({BEEMU_WRITE_TARGET_REGISTER_8, {.register_8 = BEEMU_REGISTER_B}}, {false, {.byte_value = 0x42}});
+	enqueue_write({BEEMU_WRITE_TARGET_REGISTER_16, {.register_16 = BEEMU_REGISTER_HL}}, {true, {.double_value = 0xBEEF}});
+	enqueue_write({BEEMU_WRITE_TARGET_MEMORY_ADDRESS, {.mem_addr = 0xC000}}, {false, {.byte_value = 0x99}});
+	enqueue_write({BEEMU_WRITE_TARGET_IME, {}}, {false, {.byte_value = 0}});
+	enqueue_write({BEEMU_WRITE_TARGET_INTERNAL, {.internal_target = BEEMU_INTERNAL_WRITE_TARGET_PROGRAM_COUNTER}}, {true, {.double_value = 0x1234}});
+	enqueue_write({BEEMU_WRITE_TARGET_INTERNAL, {.internal_target = BEEMU_INTERNAL_WRITE_TARGET_INSTRUCTION_REGISTER}}, {false, {.byte_value = 0xCB}});
+	EXPECT_FALSE(beemu_invoker_invoke_cycle(processor, &queue));
+	EXPECT_EQ(*beemu_registers_ptr_8(processor->registers, BEEMU_REGISTER_B), 0x42);
+	EXPECT_EQ(*beemu_registers_ptr_8(processor->registers, BEEMU_REGISTER_H), 0xBE);
+	EXPECT_EQ(*beemu_registers_ptr_8(processor->registers, BEEMU_REGISTER_L), 0xEF);
+	EXPECT_EQ(beemu_memory_read(processor->memory, 0xC000), 0x99);
+	EXPECT_FALSE(processor->interrupts_enabled);
+	EXPECT_EQ(processor->registers->program_counter, 0x1234);
+	EXPECT_EQ(processor->instruction_register, 0xCB);
+}
+
+TEST_F(BeemuInvokerTestFixture, InvokerFlagWritesSetAndClear)
+{
+	processor->registers->flags = 0xF0;
+	enqueue_write({BEEMU_WRITE_TARGET_FLAG, {.flag = BEEMU_FLAG_Z}}, {false, {.byte_value = 0}});
+	enqueue_write({BEEMU_WRITE_TARGET_FLAG, {.flag = BEEMU_FLAG_C}}, {false, {.byte_value = 0}});
+	enqueue_write({BEEMU_WRITE_TARGET_FLAG, {.flag = BEEMU_FLAG_N}}, {false, {.byte_value = 1}});
+	beemu_invoker_invoke_cycle(processor, &queue);
+	EXPECT_EQ(processor->registers->flags, 0x60);
+}
+
+TEST_F(BeemuInvokerTestFixture, InvokerStopsAtCycleTerminator)
+{
+	enqueue_write({BEEMU_WRITE_TARGET_REGISTER_8, {.register_8 = BEEMU_REGISTER_A}}, {false, {.byte_value = 1}});
+	enqueue_halt(true);
+	enqueue_write({BEEMU_WRITE_TARGET_REGISTER_8, {.register_8 = BEEMU_REGISTER_A}}, {false, {.byte_value = 2}});
+	EXPECT_TRUE(beemu_invoker_invoke_cycle(processor, &queue));
+	EXPECT_EQ(*beemu_registers_ptr_8(processor->registers, BEEMU_REGISTER_A), 1);
+	EXPECT_EQ(beemu_command_queue_size(&queue), 1);
+	EXPECT_FALSE(beemu_invoker_invoke_cycle(processor, &queue));
+	EXPECT_EQ(*beemu_registers_ptr_8(processor->registers, BEEMU_REGISTER_A), 2);
+}
+
+TEST_F(BeemuInvokerTestFixture, InvokerSystemHaltDoesNotEndCycle)
+{
+	enqueue_halt(false, BEEMU_CPU_OP_HALT);
+	enqueue_halt(true);
+	EXPECT_TRUE(beemu_invoker_invoke_cycle(processor, &queue));
+	EXPECT_EQ(processor->processor_state, BEEMU_DEVICE_HALT);
+	EXPECT_TRUE(beemu_command_queue_is_empty(&queue));
+}
+
+TEST_F(BeemuInvokerTestFixture, InvokerReportsEveryCycle)
+{
+	for (int i = 0; i < 3; i++) {
+		enqueue_write({BEEMU_WRITE_TARGET_REGISTER_8, {.register_8 = BEEMU_REGISTER_A}}, {false, {.byte_value = static_cast<uint8_t>(i)}});
+		enqueue_halt(true);
+	}
+	int reported_cycles = 0;
+	const uint8_t cycles = beemu_invoker_invoke(
+		processor,
+		&queue,
+		[](void *context, BeemuProcessor *) { (*static_cast<int *>(context))++; },
+		&reported_cycles);
+	EXPECT_EQ(cycles, 3);
+	EXPECT_EQ(reported_cycles, 3);
+	EXPECT_TRUE(beemu_command_queue_is_empty(&queue));
+}
+
+TEST_F(BeemuInvokerTestFixture, ProcessorRunExecutesInstructionAtProgramCounter)
+{
+	// LD B, 0x5A followed by LD C, B
+	const uint16_t pc = processor->registers->program_counter;
+	beemu_memory_write(processor->memory, pc, 0x06);
+	beemu_memory_write(processor->memory, pc + 1, 0x5A);
+	beemu_memory_write(processor->memory, pc + 2, 0x48);
+	EXPECT_EQ(beemu_processor_run(processor), 2);
+	EXPECT_EQ(*beemu_registers_ptr_8(processor->registers, BEEMU_REGISTER_B), 0x5A);
+	EXPECT_EQ(processor->registers->program_counter, pc + 2);
+	EXPECT_EQ(beemu_processor_run(processor), 1);
+	EXPECT_EQ(*beemu_registers_ptr_8(processor->registers, BEEMU_REGISTER_C), 0x5A);
+	EXPECT_EQ(processor->registers->program_counter, pc + 3);
+	EXPECT_EQ(processor->elapsed_clock_cycle, 1);
+}
+
+TEST_F(BeemuInvokerTestFixture, ProcessorRunJumpsInTheCycleAccurateMode)
+{
+	// INC B; JR -3
+	processor->registers->program_counter = 0x100;
+	*beemu_registers_ptr_8(processor->registers, BEEMU_REGISTER_B) = 0;
+	beemu_memory_write(processor->memory, 0x100, 0x04);
+	beemu_memory_write(processor->memory, 0x101, 0x18);
+	beemu_memory_write(processor->memory, 0x102, 0xFD);
+	for (int i = 0; i < 3; i++) {
+		EXPECT_EQ(beemu_processor_run(processor), 1);
+		EXPECT_EQ(beemu_processor_run(processor), 3);
+		EXPECT_EQ(processor->registers->program_counter, 0x100);
+	}
+	EXPECT_EQ(*beemu_registers_ptr_8(processor->registers, BEEMU_REGISTER_B), 3);
+}
+
+TEST_F(BeemuInvokerTestFixture, ProcessorRunEnablesInterruptsAfterTheNextInstruction)
+{
+	// DI; EI; NOP; NOP; EI; DI; NOP
+	const std::vector<uint8_t> program = {0xF3, 0xFB, 0x00, 0x00, 0xFB, 0xF3, 0x00};
+	processor->registers->program_counter = 0x100;
+	for (size_t i = 0; i < program.size(); i++) {
+		beemu_memory_write(processor->memory, 0x100 + i, program[i]);
+	}
+	beemu_processor_run(processor);
+	beemu_processor_run(processor);
+	EXPECT_FALSE(processor->interrupts_enabled);
+	beemu_processor_run(processor);
+	EXPECT_TRUE(processor->interrupts_enabled);
+	EXPECT_EQ(processor->processor_state, BEEMU_DEVICE_NORMAL);
+	beemu_processor_run(processor);
+	EXPECT_TRUE(processor->interrupts_enabled);
+	// DI right after EI cancels it.
+	beemu_processor_run(processor);
+	beemu_processor_run(processor);
+	beemu_processor_run(processor);
+	EXPECT_FALSE(processor->interrupts_enabled);
+	EXPECT_EQ(processor->processor_state, BEEMU_DEVICE_NORMAL);
+}
+}
@@ -1,6 +1,7 @@
 #include "BeemuMemoryTest.hpp"
 #include <gtest/gtest.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "../utilities/BeemuProcessorPreset.hpp"
 namespace BeemuTests
@@ -134,4 +135,105 @@ namespace BeemuTests
 		beemu_memory_copy(memory, memory, 0xFF, 0xDD, 2);
 		EXPECT_EQ(beemu_memory_read_16(memory, 0xDD), 0xA0AF);
 	}
-}
\ No newline at end of file
+
+	/**
+	 * Check if bank switching by repointing pages changes what is read.
+	 */
+	TEST_F(BeemuMemoryTest, RepointedPagesReadFromTheirBank)
+	{
+		uint8_t banks[2][0x4000];
+		memset(banks[0], 0x11, sizeof(banks[0]));
+		memset(banks[1], 0x22, sizeof(banks[1]));
+		beemu_memory_map_pages(memory, 0x40, 0x40, banks[0], nullptr);
+		EXPECT_EQ(beemu_memory_read(memory, 0x4000), 0x11);
+		EXPECT_EQ(beemu_memory_read(memory, 0x7FFF), 0x11);
+		beemu_memory_map_pages(memory, 0x40, 0x40, banks[1], nullptr);
+		EXPECT_EQ(beemu_memory_read(memory, 0x5ABC), 0x22);
+		// Pages around the bank are untouched.
+		beemu_memory_write(memory, 0x3FFF, 0xAA);
+		EXPECT_EQ(beemu_memory_read(memory, 0x3FFF), 0xAA);
+	}
+
+	/**
+	 * Check if read only pages drop writes when they have no handler.
+	 */
+	TEST_F(BeemuMemoryTest, ReadOnlyPageDropsWrites)
+	{
+		uint8_t rom[BEEMU_MEMORY_PAGE_SIZE] = {0x42};
+		beemu_memory_map_pages(memory, 0x00, 1, rom, nullptr);
+		beemu_memory_set_page_handlers(memory, 0x00, 1, {nullptr, nullptr, nullptr});
+		beemu_memory_write(memory, 0x0000, 0x99);
+		EXPECT_EQ(beemu_memory_read(memory, 0x0000), 0x42);
+		EXPECT_EQ(rom[0], 0x42);
+	}
+
+	/**
+	 * Check if buffer writes spanning a read only page are refused whole.
+	 */
+	TEST_F(BeemuMemoryTest, WriteBufferAcrossReadOnlyPageFails)
+	{
+		uint8_t rom[BEEMU_MEMORY_PAGE_SIZE] = {0x42};
+		beemu_memory_map_pages(memory, 0x01, 1, rom, nullptr);
+		beemu_memory_set_page_handlers(memory, 0x01, 1, {nullptr, nullptr, nullptr});
+		uint8_t buffer[] = {1, 2, 3};
+		EXPECT_FALSE(beemu_memory_write_buffer(memory, 0xFF, buffer, 3));
+		EXPECT_EQ(beemu_memory_read(memory, 0xFF), 0);
+		EXPECT_EQ(rom[0], 0x42);
+		// Writable pages next to it still take the buffer.
+		EXPECT_TRUE(beemu_memory_write_buffer(memory, 0x200, buffer, 3));
+		EXPECT_EQ(beemu_memory_read(memory, 0x202), 3);
+	}
+
+	/**
+	 * Check if pages without storage route to their handlers.
+	 */
+	TEST_F(BeemuMemoryTest, UnmappedPagesRouteToHandlers)
+	{
+		struct Registers {
+			uint16_t last_address;
+			uint8_t last_value;
+		} io = {0, 0};
+		const BeemuMemoryHandler handler = {
+			[](void *, uint16_t address) -> uint8_t {
+				return static_cast<uint8_t>(address) ^ 0xFF;
+			},
+			[](void *context, uint16_t address, uint8_t value) {
+				auto registers = static_cast<Registers *>(context);
+				registers->last_address = address;
+				registers->last_value = value;
+			},
+			&io};
+		beemu_memory_map_pages(memory, 0xFF, 1, nullptr, nullptr);
+		beemu_memory_set_page_handlers(memory, 0xFF, 1, handler);
+		beemu_memory_write(memory, 0xFF40, 0x91);
+		EXPECT_EQ(io.last_address, 0xFF40);
+		EXPECT_EQ(io.last_value, 0x91);
+		EXPECT_EQ(beemu_memory_read(memory, 0xFF44), 0xBB);
+		EXPECT_EQ(memory->memory[0xFF40], 0);
+	}
+
+	/**
+	 * Check if echo RAM can be expressed by mapping pages onto work RAM.
+	 */
+	TEST_F(BeemuMemoryTest, MirroredPagesShareStorage)
+	{
+		beemu_memory_map_pages(memory, 0xE0, 0x1E, memory->memory + 0xC000, memory->memory + 0xC000);
+		beemu_memory_write(memory, 0xE123, 0x5A);
+		EXPECT_EQ(beemu_memory_read(memory, 0xC123), 0x5A);
+		beemu_memory_reset_pages(memory);
+		EXPECT_EQ(beemu_memory_read(memory, 0xE123), 0);
+	}
+
+	/**
+	 * Check if memories smaller than a page are still bounds checked.
+	 */
+	TEST_F(BeemuMemoryTest, PartialPagesAreBoundsChecked)
+	{
+		auto small_memory = beemu_memory_new(20);
+		beemu_memory_write(small_memory, 19, 0xAB);
+		beemu_memory_write(small_memory, 20, 0xCD);
+		EXPECT_EQ(beemu_memory_read(small_memory, 19), 0xAB);
+		EXPECT_EQ(beemu_memory_read(small_memory, 20), 0xFF);
+		beemu_memory_free(small_memory);
+	}
+}
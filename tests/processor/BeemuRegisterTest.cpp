@@ -9,20 +9,20 @@ namespace BeemuTests
 		beemu_registers_write_register_value(registers, a, 8);
 		const uint16_t value = beemu_registers_read_register_value(registers, a);
 		EXPECT_EQ(value, 8);
-		EXPECT_EQ(registers->registers[BEEMU_REGISTER_A], 8);
+		EXPECT_EQ(*beemu_registers_ptr_8(registers, BEEMU_REGISTER_A), 8);
 	}
 
 	TEST_F(BeemuTestFixture, RegistersWriteTest16)
 	{
 		beemu_registers_write_register_value(registers, hl, 0xAAFF);
-		EXPECT_EQ(registers->registers[BEEMU_REGISTER_H], 0xAA);
-		EXPECT_EQ(registers->registers[BEEMU_REGISTER_L], 0xFF);
+		EXPECT_EQ(*beemu_registers_ptr_8(registers, BEEMU_REGISTER_H), 0xAA);
+		EXPECT_EQ(*beemu_registers_ptr_8(registers, BEEMU_REGISTER_L), 0xFF);
 	}
 
 	TEST_F(BeemuTestFixture, RegisterReadTest16)
 	{
-		registers->registers[BEEMU_REGISTER_H] = 0xAA;
-		registers->registers[BEEMU_REGISTER_L] = 0xFF;
+		*beemu_registers_ptr_8(registers, BEEMU_REGISTER_H) = 0xAA;
+		*beemu_registers_ptr_8(registers, BEEMU_REGISTER_L) = 0xFF;
 		EXPECT_EQ(beemu_registers_read_register_value(registers, hl), 0xAAFF);
 	}
 
@@ -32,6 +32,26 @@ namespace BeemuTests
 		EXPECT_EQ(beemu_registers_read_register_value(registers, hl), 0xAAFF);
 	}
 
+	TEST_F(BeemuTestFixture, RegisterPairsAliasTheirHalves)
+	{
+		const BeemuRegister_16 pairs[] = {BEEMU_REGISTER_BC, BEEMU_REGISTER_DE, BEEMU_REGISTER_HL};
+		const BeemuRegister_8 halves[][2] = {
+			{BEEMU_REGISTER_B, BEEMU_REGISTER_C},
+			{BEEMU_REGISTER_D, BEEMU_REGISTER_E},
+			{BEEMU_REGISTER_H, BEEMU_REGISTER_L}};
+		for (int i = 0; i < 3; i++) {
+			registers->pairs[pairs[i]] = 0x1234 + i;
+			EXPECT_EQ(*beemu_registers_ptr_8(registers, halves[i][0]), 0x12);
+			EXPECT_EQ(*beemu_registers_ptr_8(registers, halves[i][1]), 0x34 + i);
+		}
+		registers->pairs[BEEMU_REGISTER_AF] = 0xABC0;
+		EXPECT_EQ(*beemu_registers_ptr_8(registers, BEEMU_REGISTER_A), 0xAB);
+		EXPECT_EQ(registers->flags, 0xC0);
+		// The other pairs are left alone.
+		EXPECT_EQ(registers->pairs[BEEMU_REGISTER_BC], 0x1234);
+		EXPECT_EQ(registers->pairs[BEEMU_REGISTER_HL], 0x1236);
+	}
+
 	TEST_F(BeemuTestFixture, FlagSetTest)
 	{
 		beemu_registers_flags_set_flag(registers, BEEMU_FLAG_Z, 1);
@@ -0,0 +1,72 @@
+#include "../../src/beemu/device/processor/alu.h"
+#include <beemu/device/processor/registers.h>
+#include <gtest/gtest.h>
+
+namespace BeemuTests {
+
+TEST(BeemuAluTest, TablesAgreeWithComputedResults)
+{
+	const BeemuOperation operations[] = {BEEMU_OP_ADD, BEEMU_OP_ADC, BEEMU_OP_SUB, BEEMU_OP_SBC, BEEMU_OP_CP, BEEMU_OP_INC, BEEMU_OP_DEC};
+	for (const BeemuOperation operation : operations) {
+		const bool is_subtraction = operation == BEEMU_OP_SUB || operation == BEEMU_OP_SBC || operation == BEEMU_OP_CP || operation == BEEMU_OP_DEC;
+		for (int carry = 0; carry < 2; carry++) {
+			for (int first = 0; first < 256; first++) {
+				for (int second = 0; second < 256; second++) {
+					const int32_t would_be_result = resolve_result_wo_overflow(first, second, operation, carry);
+					const uint8_t result = would_be_result;
+					const uint8_t half_carry = resolve_half_carry_for_arithmatic(first, second, carry, operation);
+					const BeemuAluOutput output = beemu_alu_lookup(operation, first, second, carry << BEEMU_FLAG_C);
+					ASSERT_EQ(output >> 8, result) << operation << " " << first << " " << second << " " << carry;
+					ASSERT_EQ((output >> BEEMU_FLAG_Z) & 1, result == 0);
+					ASSERT_EQ((output >> BEEMU_FLAG_N) & 1, is_subtraction);
+					ASSERT_EQ((output >> BEEMU_FLAG_H) & 1, half_carry);
+					ASSERT_EQ((output >> BEEMU_FLAG_C) & 1, would_be_result != result);
+					ASSERT_EQ(output & 0x0F, 0);
+				}
+			}
+		}
+	}
+}
+
+TEST(BeemuAluTest, BitwiseOperationsSetTheirFlags)
+{
+	EXPECT_EQ(beemu_alu_lookup(BEEMU_OP_AND, 0xF0, 0x0F, 0xF0), 0x00 << 8 | 1 << BEEMU_FLAG_Z | 1 << BEEMU_FLAG_H);
+	EXPECT_EQ(beemu_alu_lookup(BEEMU_OP_OR, 0xF0, 0x0F, 0xF0), 0xFF << 8);
+	EXPECT_EQ(beemu_alu_lookup(BEEMU_OP_XOR, 0x5A, 0x5A, 0x00), 0x00 << 8 | 1 << BEEMU_FLAG_Z);
+}
+
+TEST(BeemuAluTest, DaaAdjustsToBinaryCodedDecimal)
+{
+	// A pair of two digit BCD numbers, added and subtracted, then adjusted.
+	for (int first = 0; first < 100; first++) {
+		for (int second = 0; second < 100; second++) {
+			const uint8_t first_bcd = (first / 10) << 4 | first % 10;
+			const uint8_t second_bcd = (second / 10) << 4 | second % 10;
+
+			const BeemuAluOutput sum = beemu_alu_lookup(BEEMU_OP_ADD, first_bcd, second_bcd, 0);
+			const BeemuAluOutput adjusted_sum = beemu_alu_lookup(BEEMU_OP_DAA, sum >> 8, 0, sum & 0xF0);
+			const int expected_sum = (first + second) % 100;
+			ASSERT_EQ(adjusted_sum >> 8, (expected_sum / 10) << 4 | expected_sum % 10) << first << " + " << second;
+			ASSERT_EQ((adjusted_sum >> BEEMU_FLAG_C) & 1, first + second >= 100);
+			ASSERT_EQ((adjusted_sum >> BEEMU_FLAG_Z) & 1, expected_sum == 0);
+			ASSERT_EQ((adjusted_sum >> BEEMU_FLAG_H) & 1, 0);
+
+			const BeemuAluOutput difference = beemu_alu_lookup(BEEMU_OP_SUB, first_bcd, second_bcd, 0);
+			const BeemuAluOutput adjusted_difference = beemu_alu_lookup(BEEMU_OP_DAA, difference >> 8, 0, difference & 0xF0);
+			const int expected_difference = (first - second + 100) % 100;
+			ASSERT_EQ(adjusted_difference >> 8, (expected_difference / 10) << 4 | expected_difference % 10) << first << " - " << second;
+			ASSERT_EQ((adjusted_difference >> BEEMU_FLAG_C) & 1, first < second);
+			ASSERT_EQ((adjusted_difference >> BEEMU_FLAG_N) & 1, 1);
+		}
+	}
+}
+
+TEST(BeemuAluTest, FlagOperationsKeepTheirOperand)
+{
+	const uint8_t z_and_c = 1 << BEEMU_FLAG_Z | 1 << BEEMU_FLAG_C;
+	EXPECT_EQ(beemu_alu_lookup(BEEMU_OP_CPL, 0x35, 0x35, z_and_c), 0xCA << 8 | 0xF0);
+	EXPECT_EQ(beemu_alu_lookup(BEEMU_OP_SCF, 0x35, 0x35, 1 << BEEMU_FLAG_H), 0x35 << 8 | 1 << BEEMU_FLAG_C);
+	EXPECT_EQ(beemu_alu_lookup(BEEMU_OP_CCF, 0x35, 0x35, z_and_c), 0x35 << 8 | 1 << BEEMU_FLAG_Z);
+}
+
+}
@@ -0,0 +1,181 @@
+#include <BeemuTest.hpp>
+#include <beemu/device/processor/processor.h>
+#include <beemu/device/processor/tokenizer.h>
+#include <gtest/gtest.h>
+#include <random>
+
+namespace BeemuTests {
+
+class BeemuExecutionModeTestFixture : public ::testing::Test {
+protected:
+	BeemuProcessor *accurate;
+	BeemuProcessor *fast;
+	std::mt19937 random_engine{0xBEE};
+
+	void SetUp() override
+	{
+		accurate = beemu_processor_new();
+		fast = beemu_processor_new();
+		beemu_processor_set_execution_mode(fast, BEEMU_EXECUTION_MODE_INSTRUCTION);
+	}
+
+	void TearDown() override
+	{
+		beemu_processor_free(accurate);
+		beemu_processor_free(fast);
+	}
+
+	/**
+	 * Put both processors to the same random state, with the instruction
+	 * bytes at the program counter.
+	 */
+	void randomise(const uint8_t opcode, const uint8_t second_byte)
+	{
+		std::uniform_int_distribution<int> byte(0, 0xFF);
+		// Keep the PC and the stack away from the end of the address space.
+		std::uniform_int_distribution<int> address(0x0100, 0xFEF0);
+		for (int i = 0; i < BEEMU_DEVICE_MEMORY_SIZE; i++) {
+			const uint8_t value = byte(random_engine);
+			beemu_memory_write(accurate->memory, i, value);
+			beemu_memory_write(fast->memory, i, value);
+		}
+		for (int i = 0; i < 7; i++) {
+			*beemu_registers_ptr_8(accurate->registers, static_cast<BeemuRegister_8>(i)) = *beemu_registers_ptr_8(fast->registers, static_cast<BeemuRegister_8>(i)) = byte(random_engine);
+		}
+		accurate->registers->flags = fast->registers->flags = byte(random_engine) & 0xF0;
+		accurate->registers->stack_pointer = fast->registers->stack_pointer = address(random_engine);
+		const uint16_t pc = address(random_engine);
+		accurate->registers->program_counter = fast->registers->program_counter = pc;
+		for (BeemuProcessor *processor : {accurate, fast}) {
+			// Wake up from a HALT run by the previous attempt.
+			processor->processor_state = BEEMU_DEVICE_NORMAL;
+			beemu_memory_write(processor->memory, pc, opcode);
+			beemu_memory_write(processor->memory, pc + 1, second_byte);
+		}
+	}
+
+	void expect_same_architectural_state(const std::string &context)
+	{
+		for (int i = 0; i < 7; i++) {
+			EXPECT_EQ(*beemu_registers_ptr_8(accurate->registers, static_cast<BeemuRegister_8>(i)), *beemu_registers_ptr_8(fast->registers, static_cast<BeemuRegister_8>(i))) << context << " register " << i;
+		}
+		EXPECT_EQ(accurate->registers->flags, fast->registers->flags) << context;
+		EXPECT_EQ(accurate->registers->stack_pointer, fast->registers->stack_pointer) << context;
+		EXPECT_EQ(accurate->registers->program_counter, fast->registers->program_counter) << context;
+		EXPECT_EQ(accurate->instruction_register, fast->instruction_register) << context;
+		EXPECT_EQ(accurate->processor_state, fast->processor_state) << context;
+		EXPECT_EQ(accurate->interrupts_enabled, fast->interrupts_enabled) << context;
+		for (int i = 0; i < BEEMU_DEVICE_MEMORY_SIZE; i++) {
+			if (beemu_memory_read(accurate->memory, i) != beemu_memory_read(fast->memory, i)) {
+				ADD_FAILURE() << context << " memory differs at " << i;
+				return;
+			}
+		}
+	}
+};
+
+TEST_F(BeemuExecutionModeTestFixture, ExecutionModesAgreeOnEveryOpcode)
+{
+	std::uniform_int_distribution<int> byte(0, 0xFF);
+	for (int prefixed = 0; prefixed < 2; prefixed++) {
+		for (int opcode = 0; opcode < 256; opcode++) {
+			const uint8_t first_byte = prefixed ? 0xCB : opcode;
+			if (!prefixed && first_byte == 0xCB) {
+				continue;
+			}
+			for (int attempt = 0; attempt < 4; attempt++) {
+				const uint8_t second_byte = prefixed ? opcode : byte(random_engine);
+				randomise(first_byte, second_byte);
+				const uint16_t pc = accurate->registers->program_counter;
+				const uint32_t machine_code = (first_byte << 16) | (second_byte << 8) | beemu_memory_read(accurate->memory, pc + 2);
+				const uint8_t accurate_cycles = beemu_processor_run(accurate);
+				const uint8_t fast_cycles = beemu_processor_run(fast);
+				std::stringstream context;
+				context << std::hex << "machine code 0x" << machine_code;
+				BeemuInstruction instruction;
+				beemu_tokenizer_tokenize_into(&instruction, machine_code);
+				if (instruction.type == BEEMU_INSTRUCTION_TYPE_JUMP || instruction.type == BEEMU_INSTRUCTION_TYPE_ROT_SHIFT) {
+					// Taken and untaken jumps alike.
+					EXPECT_EQ(accurate_cycles, fast_cycles) << context.str();
+				}
+				expect_same_architectural_state(context.str());
+				if (HasFailure()) {
+					return;
+				}
+			}
+		}
+	}
+}
+
+TEST_F(BeemuExecutionModeTestFixture, ExecutionModeCanBeSwitchedMidRun)
+{
+	// LD B, 0x12; LD C, B; ADD A, C; LD (HL), A; INC HL; JR +1; INC A;
+	// XOR A, C; LD D, (HL), where the jump skips INC A.
+	const uint8_t program[] = {0x06, 0x12, 0x48, 0x81, 0x77, 0x23, 0x18, 0x01, 0x3C, 0xA9, 0x56};
+	for (BeemuProcessor *processor : {accurate, fast}) {
+		processor->registers->program_counter = 0x200;
+		*beemu_registers_ptr_8(processor->registers, BEEMU_REGISTER_H) = 0xC0;
+		*beemu_registers_ptr_8(processor->registers, BEEMU_REGISTER_L) = 0x00;
+		for (size_t i = 0; i < sizeof(program); i++) {
+			beemu_memory_write(processor->memory, 0x200 + i, program[i]);
+		}
+	}
+	for (int i = 0; i < 8; i++) {
+		// The fast processor drops into the cycle accurate mode halfway.
+		if (i == 3) {
+			beemu_processor_set_execution_mode(fast, BEEMU_EXECUTION_MODE_CYCLE_ACCURATE);
+		}
+		beemu_processor_run(accurate);
+		beemu_processor_run(fast);
+		expect_same_architectural_state("instruction " + std::to_string(i));
+	}
+	EXPECT_EQ(fast->registers->program_counter, 0x200 + sizeof(program));
+}
+
+TEST_F(BeemuExecutionModeTestFixture, ExecutionModesExecuteJumps)
+{
+	for (BeemuProcessor *processor : {accurate, fast}) {
+		processor->registers->program_counter = 0x200;
+		processor->registers->stack_pointer = 0xFFFE;
+		// CALL 0x0300
+		beemu_memory_write(processor->memory, 0x200, 0xCD);
+		beemu_memory_write(processor->memory, 0x201, 0x00);
+		beemu_memory_write(processor->memory, 0x202, 0x03);
+		// RET
+		beemu_memory_write(processor->memory, 0x300, 0xC9);
+		EXPECT_EQ(beemu_processor_run(processor), 6);
+		EXPECT_EQ(processor->registers->program_counter, 0x300);
+		EXPECT_EQ(processor->registers->stack_pointer, 0xFFFC);
+		EXPECT_EQ(beemu_memory_read(processor->memory, 0xFFFD), 0x02);
+		EXPECT_EQ(beemu_memory_read(processor->memory, 0xFFFC), 0x03);
+		EXPECT_EQ(beemu_processor_run(processor), 4);
+		EXPECT_EQ(processor->registers->program_counter, 0x203);
+		EXPECT_EQ(processor->registers->stack_pointer, 0xFFFE);
+	}
+}
+
+TEST_F(BeemuExecutionModeTestFixture, ExecutionModesEnableInterruptsAfterTheNextInstruction)
+{
+	// DI; EI; NOP; EI; DI; NOP
+	const uint8_t program[] = {0xF3, 0xFB, 0x00, 0xFB, 0xF3, 0x00};
+	for (BeemuProcessor *processor : {accurate, fast}) {
+		processor->registers->program_counter = 0x200;
+		for (size_t i = 0; i < sizeof(program); i++) {
+			beemu_memory_write(processor->memory, 0x200 + i, program[i]);
+		}
+		beemu_processor_run(processor);
+		beemu_processor_run(processor);
+		EXPECT_FALSE(processor->interrupts_enabled);
+		beemu_processor_run(processor);
+		EXPECT_TRUE(processor->interrupts_enabled);
+		EXPECT_EQ(processor->processor_state, BEEMU_DEVICE_NORMAL);
+		// DI right after EI cancels it.
+		beemu_processor_run(processor);
+		beemu_processor_run(processor);
+		beemu_processor_run(processor);
+		EXPECT_FALSE(processor->interrupts_enabled);
+		EXPECT_EQ(processor->processor_state, BEEMU_DEVICE_NORMAL);
+	}
+}
+
+}
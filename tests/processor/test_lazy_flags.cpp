@@ -0,0 +1,158 @@
+#include "../../src/beemu/device/processor/interpreter/command.h"
+#include "../../src/beemu/device/processor/interpreter/parser/parser.h"
+#include <BeemuTest.hpp>
+#include <beemu/device/processor/processor.h>
+#include <beemu/device/processor/tokenizer.h>
+#include <gtest/gtest.h>
+#include <random>
+
+namespace BeemuTests {
+
+class BeemuLazyFlagsTestFixture : public ::testing::Test {
+protected:
+	BeemuProcessor *eager;
+	BeemuProcessor *lazy;
+	std::mt19937 random_engine{0xF1A6};
+
+	void SetUp() override
+	{
+		eager = beemu_processor_new();
+		lazy = beemu_processor_new();
+		beemu_processor_set_lazy_flags(lazy, true);
+	}
+
+	void TearDown() override
+	{
+		beemu_processor_free(eager);
+		beemu_processor_free(lazy);
+	}
+
+	/**
+	 * Put both processors to the same random state and write the program
+	 * to the program counter.
+	 */
+	void randomise(const std::vector<uint8_t> &program)
+	{
+		std::uniform_int_distribution<int> byte(0, 0xFF);
+		for (int i = BEEMU_REGISTER_A; i <= BEEMU_REGISTER_L; i++) {
+			const auto register_ = static_cast<BeemuRegister_8>(i);
+			*beemu_registers_ptr_8(eager->registers, register_) = *beemu_registers_ptr_8(lazy->registers, register_) = byte(random_engine);
+		}
+		beemu_registers_flags_materialise(lazy->registers);
+		eager->registers->flags = lazy->registers->flags = byte(random_engine) & 0xF0;
+		for (BeemuProcessor *processor : {eager, lazy}) {
+			processor->registers->program_counter = 0x100;
+			for (size_t i = 0; i < program.size(); i++) {
+				beemu_memory_write(processor->memory, 0x100 + i, program[i]);
+			}
+		}
+	}
+
+	static bool is_arithmatic(const uint8_t opcode)
+	{
+		BeemuInstruction instruction;
+		beemu_tokenizer_tokenize_into(&instruction, opcode << 16);
+		return instruction.type == BEEMU_INSTRUCTION_TYPE_ARITHMATIC;
+	}
+};
+
+TEST_F(BeemuLazyFlagsTestFixture, LazyFlagsMatchEagerFlags)
+{
+	std::uniform_int_distribution<int> byte(0, 0xFF);
+	for (const BeemuExecutionMode mode : {BEEMU_EXECUTION_MODE_CYCLE_ACCURATE, BEEMU_EXECUTION_MODE_INSTRUCTION}) {
+		beemu_processor_set_execution_mode(eager, mode);
+		beemu_processor_set_execution_mode(lazy, mode);
+		for (int first = 0; first < 256; first++) {
+			if (!is_arithmatic(first) || first == 0xCB) {
+				continue;
+			}
+			// Follow each operation with a random one, so that operations
+			// that keep the carry run on top of pending flags.
+			uint8_t second;
+			do {
+				second = byte(random_engine);
+			} while (!is_arithmatic(second));
+			const uint8_t operand = byte(random_engine);
+			randomise({static_cast<uint8_t>(first), operand, second, operand});
+			for (BeemuProcessor *processor : {eager, lazy}) {
+				beemu_processor_run(processor);
+				beemu_processor_run(processor);
+			}
+			beemu_registers_flags_materialise(lazy->registers);
+			std::stringstream context;
+			context << std::hex << "opcodes 0x" << first << ", 0x" << +second << " in mode " << mode;
+			ASSERT_EQ(eager->registers->flags, lazy->registers->flags) << context.str();
+			for (int i = BEEMU_REGISTER_A; i <= BEEMU_REGISTER_L; i++) {
+				const auto register_ = static_cast<BeemuRegister_8>(i);
+				ASSERT_EQ(*beemu_registers_ptr_8(eager->registers, register_), *beemu_registers_ptr_8(lazy->registers, register_)) << context.str();
+			}
+		}
+	}
+}
+
+TEST_F(BeemuLazyFlagsTestFixture, ArithmaticEmitsASingleFlagCommand)
+{
+	BeemuInstruction instruction;
+	// ADD A, B
+	beemu_tokenizer_tokenize_into(&instruction, 0x80 << 16);
+	BeemuCommandQueue queue;
+	beemu_parser_parse_into(eager, &instruction, &queue);
+	const uint32_t eager_commands = beemu_command_queue_size(&queue);
+	beemu_parser_parse_into(lazy, &instruction, &queue);
+	ASSERT_EQ(beemu_command_queue_size(&queue), eager_commands - 3);
+	uint32_t lazy_flag_commands = 0;
+	while (const BeemuMachineCommand *command = beemu_command_queue_dequeue(&queue)) {
+		ASSERT_FALSE(command->type == BEEMU_COMMAND_WRITE && command->write.target.type == BEEMU_WRITE_TARGET_FLAG);
+		lazy_flag_commands += command->type == BEEMU_COMMAND_WRITE && command->write.target.type == BEEMU_WRITE_TARGET_LAZY_FLAGS;
+	}
+	ASSERT_EQ(lazy_flag_commands, 1);
+}
+
+TEST_F(BeemuLazyFlagsTestFixture, ReadingFlagsMaterialisesThem)
+{
+	// XOR A, A; INC A
+	randomise({0xAF, 0x3C});
+	beemu_processor_run(lazy);
+	ASSERT_TRUE(lazy->registers->lazy_flags.pending);
+	ASSERT_EQ(beemu_registers_flags_get_flag(lazy->registers, BEEMU_FLAG_Z), 1);
+	ASSERT_FALSE(lazy->registers->lazy_flags.pending);
+	beemu_processor_run(lazy);
+	ASSERT_TRUE(lazy->registers->lazy_flags.pending);
+	// Reading AF, as PUSH AF does, sees the flags of INC A.
+	const BeemuRegister af = {.type = BEEMU_SIXTEEN_BIT_REGISTER, .name_of = {.sixteen_bit_register = BEEMU_REGISTER_AF}};
+	ASSERT_EQ(beemu_registers_read_register_value(lazy->registers, af), 0x0100);
+	ASSERT_FALSE(lazy->registers->lazy_flags.pending);
+}
+
+TEST_F(BeemuLazyFlagsTestFixture, OperationsThatIgnoreTheFlagsLeaveThemPending)
+{
+	for (const BeemuExecutionMode mode : {BEEMU_EXECUTION_MODE_CYCLE_ACCURATE, BEEMU_EXECUTION_MODE_INSTRUCTION}) {
+		beemu_processor_set_execution_mode(lazy, mode);
+		// XOR A, A; ADD A, B; SUB A, C; AND A, D; OR A, E; CP A, H; ADC A, L
+		randomise({0xAF, 0x80, 0x91, 0xA2, 0xB3, 0xBC, 0x8D});
+		lazy->registers->flags = 0x00;
+		for (int i = 0; i < 6; i++) {
+			beemu_processor_run(lazy);
+			ASSERT_TRUE(lazy->registers->lazy_flags.pending);
+			// F itself is only computed when something reads it.
+			ASSERT_EQ(lazy->registers->flags, 0x00) << "instruction " << i << " in mode " << mode;
+		}
+		// ADC reads the carry CP left behind.
+		const uint8_t carry = (beemu_registers_flags_peek(lazy->registers) >> BEEMU_FLAG_C) & 1;
+		beemu_processor_run(lazy);
+		ASSERT_EQ(lazy->registers->lazy_flags.operation, BEEMU_OP_ADC);
+		ASSERT_EQ(lazy->registers->lazy_flags.carry_flag, carry) << "in mode " << mode;
+	}
+}
+
+TEST_F(BeemuLazyFlagsTestFixture, WritingAFDropsPendingFlags)
+{
+	// SUB A, A
+	randomise({0x97});
+	beemu_processor_run(lazy);
+	const BeemuRegister af = {.type = BEEMU_SIXTEEN_BIT_REGISTER, .name_of = {.sixteen_bit_register = BEEMU_REGISTER_AF}};
+	beemu_registers_write_register_value(lazy->registers, af, 0x12B0);
+	ASSERT_EQ(lazy->registers->flags, 0xB0);
+	ASSERT_EQ(beemu_registers_flags_get_flag(lazy->registers, BEEMU_FLAG_N), 0);
+}
+}
@@ -0,0 +1,102 @@
+#include <BeemuTest.hpp>
+#include <beemu/device/processor/processor.h>
+#include <beemu/device/rom.h>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace BeemuTests {
+
+class BeemuRomTestFixture : public ::testing::Test {
+protected:
+	std::filesystem::path rom_path;
+
+	void SetUp() override
+	{
+		rom_path = std::filesystem::temp_directory_path() / "beemu_test_rom.gb";
+	}
+
+	void TearDown() override
+	{
+		std::filesystem::remove(rom_path);
+	}
+
+	/**
+	 * Write a ROM whose every bank is filled with its index.
+	 */
+	void write_rom(uint8_t rom_size_code, size_t bank_count)
+	{
+		std::vector<uint8_t> rom(bank_count * BEEMU_ROM_BANK_SIZE);
+		for (size_t bank = 0; bank < bank_count; bank++) {
+			std::fill(rom.begin() + bank * BEEMU_ROM_BANK_SIZE, rom.begin() + (bank + 1) * BEEMU_ROM_BANK_SIZE, bank);
+		}
+		const char title[] = "BEEMU TEST";
+		std::fill(rom.begin() + 0x134, rom.begin() + 0x144, 0);
+		std::copy(title, title + sizeof(title) - 1, rom.begin() + 0x134);
+		rom[0x147] = 0x01;
+		rom[0x148] = rom_size_code;
+		rom[0x149] = 0x00;
+		uint8_t checksum = 0;
+		for (int address = 0x134; address < 0x14D; address++) {
+			checksum = checksum - rom[address] - 1;
+		}
+		rom[0x14D] = checksum;
+		std::ofstream file(rom_path, std::ios::binary);
+		file.write(reinterpret_cast<const char *>(rom.data()), rom.size());
+	}
+};
+
+TEST_F(BeemuRomTestFixture, HeaderIsParsed)
+{
+	write_rom(1, 4);
+	BeemuRom *rom = beemu_rom_open(rom_path.string().c_str());
+	ASSERT_NE(rom, nullptr);
+	EXPECT_STREQ(rom->header.title, "BEEMU TEST");
+	EXPECT_EQ(rom->header.cartridge_type, 0x01);
+	EXPECT_EQ(rom->header.bank_count, 4);
+	EXPECT_TRUE(rom->header.header_checksum_valid);
+	EXPECT_EQ(rom->size, 4 * BEEMU_ROM_BANK_SIZE);
+	beemu_rom_close(rom);
+}
+
+TEST_F(BeemuRomTestFixture, ProcessorsShareTheMappedRom)
+{
+	write_rom(1, 4);
+	BeemuRom *rom = beemu_rom_open(rom_path.string().c_str());
+	ASSERT_NE(rom, nullptr);
+	BeemuProcessor *first = beemu_processor_new();
+	BeemuProcessor *second = beemu_processor_new();
+	ASSERT_TRUE(beemu_processor_load_rom(first, rom));
+	ASSERT_TRUE(beemu_processor_load_rom(second, rom));
+	// Pages point straight into the mapping, nothing is copied.
+	EXPECT_EQ(first->memory->read_pages[0x00], rom->data);
+	EXPECT_EQ(second->memory->read_pages[0x40], rom->data + BEEMU_ROM_BANK_SIZE);
+	EXPECT_EQ(beemu_memory_read(first->memory, 0x3FFF), 0);
+	EXPECT_EQ(beemu_memory_read(first->memory, 0x4000), 1);
+	// ROM is read only.
+	beemu_memory_write(first->memory, 0x4000, 0xAA);
+	EXPECT_EQ(beemu_memory_read(first->memory, 0x4000), 1);
+	// Switching banks only repoints the pages of one processor.
+	ASSERT_TRUE(beemu_rom_map_bank(first->memory, rom, 0x40, 3));
+	EXPECT_EQ(beemu_memory_read(first->memory, 0x7FFF), 3);
+	EXPECT_EQ(beemu_memory_read(second->memory, 0x7FFF), 1);
+	EXPECT_FALSE(beemu_rom_map_bank(first->memory, rom, 0x40, 4));
+	beemu_processor_free(first);
+	beemu_processor_free(second);
+	beemu_rom_close(rom);
+}
+
+TEST_F(BeemuRomTestFixture, TruncatedRomIsRejected)
+{
+	// Header declares 8 banks but only 4 are present.
+	write_rom(2, 4);
+	EXPECT_EQ(beemu_rom_open(rom_path.string().c_str()), nullptr);
+}
+
+TEST_F(BeemuRomTestFixture, MissingRomIsRejected)
+{
+	EXPECT_EQ(beemu_rom_open((rom_path.string() + ".missing").c_str()), nullptr);
+}
+
+}
@@ -1,4 +1,3 @@
-from asyncore import write
 from typing import Generator
 
 from tests.resources.command_test_generators.utils import Param, emit_m1_cycle, WriteTo, Halt
@@ -34,9 +33,8 @@ def emit_jump_direct(token, tests, jp_params, param: Param) -> None:
         # This is a special case for JP (HL)
         command_queue += [
             # M2/M1
-            # (Contents of HL) + 1
-            WriteTo.pc(0x0103),
-            WriteTo.ir(0x03)
+            # PC is loaded from HL as the next opcode is fetched.
+            WriteTo.pc(0x0102)
         ]
         tests.append({
             'token': token,
@@ -78,9 +76,6 @@ def emit_jump_direct(token, tests, jp_params, param: Param) -> None:
         command_queue += [
             # M4
             WriteTo.pc(param.value),
-            # For both highstack and nznc processor templates, lsb is the memory value
-            # for a given memory addr.
-            WriteTo.ir(param.value & 0xFF),
             Halt.cycle()
             # M5/M1
         ]
@@ -95,9 +90,6 @@ def emit_jump_direct(token, tests, jp_params, param: Param) -> None:
         command_queue += [
             # M4
             WriteTo.pc(param.value),
-            # For both highstack and nznc processor templates, lsb is the memory value
-            # for a given memory addr.
-            WriteTo.ir(param.value & 0xFF),
             Halt.cycle()
             # M5/M1
         ]
@@ -124,14 +116,14 @@ def emit_jump_relative(token, tests, jp_params, param: Param) -> None:
         Halt.cycle()
     ]
 
-    jump_dest = (0x02 + param.value + 1) % 2**16
+    # Offset is relative to the address of the next instruction.
+    jump_dest = (0x02 + param.value) % 2**16
     truthy_command_queue = [
         *command_queue,
         # M3 Spent handling ALU logic for PCH, PCL
         Halt.cycle(),
         # M4/M1
-        WriteTo.pc(jump_dest),
-        WriteTo.ir(jump_dest & 0xFF)
+        WriteTo.pc(jump_dest)
     ]
 
    # Emit the truthy test case
@@ -162,15 +154,16 @@ def emit_jump_part_of_call(addr: int, current_addr = 0x03) -> Generator:
     the M values are based on CALL semantics.
     """
     # M4
-    yield WriteTo.pc(0xBBFF - 1)
+    yield WriteTo.register('SP', 0xBBFF - 1)
     yield Halt.cycle()
     # M5
-    yield WriteTo.memory(0xBBFF - 1, 0x00)
-    yield WriteTo.pc(0xBBFF - 2)
+    # Write the higher byte of the return address to stack
+    yield WriteTo.memory(0xBBFF - 1, current_addr >> 8)
+    yield WriteTo.register('SP', 0xBBFF - 2)
     yield Halt.cycle()
     # M6
-    # Write the lower byte of the current PC to stack
-    yield WriteTo.memory(0xBBFF - 2, current_addr)
+    # Write the lower byte of the return address to stack
+    yield WriteTo.memory(0xBBFF - 2, current_addr & 0xFF)
     # Actually jump to the addr.
     yield WriteTo.pc(addr)
     yield Halt.cycle()
@@ -193,6 +186,7 @@ def emit_call(token, tests, jp_params, param: Param) -> None:
     ]
 
     truthy_command_queue = [
+        *command_queue,
         *emit_jump_part_of_call(param.value)
     ]
 
@@ -229,7 +223,6 @@ def emit_ret(token, tests, jp_params, param: Param) -> None:
         falsey_command_queue = [
             # M1
             *emit_m1_cycle(token),
-            Halt.cycle(),
             # M2
             # Condition check happens here.
             Halt.cycle()
@@ -246,6 +239,8 @@ def emit_ret(token, tests, jp_params, param: Param) -> None:
         # M1
         *emit_m1_cycle(token),
         # M2
+        # Condition check, only RET cc spends a cycle on it.
+        *([] if jp_params['condition'] == 'BEEMU_JUMP_IF_NO_CONDITION' else [Halt.cycle()]),
         WriteTo.register('SP', 0xBC00),
         Halt.cycle(),
         # M3
@@ -2,6 +2,7 @@
 
 #include <BeemuTokenTest.hpp>
 #include <beemu/device/processor/tokenizer.h>
+#include "../../src/beemu/device/processor/tokenizer/tokenize_table.h"
 
 namespace BeemuTests
 {
@@ -15,6 +16,42 @@ namespace BeemuTests
 		beemu_tokenizer_free_token(inst);
 	}
 
+	TEST_P(BeemuTokenParameterizedTestFixture, InstructionTokenizedCorrectlyIntoCallerStorage)
+	{
+		auto params = GetParam();
+		// Fill with garbage first, the token must be entirely overwritten.
+		BeemuInstruction inst;
+		memset(&inst, 0xAB, sizeof(BeemuInstruction));
+		beemu_tokenizer_tokenize_into(&inst, params.first);
+		ASSERT_EQ(inst, params.second);
+	}
+
+	TEST_P(BeemuTokenParameterizedTestFixture, InstructionTokenizedCorrectlyWithoutTable)
+	{
+		auto params = GetParam();
+		BeemuInstruction inst{};
+		beemu_tokenizer_decode_without_table(&inst, params.first);
+		ASSERT_EQ(inst, params.second);
+	}
+
+	TEST(BeemuTokenizerTableTests, TableDecodesEveryOpcodeLikeTheClassifiers)
+	{
+		// Operand patterns chosen to exercise sign bits, byte order and zero.
+		const uint32_t operands[] = {0x0000, 0x00FF, 0xFF00, 0x1234, 0x8001, 0x7F80, 0xFFFF};
+		for (uint32_t opcode = 0; opcode < 256; opcode++) {
+			for (const uint32_t operand : operands) {
+				for (const uint32_t prefix : {opcode << 16, (0xCBu << 16) | (opcode << 8)}) {
+					const uint32_t machine_code = prefix | (prefix >> 16 == 0xCB ? operand & 0xFF : operand);
+					BeemuInstruction expected{};
+					beemu_tokenizer_decode_without_table(&expected, machine_code);
+					BeemuInstruction actual{};
+					beemu_tokenizer_table_decode(&actual, machine_code);
+					ASSERT_EQ(actual, expected) << "Machine code 0x" << std::hex << machine_code;
+				}
+			}
+		}
+	}
+
 	auto tests = BeemuTests::getTokensFromTestFile();
 
 	INSTANTIATE_TEST_SUITE_P(
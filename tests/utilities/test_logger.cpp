@@ -0,0 +1,25 @@
+#include <gtest/gtest.h>
+#include <beemu/internals/logger.h>
+
+namespace BeemuTests
+{
+	TEST(BeemuLoggerTest, RuntimeLevelFiltersLessSevereMessages)
+	{
+		const BeemuLogLevel previous = beemu_log_level;
+		beemu_log_set_level(BEEMU_LOG_ERR);
+		ASSERT_TRUE(BEEMU_LOG_IS_ENABLED(BEEMU_LOG_ERR));
+		ASSERT_FALSE(BEEMU_LOG_IS_ENABLED(BEEMU_LOG_WARN));
+		ASSERT_FALSE(BEEMU_LOG_IS_ENABLED(BEEMU_LOG_INFO));
+		beemu_log_set_level(previous);
+	}
+
+	TEST(BeemuLoggerTest, DisabledMessagesDoNotEvaluateArguments)
+	{
+		const BeemuLogLevel previous = beemu_log_level;
+		beemu_log_set_level(BEEMU_LOG_ERR);
+		int evaluations = 0;
+		BEEMU_LOG(BEEMU_LOG_INFO, "%i", ++evaluations);
+		ASSERT_EQ(evaluations, 0);
+		beemu_log_set_level(previous);
+	}
+}
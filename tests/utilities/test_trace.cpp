@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <beemu/device/device.h>
+#include <beemu/internals/trace.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace BeemuTests
+{
+	namespace
+	{
+		void collect_event(void *context, const BeemuTraceEvent *event)
+		{
+			static_cast<std::vector<BeemuTraceEvent> *>(context)->push_back(*event);
+		}
+
+		std::vector<BeemuTraceEvent> drain_all()
+		{
+			std::vector<BeemuTraceEvent> events;
+			beemu_trace_drain(collect_event, &events);
+			return events;
+		}
+
+		class BeemuTraceTest : public testing::Test
+		{
+		protected:
+			BeemuLogLevel previous_level;
+
+			void SetUp() override
+			{
+				previous_level = beemu_log_level;
+				beemu_log_set_level(BEEMU_LOG_INFO);
+				drain_all();
+			}
+
+			void TearDown() override
+			{
+				beemu_log_set_level(previous_level);
+			}
+		};
+	}
+
+	TEST_F(BeemuTraceTest, EventsAreFormattedWhenConsumed)
+	{
+		BEEMU_TRACE(BEEMU_LOG_WARN, "Read 0x%02X from 0x%04X, %i%% done", 0xAB, 0xC000, static_cast<uint64_t>(-5));
+		BEEMU_TRACE(BEEMU_LOG_WARN, "No arguments");
+		const std::vector<BeemuTraceEvent> events = drain_all();
+		ASSERT_EQ(events.size(), 2);
+		ASSERT_EQ(events[0].arg_count, 3);
+		char message[128];
+		beemu_trace_format_event(&events[0], message, sizeof(message));
+		ASSERT_STREQ(message, "WARN: Read 0xAB from 0xC000, -5% done");
+		beemu_trace_format_event(&events[1], message, sizeof(message));
+		ASSERT_STREQ(message, "WARN: No arguments");
+	}
+
+	TEST_F(BeemuTraceTest, DeviceTracesFiredEvents)
+	{
+		BeemuDevice *device = beemu_device_new();
+		drain_all();
+		beemu_device_run_cycles(device, BEEMU_DEVICE_CYCLES_PER_FRAME);
+		bool traced_frame_end = false;
+		char message[128];
+		const std::string expected = "INFO: Event " + std::to_string(BEEMU_EVENT_FRAME_END) + " due at " + std::to_string(BEEMU_DEVICE_CYCLES_PER_FRAME);
+		for (const BeemuTraceEvent &event : drain_all()) {
+			beemu_trace_format_event(&event, message, sizeof(message));
+			traced_frame_end = traced_frame_end || std::string(message).rfind(expected, 0) == 0;
+		}
+		EXPECT_TRUE(traced_frame_end);
+		beemu_device_free(device);
+	}
+
+	TEST_F(BeemuTraceTest, FormattingTruncatesToBuffer)
+	{
+		BEEMU_TRACE(BEEMU_LOG_ERR, "%u apples", 12345u);
+		const std::vector<BeemuTraceEvent> events = drain_all();
+		ASSERT_EQ(events.size(), 1);
+		char message[10];
+		const size_t length = beemu_trace_format_event(&events[0], message, sizeof(message));
+		ASSERT_EQ(length, std::string("ERROR: 12345 apples").size());
+		ASSERT_STREQ(message, "ERROR: 12");
+	}
+
+	TEST_F(BeemuTraceTest, DisabledLevelsAreNotRecorded)
+	{
+		beemu_log_set_level(BEEMU_LOG_ERR);
+		BEEMU_TRACE(BEEMU_LOG_INFO, "%i", 1);
+		ASSERT_TRUE(drain_all().empty());
+	}
+
+	TEST_F(BeemuTraceTest, FullRingDropsEvents)
+	{
+		const uint64_t dropped = beemu_trace_dropped_count();
+		for (int i = 0; i < BEEMU_TRACE_RING_CAPACITY + 10; i++) {
+			BEEMU_TRACE(BEEMU_LOG_INFO, "%i", static_cast<uint64_t>(i));
+		}
+		ASSERT_EQ(beemu_trace_dropped_count() - dropped, 10);
+		const std::vector<BeemuTraceEvent> events = drain_all();
+		ASSERT_EQ(events.size(), BEEMU_TRACE_RING_CAPACITY);
+		ASSERT_EQ(events.back().args[0], BEEMU_TRACE_RING_CAPACITY - 1);
+	}
+
+	TEST_F(BeemuTraceTest, EachThreadKeepsItsOrder)
+	{
+		constexpr int thread_count = 4;
+		constexpr int event_count = 1000;
+		std::vector<std::thread> threads;
+		for (int t = 0; t < thread_count; t++) {
+			threads.emplace_back([] {
+				for (int i = 0; i < event_count; i++) {
+					BEEMU_TRACE(BEEMU_LOG_INFO, "%i", static_cast<uint64_t>(i));
+				}
+			});
+		}
+		std::vector<BeemuTraceEvent> events;
+		while (!threads.empty()) {
+			beemu_trace_drain(collect_event, &events);
+			threads.back().join();
+			threads.pop_back();
+		}
+		beemu_trace_drain(collect_event, &events);
+		ASSERT_EQ(events.size(), thread_count * event_count);
+		std::map<uint32_t, uint64_t> next_by_thread;
+		for (const BeemuTraceEvent &event : events) {
+			ASSERT_EQ(event.args[0], next_by_thread[event.thread_id]++);
+		}
+	}
+
+	TEST_F(BeemuTraceTest, BinaryTraceDecodes)
+	{
+		FILE *trace = tmpfile();
+		FILE *decoded = tmpfile();
+		ASSERT_NE(trace, nullptr);
+		ASSERT_NE(decoded, nullptr);
+		BeemuTraceWriter *writer = beemu_trace_writer_new(trace);
+		ASSERT_NE(writer, nullptr);
+		for (int i = 0; i < 3; i++) {
+			BEEMU_TRACE(BEEMU_LOG_INFO, "Step %i of %i", static_cast<uint64_t>(i), 3);
+		}
+		ASSERT_EQ(beemu_trace_writer_flush(writer), 3);
+		ASSERT_TRUE(beemu_trace_writer_free(writer));
+		rewind(trace);
+		ASSERT_TRUE(beemu_trace_decode(trace, decoded));
+		rewind(decoded);
+		char line[128];
+		for (int i = 0; i < 3; i++) {
+			ASSERT_NE(fgets(line, sizeof(line), decoded), nullptr);
+			const std::string expected = "INFO: Step " + std::to_string(i) + " of 3\n";
+			ASSERT_TRUE(std::string(line).ends_with(expected)) << line;
+		}
+		ASSERT_EQ(fgets(line, sizeof(line), decoded), nullptr);
+		fclose(trace);
+		fclose(decoded);
+	}
+}